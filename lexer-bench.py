@@ -0,0 +1,38 @@
+#!/bin/python3
+
+import glob
+import os
+import subprocess
+import sys
+import tempfile
+
+# Measures lexer throughput (MB/s) on large generated inputs built
+# from the standard library and the test suite.
+# Usage: ./lexer-bench.py [path/to/earl]
+
+SIZES_MB = [1, 8, 32]
+
+def gather_source():
+    files = sorted(glob.glob('./src/std/*.earl') + glob.glob('./src/test/earl-tests/*.earl'))
+    src = ''
+    for f in files:
+        with open(f) as fd:
+            src += fd.read() + '\n'
+    return src
+
+def generate_input(src, size_mb, path):
+    target = size_mb * 1024 * 1024
+    with open(path, 'w') as fd:
+        written = 0
+        while written < target:
+            fd.write(src)
+            written += len(src)
+
+if __name__ == "__main__":
+    earl = sys.argv[1] if len(sys.argv) > 1 else './build/earl'
+    src = gather_source()
+    with tempfile.TemporaryDirectory() as tmp:
+        for size in SIZES_MB:
+            path = os.path.join(tmp, f'lexer-bench-{size}mb.earl')
+            generate_input(src, size, path)
+            subprocess.run([earl, '--bench-lexer', path], check=True)
@@ -22,22 +22,45 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <cassert>
+#include <new>
 #include <vector>
 
 #include "arena.hpp"
-#include "utils.hpp"
 
-[[deprecated]]
-Arena::Arena(size_t bytes) : m_mem(bytes), m_len(0), m_cap(bytes) {}
+Arena::Arena(size_t bytes)
+    : m_cur(nullptr), m_end(nullptr), m_chunk(bytes), m_len(0) {}
 
-[[deprecated]]
-uint8_t *arena_alloc(Arena &arena, size_t bytes) {
-    if (arena.m_len + bytes > arena.m_cap) {
-        arena.m_cap *= 2;
-        arena.m_mem.resize(arena.m_cap); // Resize the vector
+Arena::~Arena() {
+    for (uint8_t *chunk : m_chunks)
+        ::operator delete(chunk);
+}
+
+void *
+arena_alloc(Arena &arena, size_t bytes, size_t align) {
+    assert(align != 0 && (align & (align-1)) == 0 && align <= alignof(std::max_align_t));
+
+    uintptr_t cur = reinterpret_cast<uintptr_t>(arena.m_cur);
+    uintptr_t aligned = (cur + align-1) & ~(uintptr_t)(align-1);
+
+    if (!arena.m_cur || aligned + bytes > reinterpret_cast<uintptr_t>(arena.m_end)) {
+        // Start a new chunk instead of growing the old one so
+        // that everything handed out so far stays in place.
+        // Chunks from `operator new` are aligned for any type.
+        size_t size = arena.m_chunk;
+        if (size < bytes)
+            size = bytes;
+        else if (arena.m_chunk < Arena::ARENA_MAX_CHUNK)
+            arena.m_chunk *= 2;
+
+        uint8_t *chunk = static_cast<uint8_t *>(::operator new(size));
+        arena.m_chunks.push_back(chunk);
+        arena.m_cur = chunk;
+        arena.m_end = chunk + size;
+        aligned = reinterpret_cast<uintptr_t>(chunk);
     }
 
-    uint8_t *mem = &arena.m_mem[arena.m_len];
+    arena.m_cur = reinterpret_cast<uint8_t *>(aligned + bytes);
     arena.m_len += bytes;
-    return mem;
+    return reinterpret_cast<void *>(aligned);
 }
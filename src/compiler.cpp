@@ -0,0 +1,562 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cassert>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "vm.hpp"
+#include "intrinsics.hpp"
+#include "optimizer.hpp"
+#include "common.hpp"
+
+using namespace VM;
+
+namespace {
+
+    // Thrown when the compiler finds something that the VM does not
+    // support. The function is then left to the interpreter.
+    struct Unsupported {};
+
+    // A jump that needs its target filled in once it is known.
+    struct Patch {
+        size_t at;
+        int field;
+    };
+
+    struct Loop {
+        std::vector<Patch> breaks;
+        std::vector<Patch> continues;
+    };
+
+    struct Compiler {
+        Compiler(Chunk &chunk, earl::function::Obj *func, WorldCtx *world)
+            : m_chunk(chunk), m_func(func), m_world(world), m_top(0) {}
+
+        Chunk &m_chunk;
+        earl::function::Obj *m_func;
+        WorldCtx *m_world;
+        std::vector<std::unordered_map<std::string, int>> m_scopes;
+        std::vector<Loop> m_loops;
+        int m_top;
+
+        size_t
+        emit(Op op, int a = 0, int b = 0, int c = 0, int d = 0, void *p = nullptr) {
+            m_chunk.code.push_back(Instr{op, a, b, c, d, p});
+            return m_chunk.code.size()-1;
+        }
+
+        size_t
+        here(void) const {
+            return m_chunk.code.size();
+        }
+
+        void
+        patch(Patch p, size_t target) {
+            Instr &instr = m_chunk.code.at(p.at);
+            switch (p.field) {
+            case 0: instr.a = static_cast<int>(target); break;
+            case 1: instr.b = static_cast<int>(target); break;
+            case 2: instr.c = static_cast<int>(target); break;
+            case 3: instr.d = static_cast<int>(target); break;
+            default: assert(false && "unreachable");
+            }
+        }
+
+        int
+        alloc(int n = 1) {
+            int reg = m_top;
+            m_top += n;
+            if (static_cast<size_t>(m_top) > m_chunk.nregs)
+                m_chunk.nregs = m_top;
+            return reg;
+        }
+
+        int
+        lookup(const std::string &id) const {
+            for (auto it = m_scopes.rbegin(); it != m_scopes.rend(); ++it) {
+                auto var = it->find(id);
+                if (var != it->end())
+                    return var->second;
+            }
+            return -1;
+        }
+
+        int
+        add_const(std::shared_ptr<earl::value::Obj> value) {
+            m_chunk.consts.push_back(std::move(value));
+            return static_cast<int>(m_chunk.consts.size()-1);
+        }
+
+        int
+        add_name(const std::string &name) {
+            m_chunk.names.push_back(name);
+            return static_cast<int>(m_chunk.names.size()-1);
+        }
+
+        int
+        add_callee(const std::shared_ptr<earl::function::Obj> &func) {
+            m_chunk.callees.push_back(Callee{func->id(), func});
+            return static_cast<int>(m_chunk.callees.size()-1);
+        }
+
+        // Local variables in functions with attributes can
+        // collide with variables in the @world scope.
+        void
+        check_free(Token *tok) {
+            if (m_func->attrs() != 0)
+                emit(Op::CheckFree, 0, add_name(tok->lexeme()), 0, 0, tok);
+        }
+
+        // Literals have normally been folded by the optimizer already.
+        std::shared_ptr<earl::value::Obj>
+        literal(ExprTerm *expr) {
+            if (expr->get_term_type() == ExprTermType::None)
+                return std::make_shared<earl::value::Option>();
+            return Optimizer::fold_literal(expr);
+        }
+
+        // Constants that the optimizer folded to an int, float or bool.
+        static bool
+        is_scalar_const(Expr *expr) {
+            if (!expr->m_const)
+                return false;
+            switch (expr->m_const->type()) {
+            case earl::value::Type::Int:
+            case earl::value::Type::Float:
+            case earl::value::Type::Bool:
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        static bool
+        has_call(Expr *expr) {
+            switch (expr->get_type()) {
+            case ExprType::Term:
+                return dynamic_cast<ExprTerm *>(expr)->get_term_type() == ExprTermType::Func_Call;
+            case ExprType::Binary: {
+                auto bin = dynamic_cast<ExprBinary *>(expr);
+                return has_call(bin->m_lhs.get()) || has_call(bin->m_rhs.get());
+            }
+            case ExprType::Unary:
+                return has_call(dynamic_cast<ExprUnary *>(expr)->m_expr.get());
+            default:
+                return true;
+            }
+        }
+
+        // Gets a register holding the value of `expr` for use as an
+        // operand that is never stored. Local variables are used in
+        // place, `copy` is set if the interpreter would have copied it.
+        int
+        operand(Expr *expr, bool eval_ref, bool unpack_ref, bool &copy) {
+            copy = false;
+            if (expr->get_type() == ExprType::Term
+                && dynamic_cast<ExprTerm *>(expr)->get_term_type() == ExprTermType::Ident) {
+                const std::string &id = dynamic_cast<ExprIdent *>(expr)->m_tok->lexeme();
+                int reg = lookup(id);
+                if (reg == -1 || id == "_")
+                    throw Unsupported();
+                copy = !unpack_ref;
+                return reg;
+            }
+            int reg = alloc();
+            if (is_scalar_const(expr))
+                emit(Op::LoadKRef, reg, add_const(expr->m_const));
+            else
+                this->expr(expr, eval_ref, unpack_ref, reg);
+            return reg;
+        }
+
+        void
+        call(ExprFuncCall *expr, bool unpack_ref, int dst) {
+            if (expr->m_left->get_type() != ExprType::Term
+                || dynamic_cast<ExprTerm *>(expr->m_left.get())->get_term_type() != ExprTermType::Ident)
+                throw Unsupported();
+
+            const std::string &id = dynamic_cast<ExprIdent *>(expr->m_left.get())->m_tok->lexeme();
+            const int n = static_cast<int>(expr->m_params.size());
+            const int mark = m_top;
+
+            if (Intrinsics::is_intrinsic(id)) {
+                int base = alloc(n);
+                for (int i = 0; i < n; ++i)
+                    this->expr(expr->m_params[i].get(), unpack_ref, unpack_ref, base+i);
+                emit(Op::CallIntrinsic, dst, base, n, add_name(id), static_cast<Expr *>(expr));
+                m_top = mark;
+                return;
+            }
+
+            if (m_world->class_is_defined(id) || !m_world->function_exists(id))
+                throw Unsupported();
+
+            std::shared_ptr<earl::function::Obj> callee = m_world->function_get(id);
+            if (callee->params_len() != static_cast<size_t>(n))
+                throw Unsupported();
+
+            // The interpreter evaluates the arguments of user defined
+            // functions once before resolving the function and again
+            // when loading the parameters. Only observable with calls.
+            bool twice = false;
+            for (auto &param : expr->m_params)
+                twice = twice || has_call(param.get());
+            if (twice) {
+                int tmp = alloc();
+                for (auto &param : expr->m_params)
+                    this->expr(param.get(), unpack_ref, unpack_ref, tmp);
+                m_top = mark;
+            }
+
+            int base = alloc(n);
+            for (int i = 0; i < n; ++i) {
+                bool ref = callee->param_at_is_ref(i);
+                this->expr(expr->m_params[i].get(), ref, ref, base+i);
+            }
+            emit(Op::Call, dst, base, n, add_callee(callee), static_cast<Expr *>(expr));
+            m_top = mark;
+        }
+
+        void
+        binary(ExprBinary *expr, bool eval_ref, bool unpack_ref, int dst) {
+            const int mark = m_top;
+            TokenType op = expr->m_op->type();
+            Expr *lhs = expr->m_lhs.get();
+
+            if (op == TokenType::Double_Ampersand || op == TokenType::Double_Pipe) {
+                // The interpreter unpacks the lhs a second time when
+                // short-circuiting, which calls functions twice.
+                if (lhs->get_type() == ExprType::Term
+                    && dynamic_cast<ExprTerm *>(lhs)->get_term_type() == ExprTermType::Func_Call)
+                    throw Unsupported();
+
+                int tmp = alloc();
+                this->expr(lhs, eval_ref, true, tmp);
+                size_t jshort = emit(op == TokenType::Double_Ampersand ? Op::JmpFalse : Op::JmpTrue, tmp);
+                this->expr(expr->m_rhs.get(), eval_ref, eval_ref, dst);
+                size_t jend = emit(Op::Jmp);
+                patch(Patch{jshort, 1}, here());
+                bool is_ident = lhs->get_type() == ExprType::Term
+                    && dynamic_cast<ExprTerm *>(lhs)->get_term_type() == ExprTermType::Ident;
+                emit(is_ident && !unpack_ref ? Op::Copy : Op::Move, dst, tmp);
+                patch(Patch{jend, 0}, here());
+                m_top = mark;
+                return;
+            }
+
+            bool unused, copy;
+            int l = operand(lhs, eval_ref, true, unused);
+            int r = operand(expr->m_rhs.get(), eval_ref, eval_ref, copy);
+            emit(Op::BinOp, dst, l, r, copy, expr->m_op);
+            m_top = mark;
+        }
+
+        void
+        expr(Expr *expr, bool eval_ref, bool unpack_ref, int dst) {
+            // List and tuple literals are left to the interpreter.
+            if (expr->m_const
+                && expr->m_const->type() != earl::value::Type::List
+                && expr->m_const->type() != earl::value::Type::Tuple) {
+                emit(Op::LoadK, dst, add_const(expr->m_const));
+                return;
+            }
+
+            switch (expr->get_type()) {
+            case ExprType::Term: {
+                auto term = dynamic_cast<ExprTerm *>(expr);
+                switch (term->get_term_type()) {
+                case ExprTermType::Ident: {
+                    const std::string &id = dynamic_cast<ExprIdent *>(term)->m_tok->lexeme();
+                    int reg = lookup(id);
+                    if (reg == -1 || id == "_")
+                        throw Unsupported();
+                    emit(unpack_ref ? Op::Move : Op::Copy, dst, reg);
+                } break;
+                case ExprTermType::Func_Call: {
+                    call(dynamic_cast<ExprFuncCall *>(term), unpack_ref, dst);
+                } break;
+                default: {
+                    auto value = literal(term);
+                    if (!value)
+                        throw Unsupported();
+                    emit(Op::LoadK, dst, add_const(value));
+                } break;
+                }
+            } break;
+            case ExprType::Binary: {
+                binary(dynamic_cast<ExprBinary *>(expr), eval_ref, unpack_ref, dst);
+            } break;
+            case ExprType::Unary: {
+                auto unary = dynamic_cast<ExprUnary *>(expr);
+                const int mark = m_top;
+                bool copy;
+                int reg = operand(unary->m_expr.get(), eval_ref, eval_ref, copy);
+                emit(Op::UnaryOp, dst, reg, 0, copy, unary->m_op);
+                m_top = mark;
+            } break;
+            default:
+                throw Unsupported();
+            }
+        }
+
+        // Evaluates a condition the way `if` and `while` do.
+        int
+        cond(Expr *expr, int dst = -1) {
+            bool unused;
+            if (dst == -1)
+                return operand(expr, false, true, unused);
+            this->expr(expr, false, true, dst);
+            return dst;
+        }
+
+        void
+        jump_out(std::vector<Patch> Loop::*which) {
+            if (m_loops.empty())
+                throw Unsupported();
+            size_t j = emit(Op::Jmp);
+            (m_loops.back().*which).push_back(Patch{j, 0});
+        }
+
+        void
+        close_loop(size_t brk, size_t cont) {
+            for (auto &p : m_loops.back().breaks)
+                patch(p, brk);
+            for (auto &p : m_loops.back().continues)
+                patch(p, cont);
+            m_loops.pop_back();
+        }
+
+        void
+        stmt_let(StmtLet *stmt) {
+            const uint32_t allowed = static_cast<uint32_t>(Attr::Ref) | static_cast<uint32_t>(Attr::Const);
+            if (stmt->m_ids.size() != 1 || (stmt->m_attrs & ~allowed) != 0)
+                throw Unsupported();
+
+            bool ref = (stmt->m_attrs & static_cast<uint32_t>(Attr::Ref)) != 0;
+            bool _const = (stmt->m_attrs & static_cast<uint32_t>(Attr::Const)) != 0;
+            Token *tok = stmt->m_ids[0];
+            const std::string &id = tok->lexeme();
+
+            if (lookup(id) != -1)
+                throw Unsupported();
+
+            if (id == "_") {
+                int tmp = alloc();
+                expr(stmt->m_expr.get(), ref, ref, tmp);
+                m_top = tmp;
+                return;
+            }
+
+            check_free(tok);
+            int reg = alloc();
+            expr(stmt->m_expr.get(), ref, ref, reg);
+            emit(Op::SetConst, reg, 0, _const);
+            m_scopes.back()[id] = reg;
+        }
+
+        void
+        stmt_mut(StmtMut *stmt) {
+            Expr *left = stmt->m_left.get();
+            if (left->get_type() != ExprType::Term
+                || dynamic_cast<ExprTerm *>(left)->get_term_type() != ExprTermType::Ident)
+                throw Unsupported();
+            int var = lookup(dynamic_cast<ExprIdent *>(left)->m_tok->lexeme());
+            if (var == -1)
+                throw Unsupported();
+
+            Op op;
+            switch (stmt->m_equals->type()) {
+            case TokenType::Equals: op = Op::Mutate; break;
+            case TokenType::Plus_Equals:
+            case TokenType::Minus_Equals:
+            case TokenType::Asterisk_Equals:
+            case TokenType::Forwardslash_Equals:
+            case TokenType::Percent_Equals:
+            case TokenType::Backtick_Pipe_Equals:
+            case TokenType::Backtick_Ampersand_Equals:
+            case TokenType::Backtick_Caret_Equals: op = Op::SpecMutate; break;
+            default: throw Unsupported();
+            }
+
+            int tmp = alloc();
+            expr(stmt->m_right.get(), false, false, tmp);
+            emit(op, var, tmp, 0, 0, stmt);
+            m_top = tmp;
+        }
+
+        void
+        stmt_expr(StmtExpr *stmt) {
+            int tmp = alloc();
+            expr(stmt->m_expr.get(), false, false, tmp);
+            size_t at = emit(Op::ExprStmt, tmp, -1, -1, 0, stmt->m_expr.get());
+            if (!m_loops.empty()) {
+                m_loops.back().breaks.push_back(Patch{at, 1});
+                m_loops.back().continues.push_back(Patch{at, 2});
+            }
+            m_top = tmp;
+        }
+
+        void
+        stmt_if(StmtIf *stmt) {
+            const int mark = m_top;
+            int reg = cond(stmt->m_expr.get());
+            size_t jelse = emit(Op::JmpFalse, reg);
+            m_top = mark;
+            block(stmt->m_block.get());
+            if (stmt->m_else.has_value()) {
+                size_t jend = emit(Op::Jmp);
+                patch(Patch{jelse, 1}, here());
+                block(stmt->m_else.value().get());
+                patch(Patch{jend, 0}, here());
+            }
+            else
+                patch(Patch{jelse, 1}, here());
+        }
+
+        void
+        stmt_return(StmtReturn *stmt) {
+            if (!stmt->m_expr.has_value()) {
+                emit(Op::RetVoid);
+                return;
+            }
+            int tmp = alloc();
+            expr(stmt->m_expr.value().get(), false, false, tmp);
+            emit(Op::Ret, tmp);
+            m_top = tmp;
+        }
+
+        // NOTE: `continue` in the interpreter does not evaluate the
+        // condition again, it reuses the last result.
+        void
+        stmt_while(StmtWhile *stmt) {
+            int reg = alloc();
+            cond(stmt->m_expr.get(), reg);
+            size_t head = here();
+            size_t jexit = emit(Op::JmpFalse, reg);
+            m_loops.emplace_back();
+            block(stmt->m_block.get());
+            cond(stmt->m_expr.get(), reg);
+            emit(Op::Jmp, static_cast<int>(head));
+            patch(Patch{jexit, 1}, here());
+            close_loop(here(), head);
+            m_top = reg;
+        }
+
+        void
+        stmt_loop(StmtLoop *stmt) {
+            size_t head = here();
+            m_loops.emplace_back();
+            block(stmt->m_block.get());
+            emit(Op::Jmp, static_cast<int>(head));
+            close_loop(here(), head);
+        }
+
+        void
+        stmt_for(StmtFor *stmt) {
+            Token *tok = stmt->m_enumerator;
+            int e = alloc(), n = alloc(), d = alloc();
+            expr(stmt->m_start.get(), false, false, e);
+            expr(stmt->m_end.get(), false, true, n);
+
+            if (lookup(tok->lexeme()) != -1)
+                throw Unsupported();
+            check_free(tok);
+
+            emit(Op::ForPrep, e, n, d, 0, tok);
+            size_t head = emit(Op::ForTest, e, n, d);
+            m_scopes.emplace_back();
+            m_scopes.back()[tok->lexeme()] = e;
+            m_loops.emplace_back();
+            block(stmt->m_block.get());
+            size_t step = emit(Op::ForStep, e, 0, d);
+            emit(Op::Jmp, static_cast<int>(head));
+            patch(Patch{head, 3}, here());
+            close_loop(here(), step);
+            m_scopes.pop_back();
+            m_top = e;
+        }
+
+        void
+        stmt(Stmt *stmt) {
+            switch (stmt->stmt_type()) {
+            case StmtType::Let:       stmt_let(dynamic_cast<StmtLet *>(stmt)); break;
+            case StmtType::Mut:       stmt_mut(dynamic_cast<StmtMut *>(stmt)); break;
+            case StmtType::Stmt_Expr: stmt_expr(dynamic_cast<StmtExpr *>(stmt)); break;
+            case StmtType::Block:     block(dynamic_cast<StmtBlock *>(stmt)); break;
+            case StmtType::If:        stmt_if(dynamic_cast<StmtIf *>(stmt)); break;
+            case StmtType::Return:    stmt_return(dynamic_cast<StmtReturn *>(stmt)); break;
+            case StmtType::Break:     jump_out(&Loop::breaks); break;
+            case StmtType::Continue:  jump_out(&Loop::continues); break;
+            case StmtType::While:     stmt_while(dynamic_cast<StmtWhile *>(stmt)); break;
+            case StmtType::Loop:      stmt_loop(dynamic_cast<StmtLoop *>(stmt)); break;
+            case StmtType::For:       stmt_for(dynamic_cast<StmtFor *>(stmt)); break;
+            default: throw Unsupported();
+            }
+        }
+
+        void
+        block(StmtBlock *block) {
+            const int mark = m_top;
+            m_scopes.emplace_back();
+            for (auto &s : block->m_stmts)
+                stmt(s.get());
+            m_scopes.pop_back();
+            m_top = mark;
+        }
+
+        void
+        function(void) {
+            auto &params = m_func->params();
+            m_scopes.emplace_back();
+            for (auto &param : params) {
+                const std::string &id = param.first->lexeme();
+                if (m_scopes.back().count(id))
+                    throw Unsupported();
+                m_scopes.back()[id] = alloc();
+            }
+            block(m_func->block());
+            emit(Op::End);
+            m_scopes.pop_back();
+        }
+    };
+};
+
+std::shared_ptr<Chunk>
+VM::compile(earl::function::Obj *func, WorldCtx *world) {
+    auto chunk = std::make_shared<Chunk>();
+    chunk->nregs = 0;
+    chunk->world = world;
+
+    Compiler compiler(*chunk, func, world);
+    try {
+        compiler.function();
+    } catch (const Unsupported &) {
+        return nullptr;
+    }
+
+    return chunk;
+}
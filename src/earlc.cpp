@@ -0,0 +1,248 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+#include <unistd.h>
+
+#include "earlc.hpp"
+#include "token.hpp"
+#include "common.hpp"
+#include "config.h"
+
+#define EARLC_MAGIC "EARLC\x01"
+
+// Bump whenever the same source would give a different token
+// stream: the on-disk layout, the token types or the lexer's output.
+// It is part of every key, so entries from older builds are ignored.
+#define EARLC_FORMAT "3"
+
+// Entries are never invalidated in place (an edited file just gets a
+// new key), so the directory is trimmed back to this many entries,
+// least recently used first, whenever a new one is written.
+#define EARLC_MAX_ENTRIES 256
+
+static uint64_t
+fnv1a(const char *data, size_t len, uint64_t h = 0xcbf29ce484222325ull) {
+    for (size_t i = 0; i < len; ++i) {
+        h ^= static_cast<unsigned char>(data[i]);
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
+
+static uint64_t
+cache_key(const std::string &src_code, const std::vector<std::string> &keywords) {
+    uint64_t h = fnv1a(VERSION, sizeof(VERSION)-1);
+    h = fnv1a(EARLC_FORMAT, sizeof(EARLC_FORMAT), h);
+    for (const auto &kw : keywords)
+        h = fnv1a(kw.c_str(), kw.size()+1, h);
+    return fnv1a(src_code.data(), src_code.size(), h);
+}
+
+static std::string
+cache_dir(void) {
+    if (const char *xdg = std::getenv("XDG_CACHE_HOME"); xdg && *xdg)
+        return std::string(xdg) + "/earl";
+    if (const char *home = std::getenv("HOME"); home && *home)
+        return std::string(home) + "/.cache/earl";
+    return "";
+}
+
+static std::string
+cache_path(uint64_t key) {
+    std::string dir = cache_dir();
+    if (dir.empty())
+        return "";
+    char name[32];
+    snprintf(name, sizeof(name), "/%016llx.earlc", static_cast<unsigned long long>(key));
+    return dir + name;
+}
+
+static void
+put_u32(std::string &buf, uint32_t v) {
+    for (int i = 0; i < 4; ++i)
+        buf.push_back(static_cast<char>((v >> (i*8)) & 0xFF));
+}
+
+static void
+put_u64(std::string &buf, uint64_t v) {
+    put_u32(buf, static_cast<uint32_t>(v));
+    put_u32(buf, static_cast<uint32_t>(v >> 32));
+}
+
+struct Reader {
+    const std::string &buf;
+    size_t pos = 0;
+    bool ok = true;
+
+    uint32_t u32(void) {
+        if (pos+4 > buf.size()) {
+            ok = false;
+            return 0;
+        }
+        uint32_t v = 0;
+        for (int i = 0; i < 4; ++i)
+            v |= static_cast<uint32_t>(static_cast<unsigned char>(buf[pos++])) << (i*8);
+        return v;
+    }
+
+    uint64_t u64(void) {
+        uint64_t lo = u32();
+        return lo | (static_cast<uint64_t>(u32()) << 32);
+    }
+};
+
+static bool
+slurp(const std::string &path, std::string &out) {
+    FILE *f = fopen(path.c_str(), "rb");
+    if (!f)
+        return false;
+    char chunk[8192];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0)
+        out.append(chunk, n);
+    bool ok = !ferror(f);
+    fclose(f);
+    return ok;
+}
+
+// Layout: magic, key, source length, token count, then for every
+// token its type, row, col, lexeme length and lexeme bytes. The
+// filepath is not stored since it is supplied again on load.
+static std::unique_ptr<Lexer>
+load(const std::string &buf, uint64_t key, const std::string &src_code, const std::string &fp) {
+    if (buf.compare(0, sizeof(EARLC_MAGIC)-1, EARLC_MAGIC) != 0)
+        return nullptr;
+
+    Reader r {buf, sizeof(EARLC_MAGIC)-1};
+    if (r.u64() != key || r.u64() != src_code.size())
+        return nullptr;
+
+    auto lexer = std::make_unique<Lexer>();
+    uint32_t file = filetable_intern(fp);
+    uint32_t count = r.u32();
+    lexer->m_toks.reserve(count);
+    for (uint32_t i = 0; i < count && r.ok; ++i) {
+        uint32_t type = r.u32(), row = r.u32(), col = r.u32(), len = r.u32();
+        if (!r.ok || type >= static_cast<uint32_t>(TokenType::Total_Len) || r.pos+len > buf.size())
+            return nullptr;
+        lexer->append(buf.substr(r.pos, len), static_cast<TokenType>(type), row, col, file);
+        r.pos += len;
+    }
+
+    if (!r.ok || r.pos != buf.size())
+        return nullptr;
+    return lexer;
+}
+
+static void
+store(const std::string &path, uint64_t key, const std::string &src_code, Lexer &lexer) {
+    std::string buf = EARLC_MAGIC;
+    put_u64(buf, key);
+    put_u64(buf, src_code.size());
+    put_u32(buf, static_cast<uint32_t>(lexer.m_toks.size()));
+    for (const Token &tok : lexer.m_toks) {
+        put_u32(buf, static_cast<uint32_t>(tok.type()));
+        put_u32(buf, static_cast<uint32_t>(tok.m_row));
+        put_u32(buf, static_cast<uint32_t>(tok.m_col));
+        put_u32(buf, static_cast<uint32_t>(tok.m_lexeme.size()));
+        buf += tok.m_lexeme;
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path(), ec);
+    if (ec)
+        return;
+
+    // Write to a private file first so concurrent runs never
+    // observe a partially written entry.
+    std::string tmp = path + "." + std::to_string(getpid()) + ".tmp";
+    FILE *f = fopen(tmp.c_str(), "wb");
+    if (!f)
+        return;
+    bool ok = fwrite(buf.data(), 1, buf.size(), f) == buf.size();
+    ok = fclose(f) == 0 && ok;
+    if (!ok || std::rename(tmp.c_str(), path.c_str()) != 0)
+        std::remove(tmp.c_str());
+}
+
+static void
+prune(const std::string &dir) {
+    namespace fs = std::filesystem;
+    std::vector<std::pair<fs::file_time_type, fs::path>> entries;
+    std::error_code ec;
+    for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec))
+        if (it->path().extension() == ".earlc")
+            entries.emplace_back(it->last_write_time(ec), it->path());
+
+    if (entries.size() <= EARLC_MAX_ENTRIES)
+        return;
+    std::sort(entries.begin(), entries.end());
+    for (size_t i = 0; i < entries.size()-EARLC_MAX_ENTRIES; ++i)
+        fs::remove(entries[i].second, ec);
+}
+
+std::unique_ptr<Lexer>
+earlc::lex(std::string &src_code,
+           std::string fp,
+           std::vector<std::string> &keywords,
+           std::vector<std::string> &types,
+           std::string &comment) {
+    if ((flags & __CACHE) == 0)
+        return lex_file(src_code, fp, keywords, types, comment);
+
+    uint64_t key = cache_key(src_code, keywords);
+    std::string path = cache_path(key);
+    if (path.empty())
+        return lex_file(src_code, fp, keywords, types, comment);
+
+    // An entry that exists but does not load (truncated, corrupt or
+    // from a colliding key) is stale and gets overwritten.
+    std::string buf;
+    bool found = slurp(path, buf);
+    if (found) {
+        if (auto lexer = load(buf, key, src_code, fp)) {
+            // Hits refresh the mtime that `prune` orders by.
+            std::error_code ec;
+            std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+            if ((flags & __SHOWCACHE) != 0)
+                std::cout << "[EARL show-cache] hit " << fp << '\n';
+            return lexer;
+        }
+    }
+    if ((flags & __SHOWCACHE) != 0)
+        std::cout << "[EARL show-cache] " << (found ? "stale " : "miss ") << fp << '\n';
+
+    auto lexer = lex_file(src_code, fp, keywords, types, comment);
+    store(path, key, src_code, *lexer.get());
+    prune(cache_dir());
+    return lexer;
+}
@@ -33,13 +33,13 @@ void
 Err::err_wtok(Token *tok) {
     if (!tok)
         return;
-    std::cerr << tok->m_fp << ':' << tok->m_row << ':' << tok->m_col << ":\n";
+    std::cerr << tok->fp() << ':' << tok->m_row << ':' << tok->m_col << ":\n";
     Token *it = tok;
     while (it && it->type() != TokenType::Semicolon) {
         std::cerr << it->lexeme();
-        if (it->m_next && it->m_next->type() != TokenType::Semicolon)
+        if (it->next() && it->next()->type() != TokenType::Semicolon)
             std::cerr << ' ';
-        it = it->m_next.get();
+        it = it->next();
     }
     if (it && it->type() == TokenType::Semicolon)
         std::cerr << ';';
@@ -54,15 +54,15 @@ static void err_wident(ExprIdent *expr, int s);
 
 void
 Err::err_w2tok(Token *tok1, Token *tok2) {
-    std::cerr << tok1->m_fp << ':' << tok1->m_row << ':' << tok1->m_col << ":\n";
-    std::cerr << tok2->m_fp << ':' << tok2->m_row << ':' << tok2->m_col << ":\n";
+    std::cerr << tok1->fp() << ':' << tok1->m_row << ':' << tok1->m_col << ":\n";
+    std::cerr << tok2->fp() << ':' << tok2->m_row << ':' << tok2->m_col << ":\n";
 }
 
 void
 Err::err_wconflict(Token *newtok, Token *orig) {
     err_wtok(newtok);
     if ((flags & __WATCH) == 0)
-        std::cerr << orig->m_fp << ':' << orig->m_row << ':' << orig->m_col << ": <---- conflict\n";
+        std::cerr << orig->fp() << ':' << orig->m_row << ':' << orig->m_col << ": <---- conflict\n";
 }
 
 void
@@ -74,87 +74,87 @@ Err::warn(std::string msg, Token *tok) {
 
 static void
 err_wfloatlit(ExprFloatLit *expr, int s) {
-    Err::err_wtok(expr->m_tok.get());
+    Err::err_wtok(expr->m_tok);
 }
 
 static void
 err_wtuple(ExprTuple *expr, int s) {
-    Err::err_wtok(expr->m_tok.get());
+    Err::err_wtok(expr->m_tok);
 }
 
 static void
 err_wclosure(ExprClosure *expr, int s) {
-    Err::err_wtok(expr->m_tok.get());
+    Err::err_wtok(expr->m_tok);
 }
 
 static void
 err_wnone(ExprNone *expr, int s) {
-    Err::err_wtok(expr->m_tok.get());
+    Err::err_wtok(expr->m_tok);
 }
 
 static void
 err_wbool(ExprBool *expr, int s) {
-    Err::err_wtok(expr->m_tok.get());
+    Err::err_wtok(expr->m_tok);
 }
 
 static void
 err_warray_access(ExprArrayAccess *expr, int s) {
-    Err::err_wtok(expr->m_tok.get());
+    Err::err_wtok(expr->m_tok);
 }
 
 static void
 err_wmod_access(ExprModAccess *expr, int s) {
-    Err::err_wtok(expr->m_tok.get());
+    Err::err_wtok(expr->m_tok);
 }
 
 static void
 err_wget(ExprGet *expr, int s) {
-    Err::err_wtok(expr->m_tok.get());
+    Err::err_wtok(expr->m_tok);
 }
 
 static void
 err_wslice(ExprSlice *expr, int s) {
-    Err::err_wtok(expr->m_tok.get());
+    Err::err_wtok(expr->m_tok);
 }
 
 static void
 err_wrange(ExprRange *expr, int s) {
-    Err::err_wtok(expr->m_tok.get());
+    Err::err_wtok(expr->m_tok);
 }
 
 static void
 err_wlistlit(ExprListLit *expr, int s) {
-    Err::err_wtok(expr->m_tok.get());
+    Err::err_wtok(expr->m_tok);
 }
 
 static void
 err_wfunccall(ExprFuncCall *expr, int s) {
-    Err::err_wtok(expr->m_tok.get());
+    Err::err_wtok(expr->m_tok);
 }
 
 static void
 err_wcharlit(ExprCharLit *expr, int s) {
-    Err::err_wtok(expr->m_tok.get());
+    Err::err_wtok(expr->m_tok);
 }
 
 static void
 err_wstrlit(ExprStrLit *expr, int s) {
-    Err::err_wtok(expr->m_tok.get());
+    Err::err_wtok(expr->m_tok);
 }
 
 static void
 err_wintlit(ExprIntLit *expr, int s) {
-    Err::err_wtok(expr->m_tok.get());
+    Err::err_wtok(expr->m_tok);
 }
 
 static void
 err_wident(ExprIdent *expr, int s) {
-    Err::err_wtok(expr->m_tok.get());
+    Err::err_wtok(expr->m_tok);
 }
 
 static void
 err_wfstr(ExprFStr *expr, int s) {
-    Err::err_wtok(expr->m_tok.get());
+    Err::err_wtok(expr->m_tok);
 }
 
 static void
@@ -257,7 +257,7 @@ err_wblockstmt(StmtBlock *stmt) {
 void
 err_wmutstmt(StmtMut *stmt) {
     Err::err_wexpr(stmt->m_left.get());
-    Err::err_wtok(stmt->m_equals.get());
+    Err::err_wtok(stmt->m_equals);
     Err::err_wexpr(stmt->m_right.get());
 }
 
@@ -273,7 +273,7 @@ err_wstmtif(StmtIf *stmt) {
 
 void
 err_wstmtreturn(StmtReturn *stmt) {
-    Err::err_wtok(stmt->m_tok.get());
+    Err::err_wtok(stmt->m_tok);
 }
 
 void
@@ -29,8 +29,18 @@
 #include "utils.hpp"
 #include "err.hpp"
 
-FunctionCtx::FunctionCtx(std::shared_ptr<Ctx> owner, uint32_t attrs)
-    : m_immediate_owner(owner), m_attrs(attrs) {
+// Finished call frames that are ready to be handed out again.
+static std::vector<std::shared_ptr<FunctionCtx>> frame_pool = {};
+static constexpr size_t FRAME_POOL_CAP = 256;
+
+FunctionCtx::FunctionCtx(std::shared_ptr<Ctx> owner, uint32_t attrs) {
+    set_owner(std::move(owner), attrs);
+}
+
+void
+FunctionCtx::set_owner(std::shared_ptr<Ctx> owner, uint32_t attrs) {
+    m_attrs = attrs;
+    m_immediate_owner = owner;
     std::shared_ptr<Ctx> it = owner;
     while (1) {
         switch (it->type()) {
@@ -45,6 +55,35 @@ FunctionCtx::FunctionCtx(std::shared_ptr<Ctx> owner, uint32_t attrs)
     }
 }
 
+std::shared_ptr<FunctionCtx>
+FunctionCtx::acquire(std::shared_ptr<Ctx> owner, uint32_t attrs) {
+    if (frame_pool.empty())
+        return std::make_shared<FunctionCtx>(std::move(owner), attrs);
+    auto ctx = std::move(frame_pool.back());
+    frame_pool.pop_back();
+    ctx->set_owner(std::move(owner), attrs);
+    return ctx;
+}
+
+void
+FunctionCtx::release(std::shared_ptr<FunctionCtx> &ctx) {
+    if (ctx.use_count() != 1 || frame_pool.size() >= FRAME_POOL_CAP) {
+        ctx = nullptr;
+        return;
+    }
+
+    // Drop everything the call owned now, as a fresh context would,
+    // but keep the storage behind the scopes and slots.
+    ctx->m_scope.reset();
+    ctx->m_funcs.reset();
+    ctx->m_owner = nullptr;
+    ctx->m_immediate_owner = nullptr;
+    ctx->m_in_rec = false;
+    ctx->m_frame = nullptr;
+    ctx->m_slots.clear();
+    frame_pool.push_back(std::move(ctx));
+}
+
 void
 FunctionCtx::setrec(void) {
     m_in_rec = true;
@@ -120,6 +159,27 @@ FunctionCtx::function_add(std::shared_ptr<earl::function::Obj> func) {
     m_funcs.add(id, func);
 }
 
+void
+FunctionCtx::set_frame(StmtDef *def) {
+    if (m_frame == def || def->m_nslots < 0)
+        return;
+    m_frame = def;
+    m_slots.assign(def->m_nslots, std::weak_ptr<earl::variable::Obj>());
+}
+
+void
+FunctionCtx::slot_set(const Slot &slot, const std::shared_ptr<earl::variable::Obj> &var) {
+    if (slot.m_frame && slot.m_frame == m_frame)
+        m_slots[slot.m_index] = var;
+}
+
+std::shared_ptr<earl::variable::Obj>
+FunctionCtx::slot_get(const Slot &slot) {
+    if (!slot.m_frame || slot.m_frame != m_frame)
+        return nullptr;
+    return m_slots[slot.m_index].lock();
+}
+
 void
 FunctionCtx::set_curfunc(const std::string &id) {
     m_curfunc_id = id;
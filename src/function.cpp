@@ -30,11 +30,12 @@
 #include "common.hpp"
 #include "utils.hpp"
 #include "ctx.hpp"
+#include "vm.hpp"
 
 using namespace earl::function;
 
 Obj::Obj(StmtDef *stmtdef, std::vector<std::pair<Token *, uint32_t>> params, Token *tok)
-    : m_stmtdef(stmtdef), m_params(std::move(params)), m_tok(tok) {}
+    : m_stmtdef(stmtdef), m_params(std::move(params)), m_tok(tok), m_chunk(nullptr), m_compiled(false) {}
 
 Token *
 Obj::gettok(void) {
@@ -59,6 +60,7 @@ Obj::block(void) const {
 void
 Obj::load_parameters(std::vector<std::shared_ptr<earl::value::Obj>> &values,
                      std::shared_ptr<FunctionCtx> &new_ctx) {
+    new_ctx->set_frame(m_stmtdef);
     for (size_t i = 0; i < values.size(); ++i) {
         auto value = values[i];
         Token *id = m_params.at(i).first;
@@ -70,6 +72,7 @@ Obj::load_parameters(std::vector<std::shared_ptr<earl::value::Obj>> &values,
         if ((m_params.at(i).second & static_cast<uint32_t>(Attr::Const)) != 0)
             var->value()->set_const();
         new_ctx->variable_add(var);
+        new_ctx->slot_set(Slot{m_stmtdef, static_cast<int>(i)}, var);
     }
 }
 
@@ -99,3 +102,17 @@ uint32_t
 Obj::attrs(void) const {
     return m_stmtdef->m_attrs;
 }
+
+const std::vector<std::pair<Token *, uint32_t>> &
+Obj::params(void) const {
+    return m_params;
+}
+
+VM::Chunk *
+Obj::chunk(WorldCtx *world) {
+    if (!m_compiled) {
+        m_chunk = VM::compile(this, world);
+        m_compiled = true;
+    }
+    return m_chunk.get();
+}
@@ -27,7 +27,7 @@
 
 #include "ast.hpp"
 
-ExprArrayAccess::ExprArrayAccess(std::unique_ptr<Expr> left, std::unique_ptr<Expr> expr, std::shared_ptr<Token> tok)
+ExprArrayAccess::ExprArrayAccess(std::unique_ptr<Expr> left, std::unique_ptr<Expr> expr, Token *tok)
     : m_left(std::move(left)), m_expr(std::move(expr)), m_tok(tok) {}
 
 ExprType
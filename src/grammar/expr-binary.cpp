@@ -27,7 +27,7 @@
 
 #include "ast.hpp"
 
-ExprBinary::ExprBinary(std::unique_ptr<Expr> lhs, std::shared_ptr<Token> op, std::unique_ptr<Expr> rhs)
+ExprBinary::ExprBinary(std::unique_ptr<Expr> lhs, Token *op, std::unique_ptr<Expr> rhs)
     : m_lhs(std::move(lhs)), m_op(op), m_rhs(std::move(rhs)) {}
 
 ExprType
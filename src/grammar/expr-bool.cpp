@@ -27,7 +27,7 @@
 
 #include "ast.hpp"
 
-ExprBool::ExprBool(std::shared_ptr<Token> tok, bool value)
+ExprBool::ExprBool(Token *tok, bool value)
     : m_tok(tok), m_value(value) {}
 
 ExprType
@@ -27,7 +27,7 @@
 
 #include "ast.hpp"
 
-ExprCharLit::ExprCharLit(std::shared_ptr<Token> tok) : m_tok(tok) {}
+ExprCharLit::ExprCharLit(Token *tok) : m_tok(tok) {}
 
 ExprType
 ExprCharLit::get_type() const {
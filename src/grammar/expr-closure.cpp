@@ -27,10 +27,12 @@
 
 #include "ast.hpp"
 
-ExprClosure::ExprClosure(std::vector<std::pair<std::shared_ptr<Token>, uint32_t>> args,
+ExprClosure::ExprClosure(std::vector<std::pair<Token *, uint32_t>> args,
                          std::unique_ptr<StmtBlock> block,
-                         std::shared_ptr<Token> tok)
-    : m_args(args), m_block(std::move(block)), m_tok(tok) {}
+                         Token *tok)
+    : m_args(args), m_block(std::move(block)), m_tok(tok) {
+    ast_note_definition();
+}
 
 ExprType
 ExprClosure::get_type() const {
@@ -27,7 +27,7 @@
 
 #include "ast.hpp"
 
-ExprDict::ExprDict(std::vector<std::pair<std::unique_ptr<Expr>, std::unique_ptr<Expr>>> values, std::shared_ptr<Token> tok)
+ExprDict::ExprDict(std::vector<std::pair<std::unique_ptr<Expr>, std::unique_ptr<Expr>>> values, Token *tok)
     : m_values(std::move(values)), m_tok(tok) {}
 
 ExprType ExprDict::get_type() const {
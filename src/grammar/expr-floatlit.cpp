@@ -27,7 +27,7 @@
 
 #include "ast.hpp"
 
-ExprFloatLit::ExprFloatLit(std::shared_ptr<Token> tok) : m_tok(tok) {}
+ExprFloatLit::ExprFloatLit(Token *tok) : m_tok(tok) {}
 
 ExprType
 ExprFloatLit::get_type() const {
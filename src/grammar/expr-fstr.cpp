@@ -26,8 +26,15 @@
 #include <memory>
 
 #include "ast.hpp"
+#include "lexer.hpp"
 
-ExprFStr::ExprFStr(std::shared_ptr<Token> tok) : m_tok(tok) {}
+ExprFStr::ExprFStr(Token *tok,
+                   std::vector<std::string> parts,
+                   std::vector<std::unique_ptr<Expr>> exprs,
+                   std::unique_ptr<Lexer> lexer)
+    : m_tok(tok), m_parts(std::move(parts)), m_exprs(std::move(exprs)), m_lexer(std::move(lexer)) {}
+
+ExprFStr::~ExprFStr() = default;
 
 ExprType
 ExprFStr::get_type() const {
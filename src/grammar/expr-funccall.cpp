@@ -29,7 +29,7 @@
 
 ExprFuncCall::ExprFuncCall(std::unique_ptr<Expr> left,
                            std::vector<std::unique_ptr<Expr>> params,
-                           std::shared_ptr<Token> tok)
+                           Token *tok)
     : m_left(std::move(left)), m_params(std::move(params)), m_tok(tok) {}
 
 ExprType
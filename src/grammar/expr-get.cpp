@@ -29,7 +29,7 @@
 
 ExprGet::ExprGet(std::unique_ptr<Expr> left,
                  std::variant<std::unique_ptr<ExprIdent>, std::unique_ptr<ExprFuncCall>> right,
-                 std::shared_ptr<Token> tok)
+                 Token *tok)
     : m_left(std::move(left)), m_right(std::move(right)), m_tok(tok) {}
 
 ExprType
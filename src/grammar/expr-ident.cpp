@@ -27,7 +27,7 @@
 
 #include "ast.hpp"
 
-ExprIdent::ExprIdent(std::shared_ptr<Token> tok) : m_tok(tok) {}
+ExprIdent::ExprIdent(Token *tok) : m_tok(tok) {}
 
 ExprType
 ExprIdent::get_type() const {
@@ -27,7 +27,7 @@
 
 #include "ast.hpp"
 
-ExprIntLit::ExprIntLit(std::shared_ptr<Token> tok) : m_tok(tok) {}
+ExprIntLit::ExprIntLit(Token *tok) : m_tok(tok) {}
 
 ExprType
 ExprIntLit::get_type() const {
@@ -27,7 +27,7 @@
 
 #include "ast.hpp"
 
-ExprListLit::ExprListLit(std::vector<std::unique_ptr<Expr>> elems, std::shared_ptr<Token> tok)
+ExprListLit::ExprListLit(std::vector<std::unique_ptr<Expr>> elems, Token *tok)
     : m_elems(std::move(elems)), m_tok(tok) {}
 
 ExprType
@@ -27,7 +27,7 @@
 
 #include "ast.hpp"
 
-ExprSlice::ExprSlice(std::optional<std::unique_ptr<Expr>> start, std::optional<std::unique_ptr<Expr>> end, std::shared_ptr<Token> tok)
+ExprSlice::ExprSlice(std::optional<std::unique_ptr<Expr>> start, std::optional<std::unique_ptr<Expr>> end, Token *tok)
     : m_start(std::move(start)), m_end(std::move(end)), m_tok(tok) {}
 
 ExprType ExprSlice::get_type() const {
@@ -27,7 +27,7 @@
 
 #include "ast.hpp"
 
-ExprStrLit::ExprStrLit(std::shared_ptr<Token> tok) : m_tok(tok) {}
+ExprStrLit::ExprStrLit(Token *tok) : m_tok(tok) {}
 
 ExprType
 ExprStrLit::get_type() const {
@@ -27,7 +27,7 @@
 
 #include "ast.hpp"
 
-ExprTuple::ExprTuple(std::vector<std::unique_ptr<Expr>> exprs, std::shared_ptr<Token> tok)
+ExprTuple::ExprTuple(std::vector<std::unique_ptr<Expr>> exprs, Token *tok)
     : m_exprs(std::move(exprs)), m_tok(tok) {}
 
 ExprType
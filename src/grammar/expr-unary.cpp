@@ -27,7 +27,7 @@
 
 #include "ast.hpp"
 
-ExprUnary::ExprUnary(std::shared_ptr<Token> op, std::unique_ptr<Expr> expr)
+ExprUnary::ExprUnary(Token *op, std::unique_ptr<Expr> expr)
     : m_op(op), m_expr(std::move(expr)) {}
 
 ExprType
@@ -27,6 +27,29 @@
 
 #include "ast.hpp"
 
-Program::Program(std::vector<std::unique_ptr<Stmt>> stmts, const std::string filepath)
-    : m_stmts(std::move(stmts)), m_filepath(filepath) {}
+static AstArenaScope *current_scope = nullptr;
+
+AstArenaScope::AstArenaScope(Arena *arena)
+    : m_arena(arena), m_defines(false), m_prev(current_scope) {
+    current_scope = this;
+}
+
+AstArenaScope::~AstArenaScope() {
+    current_scope = m_prev;
+}
+
+void *
+ast_alloc(size_t bytes) {
+    assert(current_scope && "AST node allocated outside of an AstArenaScope");
+    return arena_alloc(*current_scope->m_arena, bytes);
+}
+
+void
+ast_note_definition(void) {
+    assert(current_scope);
+    current_scope->m_defines = true;
+}
+
+Program::Program(std::unique_ptr<Arena> arena, std::vector<std::unique_ptr<Stmt>> stmts, const std::string filepath)
+    : m_arena(std::move(arena)), m_stmts(std::move(stmts)), m_filepath(filepath), m_defines(false) {}
 
@@ -27,7 +27,7 @@
 
 #include "ast.hpp"
 
-StmtContinue::StmtContinue(std::shared_ptr<Token> tok)
+StmtContinue::StmtContinue(Token *tok)
     : m_tok(tok) {}
 
 StmtType
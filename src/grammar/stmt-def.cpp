@@ -27,13 +27,15 @@
 
 #include "ast.hpp"
 
-StmtDef::StmtDef(std::shared_ptr<Token> id,
-                 std::vector<std::pair<std::shared_ptr<Token>, uint32_t>> args,
+StmtDef::StmtDef(Token *id,
+                 std::vector<std::pair<Token *, uint32_t>> args,
                  std::unique_ptr<StmtBlock> block,
                  uint32_t attrs) :
     m_id(id), m_args(args),
     m_block(std::move(block)),
-    m_attrs(attrs) {}
+    m_attrs(attrs) {
+    ast_note_definition();
+}
 
 StmtType
 StmtDef::stmt_type() const {
@@ -27,10 +27,12 @@
 
 #include "ast.hpp"
 
-StmtEnum::StmtEnum(std::shared_ptr<Token> id,
-                   std::vector<std::pair<std::shared_ptr<Token>, std::unique_ptr<Expr>>> elems,
+StmtEnum::StmtEnum(Token *id,
+                   std::vector<std::pair<Token *, std::unique_ptr<Expr>>> elems,
                    uint32_t attrs)
-    : m_id(std::move(id)), m_elems(std::move(elems)), m_attrs(attrs) {}
+    : m_id(std::move(id)), m_elems(std::move(elems)), m_attrs(attrs) {
+    ast_note_definition();
+}
 
 StmtType
 StmtEnum::stmt_type() const {
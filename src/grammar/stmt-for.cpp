@@ -27,7 +27,7 @@
 
 #include "ast.hpp"
 
-StmtFor::StmtFor(std::shared_ptr<Token> enumerator,
+StmtFor::StmtFor(Token *enumerator,
                  std::unique_ptr<Expr> start,
                  std::unique_ptr<Expr> end,
                  std::unique_ptr<StmtBlock> block)
@@ -27,7 +27,7 @@
 
 #include "ast.hpp"
 
-StmtForeach::StmtForeach(std::shared_ptr<Token> enumerator,
+StmtForeach::StmtForeach(Token *enumerator,
                          std::unique_ptr<Expr> expr,
                          std::unique_ptr<StmtBlock> block,
                          uint32_t attrs)
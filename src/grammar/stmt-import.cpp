@@ -28,7 +28,7 @@
 #include "ast.hpp"
 #include "common.hpp"
 
-StmtImport::StmtImport(std::shared_ptr<Token> fp, std::optional<std::shared_ptr<Token>> depth)
+StmtImport::StmtImport(Token *fp, std::optional<Token *> depth)
     : m_fp(fp), m_depth(depth) {
     // __m_depth = m_depth->lexeme() == COMMON_EARLKW_ALMOST ? COMMON_DEPTH_ALMOST : COMMON_DEPTH_FULL;
     if (!m_depth.has_value())
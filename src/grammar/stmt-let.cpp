@@ -27,7 +27,7 @@
 
 #include "ast.hpp"
 
-StmtLet::StmtLet(std::vector<std::shared_ptr<Token>> ids, std::unique_ptr<Expr> expr, uint32_t attrs)
+StmtLet::StmtLet(std::vector<Token *> ids, std::unique_ptr<Expr> expr, uint32_t attrs)
     : m_ids(ids), m_expr(std::move(expr)), m_attrs(attrs) {}
 
 StmtType
@@ -28,7 +28,7 @@
 #include "ast.hpp"
 
 
-StmtLoop::StmtLoop(std::shared_ptr<Token> tok, std::unique_ptr<StmtBlock> block)
+StmtLoop::StmtLoop(Token *tok, std::unique_ptr<StmtBlock> block)
     : m_tok(tok), m_block(std::move(block)) {}
 
 StmtType StmtLoop::stmt_type() const {
@@ -29,7 +29,7 @@
 
 StmtMut::StmtMut(std::unique_ptr<Expr> left,
                  std::unique_ptr<Expr> right,
-                 std::shared_ptr<Token> equals)
+                 Token *equals)
     : m_left(std::move(left)), m_right(std::move(right)), m_equals(equals) {}
 
 StmtType
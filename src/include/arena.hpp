@@ -34,25 +34,44 @@
 #define ARENA_H
 
 #include <vector>
+#include <cstddef>
 #include <stddef.h>
 #include <stdint.h>
 
-/// @brief An Arena allocator for easiser memory
-/// management. Allocate a bunch of memory
-/// up-front first, and then have other
-/// heap-alloc'd objects use this pool
-/// for the required memory.
+/// @brief A region (bump) allocator. Memory is handed out
+/// from large chunks by bumping a pointer, and is only ever
+/// given back all at once when the arena is destroyed. Objects
+/// placed in an arena still need their destructors called, but
+/// never need to be freed individually.
 struct Arena {
-    std::vector<uint8_t> m_mem;
+    /// @brief The chunks allocated so far, freed in the destructor
+    std::vector<uint8_t *> m_chunks;
+
+    /// @brief The next free byte in the current chunk
+    uint8_t *m_cur;
+
+    /// @brief One past the last byte of the current chunk
+    uint8_t *m_end;
+
+    /// @brief The size of the next chunk to allocate. It doubles
+    /// every chunk up to `ARENA_MAX_CHUNK`.
+    size_t m_chunk;
+
+    /// @brief The total number of bytes handed out
     size_t m_len;
-    size_t m_cap;
 
-    Arena(size_t bytes);
-    ~Arena() = default;
+    Arena(size_t bytes = ARENA_MIN_CHUNK);
+    ~Arena();
+
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    static constexpr size_t ARENA_MIN_CHUNK = 16*1024;
+    static constexpr size_t ARENA_MAX_CHUNK = 1024*1024;
 };
 
-/// @brief Allocate `bytes` number of bytes in an arena.
-[[deprecated]]
-uint8_t *arena_alloc(Arena &arena, size_t bytes);
+/// @brief Allocate `bytes` number of bytes in an arena, aligned to `align`
+/// (which must be a power of two no larger than `alignof(std::max_align_t)`).
+void *arena_alloc(Arena &arena, size_t bytes, size_t align = alignof(std::max_align_t));
 
 #endif // ARENA_H
@@ -31,6 +31,7 @@
 #include <optional>
 
 #include "token.hpp"
+#include "arena.hpp"
 
 /**
  * The grammar of EARL.
@@ -92,13 +93,62 @@ struct StmtDef;
 struct StmtBlock;
 struct ExprFuncCall;
 
+namespace earl {
+    namespace value {struct Obj;}
+}
+
+/// @brief Where the resolver placed a local variable: the
+/// function whose frame it lives in and its index in that frame.
+/// A null `m_frame` means the name is looked up dynamically.
+struct Slot {
+    StmtDef *m_frame = nullptr;
+    int m_index = -1;
+};
+
+/// @brief Makes `arena` the one that AST nodes are allocated in
+/// for as long as the scope is alive. `Parser::parse_program` opens
+/// one per program, so every node lives exactly as long as the
+/// `Program` that owns the arena. There is no fallback arena:
+/// allocating a node outside of a scope is a bug.
+struct AstArenaScope {
+    AstArenaScope(Arena *arena);
+    ~AstArenaScope();
+
+    AstArenaScope(const AstArenaScope &) = delete;
+
+    Arena *m_arena;
+
+    /// @brief Whether a node that runtime values point into
+    /// (see `ast_note_definition`) was created in this scope
+    bool m_defines;
+
+    AstArenaScope *m_prev;
+};
+
+/// @brief Allocate an AST node in the current AST arena
+void *ast_alloc(size_t bytes);
+
+/// @brief Record that the node being built can be referenced by
+/// values that outlive its evaluation: functions, closures, classes
+/// and enums. Called from their constructors.
+void ast_note_definition(void);
+
 /// @brief Base class for an expression
 struct Expr {
     virtual ~Expr() = default;
 
+    static void *operator new(size_t bytes) { return ast_alloc(bytes); }
+
+    /// @brief Nodes are freed along with their arena.
+    static void operator delete(void *) noexcept {}
+
     /// @brief The get expression type
     /// @returns The type of the expression
     virtual ExprType get_type() const = 0;
+
+    /// @brief The value of the expression if the optimizer could
+    /// compute it at parse time. Evaluating it yields a fresh copy.
+    std::shared_ptr<earl::value::Obj> m_const = nullptr;
 };
 
 /// @brief The Expression Term class
@@ -112,19 +162,19 @@ struct ExprTerm : public Expr {
 
 struct ExprTuple : public ExprTerm {
     std::vector<std::unique_ptr<Expr>> m_exprs;
-    std::shared_ptr<Token> m_tok;
+    Token *m_tok;
 
-    ExprTuple(std::vector<std::unique_ptr<Expr>> exprs, std::shared_ptr<Token> tok);
+    ExprTuple(std::vector<std::unique_ptr<Expr>> exprs, Token *tok);
     ExprType get_type() const override;
     ExprTermType get_term_type() const override;
 };
 
 struct ExprDict : public ExprTerm {
     std::vector<std::pair<std::unique_ptr<Expr>, std::unique_ptr<Expr>>> m_values;
-    std::shared_ptr<Token> m_tok;
+    Token *m_tok;
 
     ExprDict(std::vector<std::pair<std::unique_ptr<Expr>, std::unique_ptr<Expr>>> values,
-             std::shared_ptr<Token> tok);
+             Token *tok);
     ExprType get_type() const override;
     ExprTermType get_term_type() const override;
 };
@@ -132,9 +182,9 @@ struct ExprDict : public ExprTerm {
 struct ExprArrayAccess : public ExprTerm {
     std::unique_ptr<Expr> m_left;
     std::unique_ptr<Expr> m_expr;
-    std::shared_ptr<Token> m_tok;
+    Token *m_tok;
 
-    ExprArrayAccess(std::unique_ptr<Expr> left, std::unique_ptr<Expr> expr, std::shared_ptr<Token> tok);
+    ExprArrayAccess(std::unique_ptr<Expr> left, std::unique_ptr<Expr> expr, Token *tok);
     ExprType get_type() const override;
     ExprTermType get_term_type() const override;
 };
@@ -142,9 +192,12 @@ struct ExprArrayAccess : public ExprTerm {
 /// @brief The Expression Identifier class
 struct ExprIdent : public ExprTerm {
     /// @brief The token of the identifier
-    std::shared_ptr<Token> m_tok;
+    Token *m_tok;
 
-    ExprIdent(std::shared_ptr<Token> tok);
+    /// @brief The frame slot this identifier refers to (see resolver.hpp)
+    Slot m_slot;
+
+    ExprIdent(Token *tok);
     ExprType get_type() const override;
     ExprTermType get_term_type() const override;
 };
@@ -152,11 +205,11 @@ struct ExprIdent : public ExprTerm {
 struct ExprGet : public ExprTerm {
     std::unique_ptr<Expr> m_left;
     std::variant<std::unique_ptr<ExprIdent>, std::unique_ptr<ExprFuncCall>> m_right;
-    std::shared_ptr<Token> m_tok;
+    Token *m_tok;
 
     ExprGet(std::unique_ptr<Expr> left,
             std::variant<std::unique_ptr<ExprIdent>, std::unique_ptr<ExprFuncCall>> right,
-            std::shared_ptr<Token> tok);
+            Token *tok);
     ExprType get_type() const override;
     ExprTermType get_term_type() const override;
 };
@@ -164,11 +217,11 @@ struct ExprGet : public ExprTerm {
 struct ExprModAccess : public ExprTerm {
     std::unique_ptr<ExprIdent> m_expr_ident;
     std::variant<std::unique_ptr<ExprIdent>, std::unique_ptr<ExprFuncCall>> m_right;
-    std::shared_ptr<Token> m_tok;
+    Token *m_tok;
 
     ExprModAccess(std::unique_ptr<ExprIdent> expr_ident,
                   std::variant<std::unique_ptr<ExprIdent>, std::unique_ptr<ExprFuncCall>> right,
-                  std::shared_ptr<Token> tok);
+                  Token *tok);
     ExprType get_type() const override;
     ExprTermType get_term_type() const override;
 };
@@ -176,9 +229,9 @@ struct ExprModAccess : public ExprTerm {
 /// @brief The Expression Integer Literal class
 struct ExprIntLit : public ExprTerm {
     /// @brief The token of the integer literal
-    std::shared_ptr<Token> m_tok;
+    Token *m_tok;
 
-    ExprIntLit(std::shared_ptr<Token> tok);
+    ExprIntLit(Token *tok);
     ExprType get_type() const override;
     ExprTermType get_term_type() const override;
 };
@@ -186,9 +239,9 @@ struct ExprIntLit : public ExprTerm {
 /// @brief The Expression Float Literal class
 struct ExprFloatLit : public ExprTerm {
     /// @brief The token of the integer literal
-    std::shared_ptr<Token> m_tok;
+    Token *m_tok;
 
-    ExprFloatLit(std::shared_ptr<Token> tok);
+    ExprFloatLit(Token *tok);
     ExprType get_type() const override;
     ExprTermType get_term_type() const override;
 };
@@ -196,56 +249,73 @@ struct ExprFloatLit : public ExprTerm {
 /// @brief The Expression String Literal class
 struct ExprStrLit : public ExprTerm {
     /// @brief The token of the string literal
-    std::shared_ptr<Token> m_tok;
+    Token *m_tok;
 
-    ExprStrLit(std::shared_ptr<Token> tok);
+    ExprStrLit(Token *tok);
     ExprType get_type() const override;
     ExprTermType get_term_type() const override;
 };
 
+/// @brief A format string, i.e., f"x = {x + 1}". It is split
+/// up when parsed into the text around the `{}` and the
+/// expressions inside of them.
 struct ExprFStr : public ExprTerm {
-    std::shared_ptr<Token> m_tok;
+    Token *m_tok;
+
+    /// @brief The text in between the expressions, there is
+    /// always one more of these than there are expressions.
+    std::vector<std::string> m_parts;
+
+    /// @brief The expressions inside of `{}` in order
+    std::vector<std::unique_ptr<Expr>> m_exprs;
 
-    ExprFStr(std::shared_ptr<Token> tok);
+    /// @brief Owns the tokens that `m_exprs` point into
+    std::unique_ptr<Lexer> m_lexer;
+
+    ExprFStr(Token *tok,
+             std::vector<std::string> parts,
+             std::vector<std::unique_ptr<Expr>> exprs,
+             std::unique_ptr<Lexer> lexer);
+    ~ExprFStr();
     ExprType get_type() const override;
     ExprTermType get_term_type() const override;
 };
 
 struct ExprCharLit : public ExprTerm {
-    std::shared_ptr<Token> m_tok;
+    Token *m_tok;
 
-    ExprCharLit(std::shared_ptr<Token> tok);
+    ExprCharLit(Token *tok);
     ExprType get_type() const override;
     ExprTermType get_term_type() const override;
 };
 
 /// @brief The Expression Bool class
 struct ExprBool : public ExprTerm {
-    std::shared_ptr<Token> m_tok;
+    Token *m_tok;
     bool m_value;
 
-    ExprBool(std::shared_ptr<Token> tok, bool value);
+    ExprBool(Token *tok, bool value);
     ExprType get_type() const override;
     ExprTermType get_term_type() const override;
 };
 
 /// @brief The Expression None class
 struct ExprNone : public ExprTerm {
-    std::shared_ptr<Token> m_tok;
+    Token *m_tok;
 
-    ExprNone(std::shared_ptr<Token> tok);
+    ExprNone(Token *tok);
     ExprType get_type() const override;
     ExprTermType get_term_type() const override;
 };
 
 struct ExprClosure : public ExprTerm {
-    std::vector<std::pair<std::shared_ptr<Token>, uint32_t>> m_args;
+    std::vector<std::pair<Token *, uint32_t>> m_args;
     std::unique_ptr<StmtBlock> m_block;
-    std::shared_ptr<Token> m_tok;
+    Token *m_tok;
 
-    ExprClosure(std::vector<std::pair<std::shared_ptr<Token>, uint32_t>> args,
+    ExprClosure(std::vector<std::pair<Token *, uint32_t>> args,
                 std::unique_ptr<StmtBlock> block,
-                std::shared_ptr<Token> tok);
+                Token *tok);
     ExprType get_type() const override;
     ExprTermType get_term_type() const override;
 };
@@ -260,9 +330,9 @@ struct ExprFuncCall : public ExprTerm {
     /// to the function call
     std::vector<std::unique_ptr<Expr>> m_params;
 
-    std::shared_ptr<Token> m_tok;
+    Token *m_tok;
 
-    ExprFuncCall(std::unique_ptr<Expr> id, std::vector<std::unique_ptr<Expr>> params, std::shared_ptr<Token> tok);
+    ExprFuncCall(std::unique_ptr<Expr> id, std::vector<std::unique_ptr<Expr>> params, Token *tok);
     ExprType get_type() const override;
     ExprTermType get_term_type() const override;
 };
@@ -271,9 +341,9 @@ struct ExprFuncCall : public ExprTerm {
 struct ExprListLit : public ExprTerm {
     /// @brief The elements in the list
     std::vector<std::unique_ptr<Expr>> m_elems;
-    std::shared_ptr<Token> m_tok;
+    Token *m_tok;
 
-    ExprListLit(std::vector<std::unique_ptr<Expr>> elems, std::shared_ptr<Token> tok);
+    ExprListLit(std::vector<std::unique_ptr<Expr>> elems, Token *tok);
     ExprType get_type() const override;
     ExprTermType get_term_type() const override;
 };
@@ -282,9 +352,9 @@ struct ExprRange : public ExprTerm {
     std::unique_ptr<Expr> m_start;
     std::unique_ptr<Expr> m_end;
     bool m_inclusive;
-    std::shared_ptr<Token> m_tok;
+    Token *m_tok;
 
-    ExprRange(std::unique_ptr<Expr> start, std::unique_ptr<Expr> end, bool inclusive, std::shared_ptr<Token> tok);
+    ExprRange(std::unique_ptr<Expr> start, std::unique_ptr<Expr> end, bool inclusive, Token *tok);
     ExprType get_type() const override;
     ExprTermType get_term_type() const override;
 };
@@ -292,18 +362,18 @@ struct ExprRange : public ExprTerm {
 struct ExprSlice : public ExprTerm {
     std::optional<std::unique_ptr<Expr>> m_start;
     std::optional<std::unique_ptr<Expr>> m_end;
-    std::shared_ptr<Token> m_tok;
+    Token *m_tok;
 
-    ExprSlice(std::optional<std::unique_ptr<Expr>> start, std::optional<std::unique_ptr<Expr>> end, std::shared_ptr<Token> tok);
+    ExprSlice(std::optional<std::unique_ptr<Expr>> start, std::optional<std::unique_ptr<Expr>> end, Token *tok);
     ExprType get_type() const override;
     ExprTermType get_term_type() const override;
 };
 
 struct ExprUnary : public Expr {
-    std::shared_ptr<Token> m_op;
+    Token *m_op;
     std::unique_ptr<Expr> m_expr;
 
-    ExprUnary(std::shared_ptr<Token> op, std::unique_ptr<Expr> expr);
+    ExprUnary(Token *op, std::unique_ptr<Expr> expr);
     ExprType get_type() const override;
 };
 
@@ -313,12 +383,17 @@ struct ExprBinary : public Expr {
     std::unique_ptr<Expr> m_lhs;
 
     /// @brief The token of the binary operator
-    std::shared_ptr<Token> m_op;
+    Token *m_op;
 
     /// @brief The expression of the right hand side
     std::unique_ptr<Expr> m_rhs;
 
-    ExprBinary(std::unique_ptr<Expr> lhs, std::shared_ptr<Token> op, std::unique_ptr<Expr> rhs);
+    /// @brief Cleared the first time this expression does not
+    /// evaluate to a scalar so the interpreter stops trying
+    /// to evaluate it unboxed.
+    bool m_unboxed = true;
+
+    ExprBinary(std::unique_ptr<Expr> lhs, Token *op, std::unique_ptr<Expr> rhs);
     ExprType get_type() const override;
 };
 
@@ -326,6 +401,11 @@ struct ExprBinary : public Expr {
 struct Stmt {
     virtual ~Stmt() = default;
 
+    static void *operator new(size_t bytes) { return ast_alloc(bytes); }
+
+    /// @brief Nodes are freed along with their arena.
+    static void operator delete(void *) noexcept {}
+
     /// @brief Get the statement type
     /// @returns The type of the statement
     virtual StmtType stmt_type() const = 0;
@@ -337,17 +417,21 @@ struct Stmt {
 struct StmtDef : public Stmt {
 
     /// @brief The token of the function name
-    std::shared_ptr<Token> m_id;
+    Token *m_id;
 
-    std::vector<std::pair<std::shared_ptr<Token>, uint32_t>> m_args;
+    std::vector<std::pair<Token *, uint32_t>> m_args;
 
     /// @brief The Statement Block of the Statement Definition
     std::unique_ptr<StmtBlock> m_block;
 
     uint32_t m_attrs;
 
-    StmtDef(std::shared_ptr<Token> id,
-            std::vector<std::pair<std::shared_ptr<Token>, uint32_t>> args,
+    /// @brief The number of frame slots the resolver handed out,
+    /// or -1 if this function was not resolved.
+    int m_nslots = -1;
+
+    StmtDef(Token *id,
+            std::vector<std::pair<Token *, uint32_t>> args,
             std::unique_ptr<StmtBlock> block,
             uint32_t attrs);
 
@@ -357,14 +441,17 @@ struct StmtDef : public Stmt {
 /// @brief The Statement Let class
 struct StmtLet : public Stmt {
     /// @brief The token of the identifer
-    std::vector<std::shared_ptr<Token>> m_ids;
+    std::vector<Token *> m_ids;
 
     /// @brief The expression of the Let Statement
     std::unique_ptr<Expr> m_expr;
 
     uint32_t m_attrs;
 
-    StmtLet(std::vector<std::shared_ptr<Token>> ids, std::unique_ptr<Expr> expr, uint32_t attrs);
+    /// @brief The frame slot of each id in `m_ids` (empty outside of functions)
+    std::vector<Slot> m_slots;
+
+    StmtLet(std::vector<Token *> ids, std::unique_ptr<Expr> expr, uint32_t attrs);
     StmtType stmt_type() const override;
 };
 
@@ -386,9 +473,9 @@ struct StmtMut : public Stmt {
     /// @brief The expression of the right hand side
     std::unique_ptr<Expr> m_right;
 
-    std::shared_ptr<Token> m_equals;
+    Token *m_equals;
 
-    StmtMut(std::unique_ptr<Expr> left, std::unique_ptr<Expr> right, std::shared_ptr<Token> m_equals);
+    StmtMut(std::unique_ptr<Expr> left, std::unique_ptr<Expr> right, Token *m_equals);
     StmtType stmt_type() const override;
 };
 
@@ -423,23 +510,23 @@ struct StmtIf : public Stmt {
 struct StmtReturn : public Stmt {
     /// @brief The expression that the Statement Return is returning
     std::optional<std::unique_ptr<Expr>> m_expr;
-    std::shared_ptr<Token> m_tok;
+    Token *m_tok;
 
-    StmtReturn(std::optional<std::unique_ptr<Expr>> expr, std::shared_ptr<Token> tok);
+    StmtReturn(std::optional<std::unique_ptr<Expr>> expr, Token *tok);
     StmtType stmt_type() const override;
 };
 
 /// @brief The Statement Break class
 struct StmtBreak : public Stmt {
-    std::shared_ptr<Token> m_tok;
+    Token *m_tok;
 
-    StmtBreak(std::shared_ptr<Token> tok);
+    StmtBreak(Token *tok);
     StmtType stmt_type() const override;
 };
 
 struct StmtContinue : public Stmt {
-    std::shared_ptr<Token> m_tok;
-    StmtContinue(std::shared_ptr<Token> tok);
+    Token *m_tok;
+    StmtContinue(Token *tok);
     StmtType stmt_type() const override;
 };
 
@@ -456,17 +543,17 @@ struct StmtWhile : public Stmt {
 };
 
 struct StmtLoop : public Stmt {
-    std::shared_ptr<Token> m_tok;
+    Token *m_tok;
     std::unique_ptr<StmtBlock> m_block;
 
-    StmtLoop(std::shared_ptr<Token> tok, std::unique_ptr<StmtBlock> block);
+    StmtLoop(Token *tok, std::unique_ptr<StmtBlock> block);
     StmtType stmt_type() const override;
 };
 
 /// @brief The Statement For class
 struct StmtForeach : public Stmt {
     /// @brief The identifier of the enumerator variable
-    std::shared_ptr<Token> m_enumerator;
+    Token *m_enumerator;
 
     std::unique_ptr<Expr> m_expr;
 
@@ -475,7 +562,10 @@ struct StmtForeach : public Stmt {
 
     uint32_t m_attrs;
 
-    StmtForeach(std::shared_ptr<Token> enumerator,
+    /// @brief The frame slot of the enumerator
+    Slot m_slot;
+
+    StmtForeach(Token *enumerator,
                 std::unique_ptr<Expr> expr,
                 std::unique_ptr<StmtBlock> block,
                 uint32_t attrs);
@@ -485,7 +575,7 @@ struct StmtForeach : public Stmt {
 
 struct StmtFor : public Stmt {
     /// @brief The identifier of the enumerator variable
-    std::shared_ptr<Token> m_enumerator;
+    Token *m_enumerator;
 
     /// @brief The starting expression
     std::unique_ptr<Expr> m_start;
@@ -496,7 +586,10 @@ struct StmtFor : public Stmt {
     /// @brief The block for the loop to execute
     std::unique_ptr<StmtBlock> m_block;
 
-    StmtFor(std::shared_ptr<Token> enumerator,
+    /// @brief The frame slot of the enumerator
+    Slot m_slot;
+
+    StmtFor(Token *enumerator,
             std::unique_ptr<Expr> start,
             std::unique_ptr<Expr> end,
             std::unique_ptr<StmtBlock> block);
@@ -505,32 +598,32 @@ struct StmtFor : public Stmt {
 };
 
 struct StmtImport : public Stmt {
-    std::shared_ptr<Token> m_fp;
-    std::optional<std::shared_ptr<Token>> m_depth;
+    Token *m_fp;
+    std::optional<Token *> m_depth;
     uint32_t __m_depth;
 
-    StmtImport(std::shared_ptr<Token> fp, std::optional<std::shared_ptr<Token>> depth);
+    StmtImport(Token *fp, std::optional<Token *> depth);
     StmtType stmt_type() const override;
 };
 
 struct StmtMod : public Stmt {
-    std::shared_ptr<Token> m_id;
+    Token *m_id;
 
-    StmtMod(std::shared_ptr<Token> id);
+    StmtMod(Token *id);
     StmtType stmt_type() const override;
 };
 
 struct StmtClass : public Stmt {
-    std::shared_ptr<Token> m_id;
+    Token *m_id;
     uint32_t m_attrs;
-    std::vector<std::shared_ptr<Token>> m_constructor_args;
+    std::vector<Token *> m_constructor_args;
 
     std::vector<std::unique_ptr<StmtLet>> m_members;
     std::vector<std::unique_ptr<StmtDef>> m_methods;
 
-    StmtClass(std::shared_ptr<Token> id,
+    StmtClass(Token *id,
               uint32_t attrs,
-              std::vector<std::shared_ptr<Token>> constructor_args,
+              std::vector<Token *> constructor_args,
               std::vector<std::unique_ptr<StmtLet>> members,
               std::vector<std::unique_ptr<StmtDef>> methods);
 
@@ -560,12 +653,12 @@ struct StmtMatch : public Stmt {
 };
 
 struct StmtEnum : public Stmt {
-    std::shared_ptr<Token> m_id;
-    std::vector<std::pair<std::shared_ptr<Token>, std::unique_ptr<Expr>>> m_elems;
+    Token *m_id;
+    std::vector<std::pair<Token *, std::unique_ptr<Expr>>> m_elems;
     uint32_t m_attrs;
 
-    StmtEnum(std::shared_ptr<Token> id,
-             std::vector<std::pair<std::shared_ptr<Token>,
+    StmtEnum(Token *id,
+             std::vector<std::pair<Token *,
              std::unique_ptr<Expr>>> elems,
              uint32_t attrs);
     StmtType stmt_type() const override;
@@ -574,11 +667,20 @@ struct StmtEnum : public Stmt {
 /// @brief The Program class. It is the starting point
 /// of the whole program.
 struct Program {
+    /// @brief The arena holding every node of the program. It is
+    /// declared first so that it is destroyed after them.
+    std::unique_ptr<Arena> m_arena;
+
     /// @brief A vector of statement to evaluate
     std::vector<std::unique_ptr<Stmt>> m_stmts;
     const std::string m_filepath;
 
-    Program(std::vector<std::unique_ptr<Stmt>> stmts, const std::string filepath);
+    /// @brief Whether the program defines a function, closure,
+    /// class or enum. If not, nothing refers to its nodes once it
+    /// has been evaluated and it can be freed (see the REPL).
+    bool m_defines;
+
+    Program(std::unique_ptr<Arena> arena, std::vector<std::unique_ptr<Stmt>> stmts, const std::string filepath);
 };
 
 #endif // AST_H
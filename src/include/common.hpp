@@ -42,6 +42,11 @@ extern uint32_t flags;
 #define __REPL_NOCOLOR 1 << 2
 #define __WATCH 1 << 3
 #define __SHOWFUNS 1 << 4
+#define __VM 1 << 5
+#define __SHOWIMPORTS 1 << 6
+#define __CACHE 1 << 7
+#define __BENCHLEXER 1 << 8
+#define __SHOWCACHE 1 << 9
 
 #define COMMON_EARL2ARG_HELP           "help"
 #define COMMON_EARL2ARG_WITHOUT_STDLIB "without-stdlib"
@@ -49,8 +54,13 @@ extern uint32_t flags;
 #define COMMON_EARL2ARG_REPL_NOCOLOR   "repl-nocolor"
 #define COMMON_EARL2ARG_WATCH          "watch"
 #define COMMON_EARL2ARG_SHOWFUNS       "show-funs"
+#define COMMON_EARL2ARG_ENGINE         "engine"
+#define COMMON_EARL2ARG_SHOWIMPORTS    "show-imports"
+#define COMMON_EARL2ARG_CACHE          "cache"
+#define COMMON_EARL2ARG_BENCHLEXER     "bench-lexer"
+#define COMMON_EARL2ARG_SHOWCACHE      "show-cache"
 
-#define COMMON_EARL2ARG_ASCPL {COMMON_EARL2ARG_HELP, COMMON_EARL2ARG_WITHOUT_STDLIB, COMMON_EARL2ARG_VERSION, COMMON_EARL2ARG_REPL_NOCOLOR, COMMON_EARL2ARG_WATCH, COMMON_EARL2ARG_SHOWFUNS}
+#define COMMON_EARL2ARG_ASCPL {COMMON_EARL2ARG_HELP, COMMON_EARL2ARG_WITHOUT_STDLIB, COMMON_EARL2ARG_VERSION, COMMON_EARL2ARG_REPL_NOCOLOR, COMMON_EARL2ARG_WATCH, COMMON_EARL2ARG_SHOWFUNS, COMMON_EARL2ARG_ENGINE, COMMON_EARL2ARG_SHOWIMPORTS, COMMON_EARL2ARG_CACHE, COMMON_EARL2ARG_BENCHLEXER, COMMON_EARL2ARG_SHOWCACHE}
 
 #define COMMON_EARL1ARG_HELP     'h'
 #define COMMON_EARL1ARG_VERSTION 'v'
@@ -0,0 +1,4 @@
+#pragma once
+
+#define PREFIX "/tmp/earlpfx"
+#define VERSION "0.4.9"
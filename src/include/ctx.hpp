@@ -88,7 +88,17 @@ struct WorldCtx : public Ctx {
     void debug_dump_variables(void) const;
     bool enum_exists(const std::string &id) const;
     std::shared_ptr<earl::value::Enum> enum_get(const std::string &id);
-    void strip_funs_and_classes(void);
+
+    /// @brief Get a view of `module` for an `almost` import. It shares
+    /// the module's variables, enums and imports but not its functions
+    /// or classes.
+    static std::shared_ptr<WorldCtx> without_funs_and_classes(std::shared_ptr<Ctx> module);
+
+    /// @brief Get the evaluated module for the canonical path `path`, or
+    /// nullptr if it has not been imported by this process yet.
+    static std::shared_ptr<Ctx> module_cache_get(const std::string &path);
+    static void module_cache_add(const std::string &path, std::shared_ptr<Ctx> ctx);
+    static void module_cache_clear(void);
 
     CtxType type(void) const override;
     void push_scope(void) override;
@@ -110,6 +120,7 @@ struct WorldCtx : public Ctx {
     // REPL
     void add_repl_lexer(std::unique_ptr<Lexer> lexer);
     void add_repl_program(std::unique_ptr<Program> program);
+    void pop_repl_program(void);
     Program *get_repl_program(size_t i);
     size_t get_repl_programs_len(void) const;
 
@@ -122,6 +133,9 @@ private:
     std::unordered_map<std::string, std::shared_ptr<earl::value::Enum>> m_enums;
     std::string m_filepath;
 
+    // Keeps the module a view was made from (and its source) alive.
+    std::shared_ptr<Ctx> m_source = nullptr;
+
     // REPL
     std::vector<std::unique_ptr<Lexer>> m_repl_lexers;
     std::vector<std::unique_ptr<Program>> m_repl_programs;
@@ -131,6 +145,14 @@ struct FunctionCtx : public Ctx {
     FunctionCtx(std::shared_ptr<Ctx> owner, uint32_t attrs);
     ~FunctionCtx() = default;
 
+    /// @brief Get a context for a call from `owner`, reusing the
+    /// frame of a finished call when one is available.
+    static std::shared_ptr<FunctionCtx> acquire(std::shared_ptr<Ctx> owner, uint32_t attrs);
+    /// @brief Hand `ctx` back once its call has returned. It is only
+    /// kept for reuse when nothing else (a closure, an instance, ...)
+    /// still holds on to it.
+    static void release(std::shared_ptr<FunctionCtx> &ctx);
+
     bool in_class(void) const;
     std::shared_ptr<Ctx> &get_outer_class_owner_ctx(void);
     std::shared_ptr<Ctx> &get_owner(void);
@@ -156,12 +178,26 @@ struct FunctionCtx : public Ctx {
     void set_curfunc(const std::string &id);
     const std::string &get_curfuncid(void);
 
+    /// @brief Size the slot frame for the resolved function `def`.
+    void set_frame(StmtDef *def);
+    void slot_set(const Slot &slot, const std::shared_ptr<earl::variable::Obj> &var);
+    /// @brief Get the variable in `slot`, or nullptr if it is
+    /// not bound in this frame (the caller falls back to `variable_get`).
+    std::shared_ptr<earl::variable::Obj> slot_get(const Slot &slot);
+
 private:
+    void set_owner(std::shared_ptr<Ctx> owner, uint32_t attrs);
+
     std::shared_ptr<Ctx> m_owner; // The MAIN owner
     std::shared_ptr<Ctx> m_immediate_owner;
     uint32_t m_attrs;
-    bool m_in_rec;
+    bool m_in_rec = false;
     std::string m_curfunc_id;
+
+    // Weak so that a slot never keeps a variable alive after
+    // its scope has been popped.
+    StmtDef *m_frame = nullptr;
+    std::vector<std::weak_ptr<earl::variable::Obj>> m_slots;
 };
 
 struct ClassCtx : public Ctx {
@@ -25,14 +25,19 @@
 #ifndef EARL_H
 #define EARL_H
 
+#include <cstdint>
+#include <deque>
 #include <memory>
 #include <unordered_map>
 #include <string>
+#include <string_view>
+#include <variant>
 #include <vector>
 #include <fstream>
 
 #include "ast.hpp"
 #include "token.hpp"
+#include "flat-map.hpp"
 
 #define ASSERT_BINOP_COMPAT(obj0, obj1, op)                             \
     do {                                                                \
@@ -65,6 +70,9 @@
 
 struct Ctx;
 struct FunctionCtx;
+struct WorldCtx;
+
+namespace VM {struct Chunk;}
 
 namespace earl {
     namespace variable {struct Obj;}
@@ -124,6 +132,13 @@ namespace earl {
             DictStr,
             DictFloat,
             DictChar,
+            DictTuple,
+            /** EARL set type */
+            Set,
+            /** EARL double-ended queue type */
+            Deque,
+            /** EARL binary heap (priority queue) type */
+            Heap,
             /** EARL type keyword */
             TypeKW,
             /** EARL continue keyword */
@@ -264,6 +279,10 @@ namespace earl {
         struct Bool : public Obj {
             Bool(bool value = false);
 
+            /// @brief Fill the underlying data with some data
+            /// @param value The value to use to fill
+            void fill(bool value);
+
             /// @brief Get the underlying integer value
             bool value(void);
 
@@ -283,10 +302,20 @@ namespace earl {
             bool m_value;
         };
 
+        struct Str;
+
         struct Char : public Obj {
             // Char(std::string value = "");
             Char(char value = '\0');
 
+            /// @brief A char that reads from and writes through to
+            /// `str[idx]`, made by indexing into a str.
+            Char(std::shared_ptr<Str> str, size_t idx);
+
+            /// @brief Fill the underlying data with some data
+            /// @param value The value to use to fill
+            void fill(char value);
+
             /// @brief Get the underlying string value
             char value(void);
 
@@ -304,8 +333,69 @@ namespace earl {
 
         private:
             char m_value;
+
+            /// @brief The str this char is a view into (if any)
+            std::shared_ptr<Str> m_str;
+            size_t m_idx;
         };
 
+        /// @brief An unboxed int, float, bool or char. Scalar
+        /// expressions are evaluated with these so that only the
+        /// final result (if anything) needs to be allocated as an `Obj`.
+        struct Scalar {
+            enum class Tag : uint8_t {
+                None = 0,
+                Int,
+                Float,
+                Bool,
+                Char,
+            };
+
+            Tag tag;
+            union {
+                int i;
+                double f;
+                bool b;
+                char c;
+            };
+
+            Scalar() : tag(Tag::None), f(0) {}
+
+            static Scalar of_int(int value);
+            static Scalar of_float(double value);
+            static Scalar of_bool(bool value);
+            static Scalar of_char(char value);
+
+            /// @brief Adapter from a boxed value
+            /// @return A scalar with `Tag::None` if `value` is not a scalar type
+            static Scalar unbox(Obj *value);
+
+            /// @brief Adapter back to a newly allocated boxed value
+            std::shared_ptr<Obj> box(void) const;
+
+            /// @brief Write into `dst` in place when it is an unshared,
+            /// non-const value of the same type, otherwise box into it.
+            void store(std::shared_ptr<Obj> &dst) const;
+
+            /// @brief Mirrors `Obj::boolean`
+            /// @return false if the type has no truthiness (char)
+            bool truthy(bool &out) const;
+        };
+
+        /// @brief Mirrors `Obj::binop` on two scalars.
+        /// @return false if the operation is not supported for the
+        /// given types (or would error/trap), in which case the caller
+        /// must fall back to the boxed path which reports the error.
+        bool scalar_binop(TokenType op, const Scalar &lhs, const Scalar &rhs, Scalar &out);
+
+        /// @brief Mirrors `Obj::unaryop` on a scalar. Same fallback rule as `scalar_binop`.
+        bool scalar_unaryop(TokenType op, const Scalar &value, Scalar &out);
+
+        /// @brief Mirrors `Obj::mutate` (for `=`) and `Obj::spec_mutate`
+        /// (for the compound operators) of `dst` in place.
+        /// @return false if nothing was written and the boxed path must be taken
+        bool scalar_mutate(Obj *dst, TokenType op, const Scalar &value);
+
         /// @brief The structure that represents EARL UNITs
         struct Void : public Obj {
             Void(void *value = nullptr);
@@ -366,11 +456,39 @@ namespace earl {
             /// @param value The value to use to fill
             void fill(std::vector<std::shared_ptr<Obj>> &value);
 
-            /// @brief Get the underlying list value
+            /// @brief Get the underlying list value for changing it
+            /// @note This gives the list its own copy of the elements first
+            /// if it still shares them with a copy of it. Readers should use
+            /// `size` and `elem_value` instead.
             std::vector<std::shared_ptr<Obj>> &value(void);
 
-            /// @brief Get a sublist of the vector from `start` to `finish`
-            std::vector<std::shared_ptr<Obj>> slice(std::shared_ptr<Obj> &start, std::shared_ptr<Obj> &end, Expr *expr);
+            /// @brief Get the number of elements without detaching
+            size_t size(void) const;
+
+            /// @brief Whether the elements are stored unboxed
+            bool packed(void) const;
+
+            /// @brief Read element `idx` without boxing it or unpacking the list
+            /// @return false if `idx` is out of range or the element is not a scalar
+            bool scalar_at(int idx, Scalar &out) const;
+
+            /// @brief Get element `idx` for reading. A packed list hands out a
+            /// new value, so it must not be used to change the element.
+            std::shared_ptr<Obj> elem_value(size_t idx) const;
+
+            /// @brief Get element `idx` for changing it in place, i.e., for
+            /// `@ref`. The list gets its own elements first, like `value`.
+            std::shared_ptr<Obj> elem_ref(size_t idx);
+
+            /// @brief Like `nth`, but for reading only (see `elem_value`)
+            std::shared_ptr<Obj> nth_value(std::shared_ptr<Obj> &idx, Expr *expr);
+
+            /// @brief Append an unboxed value, the list stays packed if it can
+            void append_scalar(const Scalar &value);
+
+            /// @brief Get the sublist from `start` to `end`. It shares the
+            /// elements with this list until either of them is changed.
+            std::shared_ptr<List> slice(std::shared_ptr<Obj> &start, std::shared_ptr<Obj> &end, Expr *expr);
 
             /// @brief Get the `nth` element from the list
             /// @note This is called from the intrinsic `nth` member function
@@ -404,6 +522,23 @@ namespace earl {
 
             std::shared_ptr<Bool> contains(std::shared_ptr<earl::value::Obj> &value);
 
+            std::shared_ptr<Obj> sum(Expr *expr);
+
+            /// @brief Get the smallest/largest element, or `none` if the list is empty
+            std::shared_ptr<Obj> min(Expr *expr);
+            std::shared_ptr<Obj> max(Expr *expr);
+
+            /// @brief Get the index of the first element that is `==` to
+            /// `value` in a `some` value, or `none` if it is not found.
+            std::shared_ptr<Obj> index_of(std::shared_ptr<Obj> &value);
+
+            /// @brief Sort the list in place, keeping equal elements in order
+            void sort(Expr *expr);
+
+            /// @brief Sort the list in place by a key closure `|x| ...` or by a
+            /// comparator closure `|a, b| ...` that returns true if `a` goes first
+            void sort_by(std::shared_ptr<Obj> &closure, std::shared_ptr<Ctx> &ctx, Expr *expr);
+
             /*** OVERRIDES ***/
             Type type(void) const                                                         override;
             std::shared_ptr<Obj> binop(Token *op, std::shared_ptr<Obj> &other)            override;
@@ -417,7 +552,71 @@ namespace earl {
             void set_const(void)                                                          override;
 
         private:
-            std::vector<std::shared_ptr<Obj>> m_value;
+            /// @brief The elements of a list made only of ints, only of floats
+            /// or only of chars, stored unboxed. Only the vector for `type` is used.
+            struct Packed {
+                Type type;
+                std::vector<int> ints;
+                std::vector<double> floats;
+                std::vector<char> chars;
+
+                size_t size(void) const;
+            };
+
+            /// @brief Give a slice its own elements, i.e., before it is changed.
+            void materialize(void);
+
+            /// @brief Stop sharing elements with copies of this list.
+            void detach(void);
+
+            /// @brief Get the boxed elements to change them. Unlike
+            /// `value` nothing is handed out, so copies can still share them.
+            std::vector<std::shared_ptr<Obj>> &elems(void);
+
+            /// @brief Remember that `elem` may now be changed from outside
+            /// of the list.
+            void lend(const std::shared_ptr<Obj> &elem);
+
+            /// @brief Whether an element handed out by `elem_ref` or `value`
+            /// may still be changed from outside of the list.
+            bool lent(void);
+
+            /// @brief Go back to boxed elements, i.e., before handing
+            /// out a reference to one of them.
+            void unpack(void);
+
+            /// @brief Append `value` unboxed if the list is packed with
+            /// its type, or is empty. Returns false if it cannot be.
+            bool packed_append(const Scalar &value);
+
+            /// @brief Append all elements of `other`
+            void extend(List &other);
+
+            /// @brief Find `value` among the packed elements
+            size_t packed_index_of(Obj *value) const;
+
+            // Shared between a list and its copies until
+            // one of them is accessed or changed.
+            std::shared_ptr<std::vector<std::shared_ptr<Obj>>> m_value;
+
+            // Set instead of `m_value` while the list is packed,
+            // shared with copies the same way.
+            std::shared_ptr<Packed> m_packed;
+
+            // A slice only sees the `m_len` elements starting at `m_off`
+            // of the storage above, which it shares with the list it was
+            // taken from. `m_off` is 0 for any other list.
+            bool m_view = false;
+            size_t m_off = 0;
+            size_t m_len = 0;
+
+            // The elements handed out for changing them. A copy can only
+            // share the elements once nothing else refers to these, which
+            // is checked when it is made instead of looking at every
+            // element. `m_lent_all` is set once `value` handed out all of them.
+            std::vector<std::weak_ptr<Obj>> m_lent;
+            size_t m_lent_cap = 16;
+            bool m_lent_all = false;
         };
 
         struct Slice : public Obj {
@@ -446,7 +645,16 @@ namespace earl {
         struct Tuple : public Obj {
             Tuple(std::vector<std::shared_ptr<Obj>> values = {});
 
+            /// @brief Get the underlying elements
+            /// @note A slice of a tuple gets its own vector of them first.
+            /// Readers should use `size` and `at` instead.
             std::vector<std::shared_ptr<Obj>> &value(void);
+
+            /// @brief Get the number of elements
+            size_t size(void) const;
+
+            /// @brief Get element `idx` without flattening a slice
+            std::shared_ptr<Obj> &at(size_t idx);
             std::shared_ptr<Obj> nth(std::shared_ptr<Obj> &idx, Expr *expr);
             std::shared_ptr<Obj> back(void);
             std::shared_ptr<Tuple> filter(std::shared_ptr<Obj> &closure, std::shared_ptr<Ctx> &ctx);
@@ -467,20 +675,48 @@ namespace earl {
             void set_const(void)                                                          override;
 
         private:
-            std::vector<std::shared_ptr<Obj>> m_values;
+            // The `m_len` elements of `m_values` from `m_off`. Tuples
+            // cannot be changed, so a slice shares the vector with the
+            // tuple it was taken from.
+            std::shared_ptr<std::vector<std::shared_ptr<Obj>>> m_values;
+            size_t m_off = 0;
+            size_t m_len = 0;
         };
 
         /// @brief The structure that represents EARL strings
-        struct Str : public Obj {
+        /// @brief A str is stored as a plain `std::string` (which keeps
+        /// short strings inline). Indexing into one hands out a `Char`
+        /// that refers back to it, so the string must always be owned
+        /// by a `shared_ptr`.
+        struct Str : public Obj, public std::enable_shared_from_this<Str> {
             Str(std::string value = "");
-            Str(std::vector<std::shared_ptr<Char>> chars);
 
-            std::string value(void); // NOTE: needs optimization
-            std::vector<std::shared_ptr<Char>> value_as_earlchar(void);
+            /// @brief Get the underlying string without copying it.
+            /// This flattens the str if its buffer has been appended
+            /// past its end by a str made from it.
+            const std::string &value(void);
+
+            /// @brief Get a non-owning view of the chars. It is only
+            /// valid until this str, or one sharing its buffer, is next changed.
+            std::string_view view(void) const;
+
+            /// @brief Get the number of chars
+            size_t size(void) const;
+
+            /// @brief Get the char at `idx`, used by the proxy chars
+            char at(size_t idx) const;
+
+            /// @brief Set the char at `idx`, used by the proxy chars
+            void set(size_t idx, char c);
+
             std::shared_ptr<Char> __get_elem(size_t idx);
             std::shared_ptr<Char> nth(std::shared_ptr<Obj> &idx, Expr *expr);
             std::shared_ptr<List> split(std::shared_ptr<Obj> &delim, Expr *expr);
             std::shared_ptr<Str> substr(std::shared_ptr<Obj> &idx1, std::shared_ptr<Obj> &idx2, Expr *expr);
+
+            /// @brief Get the chars from `start` to `end` (`s[start:end]`). Like
+            /// `substr`, the result shares the buffer until either str is changed.
+            std::shared_ptr<Str> slice(std::shared_ptr<Obj> &start, std::shared_ptr<Obj> &end, Expr *expr);
             void pop(std::shared_ptr<Obj> &idx, Expr *expr);
             std::shared_ptr<Obj> back(void);
             std::shared_ptr<Str> rev(void);
@@ -491,7 +727,16 @@ namespace earl {
             std::shared_ptr<Str> filter(std::shared_ptr<Obj> &closure, std::shared_ptr<Ctx> &ctx);
             void foreach(std::shared_ptr<Obj> &closure, std::shared_ptr<Ctx> &ctx);
             void trim(void);
-            std::shared_ptr<Bool> contains(std::shared_ptr<Char> &value);
+            std::shared_ptr<Bool> contains(std::shared_ptr<Obj> &value, Expr *expr);
+
+            /// @brief Search for a str or char, returning `some(index)` or `none`
+            std::shared_ptr<Obj> find(std::shared_ptr<Obj> &value, Expr *expr);
+            std::shared_ptr<Obj> rfind(std::shared_ptr<Obj> &value, Expr *expr);
+
+            std::shared_ptr<Int> count(std::shared_ptr<Obj> &value, Expr *expr);
+            std::shared_ptr<Str> replace(std::shared_ptr<Obj> &from, std::shared_ptr<Obj> &to, Expr *expr);
+            std::shared_ptr<Bool> starts_with(std::shared_ptr<Obj> &value, Expr *expr);
+            std::shared_ptr<Bool> ends_with(std::shared_ptr<Obj> &value, Expr *expr);
 
             /*** OVERRIDES ***/
             Type type(void) const                                                         override;
@@ -504,12 +749,32 @@ namespace earl {
             void spec_mutate(Token *op, const std::shared_ptr<Obj> &other, StmtMut *stmt) override;
             std::shared_ptr<Obj> unaryop(Token *op)                                       override;
             void set_const(void)                                                          override;
-            void update_changed(void);
 
         private:
-            std::string m_value;
-            std::vector<std::shared_ptr<Char>> m_chars;
-            std::vector<unsigned> m_changed;
+            Str(std::shared_ptr<std::string> buf, size_t off, size_t len);
+
+            /// @brief Get a str with the `len` chars from `off`. It shares the
+            /// buffer with this str, unless they are few enough to copy.
+            std::shared_ptr<Str> share(size_t off, size_t len);
+
+            /// @brief Go back to the inline chars so they can be changed in place.
+            void detach(void);
+
+            /// @brief Append to the end of the chars. A shared buffer is
+            /// appended to in place when no other str has already appended
+            /// past the end of this one.
+            void extend(std::string_view value);
+
+            // The chars, unless `m_buf` is set.
+            std::string m_str;
+
+            // Otherwise the `m_len` chars of the buffer from `m_off` belong to
+            // this str. The buffer is shared with copies of this str, with strs
+            // made by appending to it (`s + t`), so growing a str one piece at a
+            // time does not copy it each time, and with substrs and slices of it.
+            std::shared_ptr<std::string> m_buf;
+            size_t m_off = 0;
+            size_t m_len = 0;
         };
 
         struct Module : public Obj {
@@ -577,6 +842,39 @@ namespace earl {
             std::vector<Token *> m_member_assignees;
         };
 
+        /// @brief A hashable snapshot of a tuple (or of a single int, float,
+        /// bool, char or str), used as the key of `DictTuple` dictionaries
+        /// and sets. Tuple elements may be of mixed types, including nested
+        /// tuples. The hash is computed once when the key is built.
+        struct DictKey {
+            /// @brief Build a key out of `value`
+            /// @return false if `value` holds something that cannot be hashed
+            static bool from(Obj *value, DictKey &out);
+
+            uint64_t hash(void) const;
+
+            /// @brief Build a new EARL value equal to the one the key was made from
+            std::shared_ptr<Obj> value(void) const;
+
+            bool operator==(const DictKey &other) const;
+
+        private:
+            struct Part {
+                Type type;
+                /// @brief The value of an int/float/bool/char, or the arity of a tuple
+                int64_t bits;
+                std::string str;
+
+                bool operator==(const Part &other) const;
+            };
+
+            static bool flatten(Obj *value, std::vector<Part> &parts);
+            static std::shared_ptr<Obj> build(const std::vector<Part> &parts, size_t &i);
+
+            std::vector<Part> m_parts;
+            uint64_t m_hash = 0;
+        };
+
         template <typename T>
         struct Dict : public Obj {
             Dict(Type kty);
@@ -584,8 +882,8 @@ namespace earl {
             void insert(T key, std::shared_ptr<Obj> value);
             Type ktype(void) const;
             std::shared_ptr<Obj> nth(std::shared_ptr<Obj> &key, Expr *expr);
-            std::unordered_map<T, std::shared_ptr<Obj>> &extract(void);
-            bool has_key(T key) const;
+            FlatMap<T, std::shared_ptr<Obj>> &extract(void);
+            bool has_key(const T &key) const;
             bool has_value(std::shared_ptr<Obj> &value) const;
 
             /*** OVERRIDES ***/
@@ -601,10 +899,146 @@ namespace earl {
             void set_const(void)                                                          override;
 
         private:
-            std::unordered_map<T, std::shared_ptr<Obj>> m_map;
+            FlatMap<T, std::shared_ptr<Obj>> m_map;
             Type m_kty;
         };
 
+        /// @brief The structure that represents EARL sets. All elements
+        /// have the type of the first one inserted and are kept unboxed in
+        /// a hash table picked for that type. Elements are visited in
+        /// insertion order, except that `remove` moves the last element
+        /// into the removed one's place.
+        struct Set : public Obj {
+            Set();
+
+            /// @brief Get the type of the elements
+            /// @return `Type::Void` if nothing has been inserted yet
+            Type etype(void) const;
+            size_t size(void) const;
+
+            /// @brief Get a new value equal to the `i`th element in iteration order
+            std::shared_ptr<Obj> elem(size_t i) const;
+
+            void insert(std::shared_ptr<Obj> &value, Expr *expr);
+            std::shared_ptr<Bool> remove(std::shared_ptr<Obj> &value);
+            std::shared_ptr<Bool> contains(std::shared_ptr<Obj> &value) const;
+            std::shared_ptr<Set> set_union(Set *other, Expr *expr);
+            std::shared_ptr<Set> intersection(Set *other, Expr *expr);
+            std::shared_ptr<Set> difference(Set *other, Expr *expr);
+
+            /*** OVERRIDES ***/
+            Type type(void) const                                                         override;
+            std::shared_ptr<Obj> binop(Token *op, std::shared_ptr<Obj> &other)            override;
+            bool boolean(void)                                                            override;
+            void mutate(const std::shared_ptr<Obj> &other, StmtMut *stmt)                 override;
+            std::shared_ptr<Obj> copy(void)                                               override;
+            bool eq(std::shared_ptr<Obj> &other)                                          override;
+            std::string to_cxxstring(void)                                                override;
+            void spec_mutate(Token *op, const std::shared_ptr<Obj> &other, StmtMut *stmt) override;
+            std::shared_ptr<Obj> unaryop(Token *op)                                       override;
+            void set_const(void)                                                          override;
+
+        private:
+            /// @brief One table per element type. Bools and tuples use `DictKey`.
+            using Items = std::variant<std::monostate,
+                                       FlatMap<int, bool>,
+                                       FlatMap<double, bool>,
+                                       FlatMap<char, bool>,
+                                       FlatMap<std::string, bool>,
+                                       FlatMap<DictKey, bool>>;
+
+            /// @brief Make sure values of type `ty` can be put in THIS set,
+            /// adopting `ty` as the element type if there is none yet
+            void unify(Type ty, Expr *expr);
+
+            Type m_etype;
+            Items m_items;
+        };
+
+        /// @brief The structure that represents EARL deques. Pushing and
+        /// popping at either end is O(1).
+        struct Deque : public Obj {
+            Deque(std::deque<std::shared_ptr<Obj>> values = {});
+
+            std::deque<std::shared_ptr<Obj>> &value(void);
+            size_t size(void) const;
+            void push_back(std::shared_ptr<Obj> value);
+            void push_front(std::shared_ptr<Obj> value);
+
+            /// @return The removed value, or none if the deque is empty
+            std::shared_ptr<Obj> pop_back(void);
+            std::shared_ptr<Obj> pop_front(void);
+
+            /// @return A copy of the value at that end, or none if the deque is empty
+            std::shared_ptr<Obj> back(void);
+            std::shared_ptr<Obj> front(void);
+
+            /*** OVERRIDES ***/
+            Type type(void) const                                                         override;
+            std::shared_ptr<Obj> binop(Token *op, std::shared_ptr<Obj> &other)            override;
+            bool boolean(void)                                                            override;
+            void mutate(const std::shared_ptr<Obj> &other, StmtMut *stmt)                 override;
+            std::shared_ptr<Obj> copy(void)                                               override;
+            bool eq(std::shared_ptr<Obj> &other)                                          override;
+            std::string to_cxxstring(void)                                                override;
+            void spec_mutate(Token *op, const std::shared_ptr<Obj> &other, StmtMut *stmt) override;
+            std::shared_ptr<Obj> unaryop(Token *op)                                       override;
+            void set_const(void)                                                          override;
+
+        private:
+            std::deque<std::shared_ptr<Obj>> m_values;
+        };
+
+        /// @brief The structure that represents EARL binary heaps (priority
+        /// queues). The smallest value comes out first. Values are ordered
+        /// with `order`, by a key that a closure `|x| ...` computes once per
+        /// value, or by a comparator closure `|a, b| ...` that returns true
+        /// when `a` should come out before `b`.
+        struct Heap : public Obj {
+            /// @param f A key or comparator closure, or nullptr
+            Heap(std::shared_ptr<Obj> f = nullptr);
+
+            size_t size(void) const;
+            void push(std::shared_ptr<Obj> value, std::shared_ptr<Ctx> &ctx, Expr *expr);
+
+            /// @brief Push all of `values` and then restore the heap in O(n)
+            void extend(const std::vector<std::shared_ptr<Obj>> &values, std::shared_ptr<Ctx> &ctx, Expr *expr);
+
+            /// @return The removed smallest value, or none if the heap is empty
+            std::shared_ptr<Obj> pop(std::shared_ptr<Ctx> &ctx, Expr *expr);
+
+            /// @return A copy of the smallest value, or none if the heap is empty
+            std::shared_ptr<Obj> peek(void);
+
+            /*** OVERRIDES ***/
+            Type type(void) const                                                         override;
+            std::shared_ptr<Obj> binop(Token *op, std::shared_ptr<Obj> &other)            override;
+            bool boolean(void)                                                            override;
+            void mutate(const std::shared_ptr<Obj> &other, StmtMut *stmt)                 override;
+            std::shared_ptr<Obj> copy(void)                                               override;
+            bool eq(std::shared_ptr<Obj> &other)                                          override;
+            std::string to_cxxstring(void)                                                override;
+            void spec_mutate(Token *op, const std::shared_ptr<Obj> &other, StmtMut *stmt) override;
+            std::shared_ptr<Obj> unaryop(Token *op)                                       override;
+            void set_const(void)                                                          override;
+
+        private:
+            struct Entry {
+                /// @brief What the entry is ordered by (the value itself without a key closure)
+                std::shared_ptr<Obj> key;
+                std::shared_ptr<Obj> value;
+            };
+
+            Entry make_entry(std::shared_ptr<Obj> value, std::shared_ptr<Ctx> &ctx, Expr *expr);
+            bool before(const Entry &a, const Entry &b, std::shared_ptr<Ctx> &ctx, Expr *expr);
+            void sift_up(size_t i, std::shared_ptr<Ctx> &ctx, Expr *expr);
+            void sift_down(size_t i, std::shared_ptr<Ctx> &ctx, Expr *expr);
+
+            std::vector<Entry> m_entries;
+            std::shared_ptr<Obj> m_f;
+            bool m_comparator;
+        };
+
         struct Enum : public Obj {
             Enum(StmtEnum *stmt,
                  std::unordered_map<std::string, std::shared_ptr<variable::Obj>> elems,
@@ -762,6 +1196,14 @@ namespace earl {
         [[nodiscard]]
         bool type_is_compatable(const Obj *const obj1, const Obj *const obj2);
 
+        /// @brief Order two values without going through `binop`. Ints and
+        /// floats compare by value, chars, strs and bools by their natural
+        /// order, and tuples element by element.
+        /// @param out Set to less than, equal to or greater than 0
+        /// @return false if the values cannot be ordered against each other
+        [[nodiscard]]
+        bool order(Obj *a, Obj *b, int &out);
+
         bool is_typekw(const std::string &id);
         Type get_typekw_proper(const std::string &id);
 
@@ -826,10 +1268,20 @@ namespace earl {
             bool param_at_is_ref(size_t i) const;
             uint32_t attrs(void) const;
 
+            /// @brief Get the parameters with their attributes
+            const std::vector<std::pair<Token *, uint32_t>> &params(void) const;
+
+            /// @brief Get the compiled VM chunk of this function.
+            /// Compiles it the first time it is requested.
+            /// @return The chunk, or nullptr if it cannot be compiled
+            VM::Chunk *chunk(WorldCtx *world);
+
         private:
             StmtDef *m_stmtdef;
             std::vector<std::pair<Token *, uint32_t>> m_params;
             Token *m_tok;
+            std::shared_ptr<VM::Chunk> m_chunk;
+            bool m_compiled;
         };
     };
 };
@@ -846,7 +1298,7 @@ template <typename T> earl::value::Dict<T>::Dict::Dict(earl::value::Type kty) {
 
 template <typename T> void
 earl::value::Dict<T>::insert(T key, std::shared_ptr<earl::value::Obj> value) {
-    m_map[key] = value;
+    m_map.insert_or_assign(std::move(key), std::move(value));
 }
 
 template <typename T> earl::value::Type
@@ -864,9 +1316,9 @@ earl::value::Dict<T>::nth(std::shared_ptr<earl::value::Obj> &key, Expr *expr) {
         }
         int k = dynamic_cast<earl::value::Int *>(key.get())->value();
         auto value = m_map.find(k);
-        if (value == m_map.end())
+        if (!value)
             return std::make_shared<earl::value::Option>();
-        return std::make_shared<earl::value::Option>(value->second);
+        return std::make_shared<earl::value::Option>(*value);
     }
     else if constexpr (std::is_same_v<T, std::string>) {
         if (key->type() != earl::value::Type::Str) {
@@ -874,11 +1326,11 @@ earl::value::Dict<T>::nth(std::shared_ptr<earl::value::Obj> &key, Expr *expr) {
             const std::string msg = "key must be of type str";
             throw InterpreterException(msg);
         }
-        std::string k = dynamic_cast<earl::value::Str *>(key.get())->value();
+        std::string_view k = dynamic_cast<earl::value::Str *>(key.get())->view();
         auto value = m_map.find(k);
-        if (value == m_map.end())
+        if (!value)
             return std::make_shared<earl::value::Option>();
-        return std::make_shared<earl::value::Option>(value->second);
+        return std::make_shared<earl::value::Option>(*value);
     }
     else if constexpr (std::is_same_v<T, double>) {
         if (key->type() != earl::value::Type::Float) {
@@ -888,9 +1340,9 @@ earl::value::Dict<T>::nth(std::shared_ptr<earl::value::Obj> &key, Expr *expr) {
         }
         double k = dynamic_cast<earl::value::Float *>(key.get())->value();
         auto value = m_map.find(k);
-        if (value == m_map.end())
+        if (!value)
             return std::make_shared<earl::value::Option>();
-        return std::make_shared<earl::value::Option>(value->second);
+        return std::make_shared<earl::value::Option>(*value);
     }
     else if constexpr (std::is_same_v<T, char>) {
         if (key->type() != earl::value::Type::Char) {
@@ -900,22 +1352,34 @@ earl::value::Dict<T>::nth(std::shared_ptr<earl::value::Obj> &key, Expr *expr) {
         }
         char k = dynamic_cast<earl::value::Char *>(key.get())->value();
         auto value = m_map.find(k);
-        if (value == m_map.end())
+        if (!value)
+            return std::make_shared<earl::value::Option>();
+        return std::make_shared<earl::value::Option>(*value);
+    }
+    else if constexpr (std::is_same_v<T, earl::value::DictKey>) {
+        earl::value::DictKey k;
+        if (key->type() != earl::value::Type::Tuple || !earl::value::DictKey::from(key.get(), k)) {
+            Err::err_wexpr(expr);
+            const std::string msg = "key must be a tuple of int, float, bool, char, str or tuple values";
+            throw InterpreterException(msg);
+        }
+        auto value = m_map.find(k);
+        if (!value)
             return std::make_shared<earl::value::Option>();
-        return std::make_shared<earl::value::Option>(value->second);
+        return std::make_shared<earl::value::Option>(*value);
     }
     assert(false && "unreachable");
     return nullptr; // unreachable
 }
 
-template <typename T> std::unordered_map<T, std::shared_ptr<earl::value::Obj>> &
+template <typename T> FlatMap<T, std::shared_ptr<earl::value::Obj>> &
 earl::value::Dict<T>::extract(void) {
     return m_map;
 }
 
 template <typename T> bool
-earl::value::Dict<T>::has_key(T key) const {
-    return m_map.find(key) != m_map.end();
+earl::value::Dict<T>::has_key(const T &key) const {
+    return m_map.contains(key);
 }
 
 template <typename T> bool
@@ -934,6 +1398,7 @@ earl::value::Dict<T>::type(void) const {
     case earl::value::Type::Str: return Type::DictStr;
     case earl::value::Type::Char: return Type::DictChar;
     case earl::value::Type::Float: return Type::DictFloat;
+    case earl::value::Type::Tuple: return Type::DictTuple;
     default: assert(false && "unreachable"); break;
     }
     return (earl::value::Type)0; // unreachable
@@ -957,6 +1422,7 @@ earl::value::Dict<T>::mutate(const std::shared_ptr<earl::value::Obj> &other, Stm
 template <typename T> std::shared_ptr<earl::value::Obj>
 earl::value::Dict<T>::copy(void) {
     auto new_dict = std::make_shared<Dict<T>>(m_kty);
+    new_dict->extract().reserve(m_map.size());
     for (auto &pair : m_map)
         new_dict->insert(pair.first, pair.second->copy());
     return new_dict;
@@ -970,8 +1436,8 @@ earl::value::Dict<T>::eq(std::shared_ptr<earl::value::Obj> &other) {
 template <typename T> std::string
 earl::value::Dict<T>::to_cxxstring(void) {
     std::string res = "<" + earl::value::type_to_str(this->type()) + " { ";
-    auto map = this->extract();
-    int i = 0;
+    auto &map = this->extract();
+    size_t i = 0;
     for (auto it = map.begin(); it != map.end(); ++it) {
         using Tx = std::decay_t<T>;
         if constexpr (std::is_same_v<Tx, int>)
@@ -982,6 +1448,8 @@ earl::value::Dict<T>::to_cxxstring(void) {
             res += std::string(1, it->first);
         else if constexpr (std::is_same_v<Tx, std::string>)
             res += it->first;
+        else if constexpr (std::is_same_v<Tx, earl::value::DictKey>)
+            res += it->first.value()->to_cxxstring();
         else
             res += it->first;
         res += ": ";
@@ -0,0 +1,54 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef EARLC_H
+#define EARLC_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "lexer.hpp"
+
+/// @brief On-disk cache of lexed modules (`.earlc` files).
+///
+/// Each entry holds the token stream of one source file and is
+/// keyed by a hash of its contents, the keyword set, the
+/// interpreter version and the cache format (`EARLC_FORMAT`).
+/// It is only used with `--cache`: decoding an entry costs about
+/// as much as lexing the file, so ordinary runs never touch the
+/// disk. Entries live in `$XDG_CACHE_HOME/earl` or `~/.cache/earl`,
+/// trimmed to the `EARLC_MAX_ENTRIES` most recently used.
+namespace earlc {
+    /// @brief The same as `lex_file` except the tokens are loaded
+    /// from the cache when possible and stored in it otherwise.
+    std::unique_ptr<Lexer>
+    lex(std::string &src_code,
+        std::string fp,
+        std::vector<std::string> &keywords,
+        std::vector<std::string> &types,
+        std::string &comment);
+};
+
+#endif // EARLC_H
@@ -0,0 +1,296 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef FLAT_MAP_H
+#define FLAT_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/// @brief The hashes used by `FlatMap`. Scalars are run through a
+/// 64-bit finalizer so that the low bits (the table position) and the
+/// high bits (the control tag) are both well mixed. Key types that
+/// already carry their own hash provide a `hash()` method.
+struct FlatHash {
+    static uint64_t mix(uint64_t x) {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ULL;
+        x ^= x >> 33;
+        return x;
+    }
+
+    uint64_t operator()(int x) const  { return mix(static_cast<uint32_t>(x)); }
+    uint64_t operator()(char x) const { return mix(static_cast<uint8_t>(x)); }
+
+    uint64_t operator()(double x) const {
+        if (x == 0.0)
+            x = 0.0; // -0.0 == 0.0
+        uint64_t bits;
+        std::memcpy(&bits, &x, sizeof bits);
+        return mix(bits);
+    }
+
+    uint64_t operator()(std::string_view x) const {
+        return mix(std::hash<std::string_view>{}(x));
+    }
+
+    template <typename K>
+    auto operator()(const K &x) const -> decltype(x.hash()) {
+        return x.hash();
+    }
+};
+
+/// @brief An insertion-ordered, open-addressing hash map.
+///
+/// Entries are stored contiguously in the order they were inserted and
+/// iterating over the map walks that array (`swap_erase` moves the last
+/// entry into the hole it leaves). The lookup table is a
+/// Swiss-table style array of one-byte control tags (7 bits of the hash,
+/// or `EMPTY`) next to an array of entry indices. It is probed one
+/// 16-slot group at a time (one SSE2 compare when available). The full hash
+/// of each entry is kept so keys are compared only on a full hash match
+/// and growing the table never hashes a key again.
+///
+/// Erased slots are left as tombstones until the next rehash.
+template <typename K, typename V, typename Hash = FlatHash>
+class FlatMap {
+public:
+    using key_type = K;
+    using Entry = std::pair<K, V>;
+    using iterator = typename std::vector<Entry>::iterator;
+    using const_iterator = typename std::vector<Entry>::const_iterator;
+
+    size_t size(void) const { return m_entries.size(); }
+    bool empty(void) const  { return m_entries.empty(); }
+
+    iterator begin(void)             { return m_entries.begin(); }
+    iterator end(void)               { return m_entries.end(); }
+    const_iterator begin(void) const { return m_entries.begin(); }
+    const_iterator end(void) const   { return m_entries.end(); }
+
+    void reserve(size_t n) {
+        m_entries.reserve(n);
+        m_hashes.reserve(n);
+        if (n > max_load(capacity()))
+            rehash(capacity_for(n));
+    }
+
+    /// @brief Look up `key`, which can be any type comparable with `K`
+    /// and accepted by `Hash` (e.g. a `std::string_view` for `std::string` keys)
+    /// @return A pointer to the value, or nullptr if it is absent
+    template <typename Q>
+    V *find(const Q &key) {
+        size_t idx = lookup(key, Hash{}(key));
+        return idx == npos ? nullptr : &m_entries[idx].second;
+    }
+
+    template <typename Q>
+    const V *find(const Q &key) const {
+        size_t idx = lookup(key, Hash{}(key));
+        return idx == npos ? nullptr : &m_entries[idx].second;
+    }
+
+    template <typename Q>
+    bool contains(const Q &key) const {
+        return lookup(key, Hash{}(key)) != npos;
+    }
+
+    /// @brief Get the value for `key`, inserting a default one at the
+    /// end of the insertion order if it is absent
+    V &operator[](K key) {
+        uint64_t h = Hash{}(key);
+        size_t idx = lookup(key, h);
+        if (idx != npos)
+            return m_entries[idx].second;
+        return emplace_new(std::move(key), h, V{});
+    }
+
+    /// @return true if `key` was not present before
+    bool insert_or_assign(K key, V value) {
+        uint64_t h = Hash{}(key);
+        size_t idx = lookup(key, h);
+        if (idx != npos) {
+            m_entries[idx].second = std::move(value);
+            return false;
+        }
+        emplace_new(std::move(key), h, std::move(value));
+        return true;
+    }
+
+    /// @brief Remove `key` in O(1) by moving the last entry into its place.
+    /// This is the only operation that changes the order of the entries.
+    /// @return true if `key` was present
+    template <typename Q>
+    bool swap_erase(const Q &key) {
+        uint64_t h = Hash{}(key);
+        size_t slot = find_slot(h, [&](uint32_t idx) { return m_entries[idx].first == key; });
+        if (slot == npos)
+            return false;
+
+        uint32_t idx = m_slots[slot];
+        m_ctrl[slot] = DELETED;
+        ++m_tombstones;
+
+        uint32_t last = static_cast<uint32_t>(m_entries.size() - 1);
+        if (idx != last) {
+            m_slots[find_slot(m_hashes[last], [&](uint32_t i) { return i == last; })] = idx;
+            m_entries[idx] = std::move(m_entries[last]);
+            m_hashes[idx] = m_hashes[last];
+        }
+        m_entries.pop_back();
+        m_hashes.pop_back();
+        return true;
+    }
+
+    void clear(void) {
+        m_entries.clear();
+        m_hashes.clear();
+        m_ctrl.assign(m_ctrl.size(), EMPTY);
+        m_tombstones = 0;
+    }
+
+private:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+    static constexpr size_t GROUP = 16;
+    static constexpr uint8_t EMPTY = 0x80;
+    static constexpr uint8_t DELETED = 0xfe;
+
+    static uint8_t tag(uint64_t h)      { return static_cast<uint8_t>(h & 0x7f); }
+    static size_t group(uint64_t h)     { return static_cast<size_t>(h >> 7); }
+    static size_t max_load(size_t cap)  { return cap - cap / 8; }
+
+    static size_t capacity_for(size_t n) {
+        size_t cap = GROUP;
+        while (max_load(cap) < n)
+            cap *= 2;
+        return cap;
+    }
+
+    /// @brief Get a bitmask of the slots in the group at `ctrl` whose tag is `t`
+    static uint32_t match(const uint8_t *ctrl, uint8_t t) {
+#if defined(__SSE2__)
+        __m128i g = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ctrl));
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_set1_epi8(static_cast<char>(t)))));
+#else
+        uint32_t mask = 0;
+        for (size_t i = 0; i < GROUP; ++i)
+            if (ctrl[i] == t)
+                mask |= 1u << i;
+        return mask;
+#endif
+    }
+
+    static unsigned lowest_bit(uint32_t mask) {
+        return static_cast<unsigned>(__builtin_ctz(mask));
+    }
+
+    size_t capacity(void) const { return m_ctrl.size(); }
+
+    /// @brief Find the slot on the probe sequence of `h` whose entry satisfies `is`
+    /// @return `npos` if there is none
+    template <typename Pred>
+    size_t find_slot(uint64_t h, Pred is) const {
+        if (m_entries.empty())
+            return npos;
+        const size_t groups_mask = capacity() / GROUP - 1;
+        const uint8_t t = tag(h);
+        size_t g = group(h) & groups_mask;
+        for (size_t step = 1; ; ++step) {
+            const uint8_t *ctrl = m_ctrl.data() + g * GROUP;
+            for (uint32_t m = match(ctrl, t); m; m &= m - 1) {
+                size_t slot = g * GROUP + lowest_bit(m);
+                uint32_t idx = m_slots[slot];
+                if (m_hashes[idx] == h && is(idx))
+                    return slot;
+            }
+            if (match(ctrl, EMPTY))
+                return npos;
+            g = (g + step) & groups_mask; // triangular probing visits every group
+        }
+    }
+
+    template <typename Q>
+    size_t lookup(const Q &key, uint64_t h) const {
+        size_t slot = find_slot(h, [&](uint32_t idx) { return m_entries[idx].first == key; });
+        return slot == npos ? npos : m_slots[slot];
+    }
+
+    /// @brief Claim the first empty slot on the probe sequence of `h`
+    /// for the entry at index `idx`. The table must have room.
+    void place(uint64_t h, uint32_t idx) {
+        const size_t groups_mask = capacity() / GROUP - 1;
+        size_t g = group(h) & groups_mask;
+        for (size_t step = 1; ; ++step) {
+            uint32_t empties = match(m_ctrl.data() + g * GROUP, EMPTY);
+            if (empties) {
+                size_t slot = g * GROUP + lowest_bit(empties);
+                m_ctrl[slot] = tag(h);
+                m_slots[slot] = idx;
+                return;
+            }
+            g = (g + step) & groups_mask;
+        }
+    }
+
+    void rehash(size_t cap) {
+        m_ctrl.assign(cap, EMPTY);
+        m_slots.assign(cap, 0);
+        m_tombstones = 0;
+        for (size_t i = 0; i < m_hashes.size(); ++i)
+            place(m_hashes[i], static_cast<uint32_t>(i));
+    }
+
+    V &emplace_new(K key, uint64_t h, V value) {
+        if (m_entries.size() + m_tombstones + 1 > max_load(capacity())) {
+            // Only grow if clearing the tombstones would not leave plenty of room
+            if (m_entries.size() + 1 > max_load(capacity()) / 2)
+                rehash(capacity() == 0 ? GROUP : capacity() * 2);
+            else
+                rehash(capacity());
+        }
+        m_entries.emplace_back(std::move(key), std::move(value));
+        m_hashes.push_back(h);
+        place(h, static_cast<uint32_t>(m_entries.size() - 1));
+        return m_entries.back().second;
+    }
+
+    std::vector<Entry> m_entries;
+    std::vector<uint64_t> m_hashes;
+    std::vector<uint8_t> m_ctrl;
+    std::vector<uint32_t> m_slots;
+    size_t m_tombstones = 0;
+};
+
+#endif // FLAT_MAP_H
@@ -25,7 +25,9 @@
 #ifndef INTERPRETER_H
 #define INTERPRETER_H
 
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 #include "ctx.hpp"
 #include "ast.hpp"
@@ -76,10 +78,40 @@ namespace Interpreter {
         std::shared_ptr<Ctx> ctx;
     };
 
+    /// @brief How control left a statement
+    enum class Flow {
+        Normal,
+        Break,
+        Continue,
+        Return,
+    };
+
+    /// @brief The result of evaluating a statement. `value` is only
+    /// set when `flow` is `Return` and something was handed back.
+    struct SR {
+        Flow flow = Flow::Normal;
+        std::shared_ptr<earl::value::Obj> value = nullptr;
+    };
+
+    /// @brief Remembers which arguments of a call were not const,
+    /// so that `@const` parameters do not leave them const afterwards.
+    struct ConstArgs {
+        explicit ConstArgs(const std::vector<std::shared_ptr<earl::value::Obj>> &params);
+        void restore(std::vector<std::shared_ptr<earl::value::Obj>> &params) const;
+
+    private:
+        uint64_t m_bits = 0; // The first 64 arguments
+        std::vector<bool> m_rest = {};
+    };
+
     std::shared_ptr<Ctx> interpret(std::unique_ptr<Program> program, std::unique_ptr<Lexer> lexer);
     ER eval_expr(Expr *expr, std::shared_ptr<Ctx> &ctx, bool ref);
-    std::shared_ptr<earl::value::Obj> eval_stmt_block(StmtBlock *block, std::shared_ptr<Ctx> &ctx);
-    std::shared_ptr<earl::value::Obj> eval_stmt(Stmt *stmt, std::shared_ptr<Ctx> &ctx);
+    SR eval_stmt_block(StmtBlock *block, std::shared_ptr<Ctx> &ctx);
+    SR eval_stmt(Stmt *stmt, std::shared_ptr<Ctx> &ctx);
+
+    /// @brief Evaluate the body of a function or closure and get
+    /// what it returned, or `unit` if it returned nothing
+    std::shared_ptr<earl::value::Obj> eval_body(StmtBlock *block, std::shared_ptr<Ctx> &ctx);
 };
 
 #endif // INTERPRETER_H
@@ -129,6 +129,9 @@ namespace Intrinsics {
     extern const std::unordered_map<std::string, Intrinsics::IntrinsicMemberFunction> intrinsic_file_member_functions;
     extern const std::unordered_map<std::string, Intrinsics::IntrinsicMemberFunction> intrinsic_tuple_member_functions;
     extern const std::unordered_map<std::string, Intrinsics::IntrinsicMemberFunction> intrinsic_dict_member_functions;
+    extern const std::unordered_map<std::string, Intrinsics::IntrinsicMemberFunction> intrinsic_set_member_functions;
+    extern const std::unordered_map<std::string, Intrinsics::IntrinsicMemberFunction> intrinsic_deque_member_functions;
+    extern const std::unordered_map<std::string, Intrinsics::IntrinsicMemberFunction> intrinsic_heap_member_functions;
 
     /// @brief Check if an identifier is the name of an intrinsic function
     /// @param id The identifier to check
@@ -211,6 +214,21 @@ namespace Intrinsics {
                    std::shared_ptr<Ctx> &ctx,
                    Expr *expr);
 
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_Set(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                  std::shared_ptr<Ctx> &ctx,
+                  Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_Deque(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                    std::shared_ptr<Ctx> &ctx,
+                    Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_Heap(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                   std::shared_ptr<Ctx> &ctx,
+                   Expr *expr);
+
     std::shared_ptr<earl::value::Obj>
     intrinsic_assert(std::vector<std::shared_ptr<earl::value::Obj>> &params,
                      std::shared_ptr<Ctx> &ctx,
@@ -359,6 +377,48 @@ namespace Intrinsics {
                          std::shared_ptr<Ctx> &ctx,
                          Expr *expr);
 
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_sum(std::shared_ptr<earl::value::Obj> obj,
+                         std::vector<std::shared_ptr<earl::value::Obj>> &unused,
+                         std::shared_ptr<Ctx> &ctx,
+                         Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_min(std::shared_ptr<earl::value::Obj> obj,
+                         std::vector<std::shared_ptr<earl::value::Obj>> &unused,
+                         std::shared_ptr<Ctx> &ctx,
+                         Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_max(std::shared_ptr<earl::value::Obj> obj,
+                         std::vector<std::shared_ptr<earl::value::Obj>> &unused,
+                         std::shared_ptr<Ctx> &ctx,
+                         Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_index_of(std::shared_ptr<earl::value::Obj> obj,
+                              std::vector<std::shared_ptr<earl::value::Obj>> &value,
+                              std::shared_ptr<Ctx> &ctx,
+                              Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_sort(std::shared_ptr<earl::value::Obj> obj,
+                         std::vector<std::shared_ptr<earl::value::Obj>> &unused,
+                         std::shared_ptr<Ctx> &ctx,
+                         Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_sort_by(std::shared_ptr<earl::value::Obj> obj,
+                            std::vector<std::shared_ptr<earl::value::Obj>> &closure,
+                            std::shared_ptr<Ctx> &ctx,
+                            Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_sorted(std::shared_ptr<earl::value::Obj> obj,
+                           std::vector<std::shared_ptr<earl::value::Obj>> &closure,
+                           std::shared_ptr<Ctx> &ctx,
+                           Expr *expr);
+
     std::shared_ptr<earl::value::Obj>
     intrinsic_member_split(std::shared_ptr<earl::value::Obj> obj,
                            std::vector<std::shared_ptr<earl::value::Obj>> &delim,
@@ -383,6 +443,42 @@ namespace Intrinsics {
                             std::shared_ptr<Ctx> &ctx,
                             Expr *expr);
 
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_find(std::shared_ptr<earl::value::Obj> obj,
+                          std::vector<std::shared_ptr<earl::value::Obj>> &value,
+                          std::shared_ptr<Ctx> &ctx,
+                          Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_rfind(std::shared_ptr<earl::value::Obj> obj,
+                           std::vector<std::shared_ptr<earl::value::Obj>> &value,
+                           std::shared_ptr<Ctx> &ctx,
+                           Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_count(std::shared_ptr<earl::value::Obj> obj,
+                           std::vector<std::shared_ptr<earl::value::Obj>> &value,
+                           std::shared_ptr<Ctx> &ctx,
+                           Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_replace(std::shared_ptr<earl::value::Obj> obj,
+                             std::vector<std::shared_ptr<earl::value::Obj>> &values,
+                             std::shared_ptr<Ctx> &ctx,
+                             Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_starts_with(std::shared_ptr<earl::value::Obj> obj,
+                                 std::vector<std::shared_ptr<earl::value::Obj>> &value,
+                                 std::shared_ptr<Ctx> &ctx,
+                                 Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_ends_with(std::shared_ptr<earl::value::Obj> obj,
+                               std::vector<std::shared_ptr<earl::value::Obj>> &value,
+                               std::shared_ptr<Ctx> &ctx,
+                               Expr *expr);
+
     std::shared_ptr<earl::value::Obj>
     intrinsic_member_dump(std::shared_ptr<earl::value::Obj> obj,
                           std::vector<std::shared_ptr<earl::value::Obj>> &unused,
@@ -454,6 +550,78 @@ namespace Intrinsics {
                                std::vector<std::shared_ptr<earl::value::Obj>> &value,
                                std::shared_ptr<Ctx> &ctx,
                                Expr *expr);
+
+    /*** SET MEMBER INTRINSICS ***/
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_remove(std::shared_ptr<earl::value::Obj> obj,
+                            std::vector<std::shared_ptr<earl::value::Obj>> &value,
+                            std::shared_ptr<Ctx> &ctx,
+                            Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_union(std::shared_ptr<earl::value::Obj> obj,
+                           std::vector<std::shared_ptr<earl::value::Obj>> &other,
+                           std::shared_ptr<Ctx> &ctx,
+                           Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_intersection(std::shared_ptr<earl::value::Obj> obj,
+                                  std::vector<std::shared_ptr<earl::value::Obj>> &other,
+                                  std::shared_ptr<Ctx> &ctx,
+                                  Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_difference(std::shared_ptr<earl::value::Obj> obj,
+                                std::vector<std::shared_ptr<earl::value::Obj>> &other,
+                                std::shared_ptr<Ctx> &ctx,
+                                Expr *expr);
+
+    /*** DEQUE MEMBER INTRINSICS ***/
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_push_back(std::shared_ptr<earl::value::Obj> obj,
+                              std::vector<std::shared_ptr<earl::value::Obj>> &value,
+                              std::shared_ptr<Ctx> &ctx,
+                              Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_push_front(std::shared_ptr<earl::value::Obj> obj,
+                               std::vector<std::shared_ptr<earl::value::Obj>> &value,
+                               std::shared_ptr<Ctx> &ctx,
+                               Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_pop_back(std::shared_ptr<earl::value::Obj> obj,
+                             std::vector<std::shared_ptr<earl::value::Obj>> &unused,
+                             std::shared_ptr<Ctx> &ctx,
+                             Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_pop_front(std::shared_ptr<earl::value::Obj> obj,
+                              std::vector<std::shared_ptr<earl::value::Obj>> &unused,
+                              std::shared_ptr<Ctx> &ctx,
+                              Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_front(std::shared_ptr<earl::value::Obj> obj,
+                          std::vector<std::shared_ptr<earl::value::Obj>> &unused,
+                          std::shared_ptr<Ctx> &ctx,
+                          Expr *expr);
+
+    /*** HEAP MEMBER INTRINSICS ***/
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_push(std::shared_ptr<earl::value::Obj> obj,
+                         std::vector<std::shared_ptr<earl::value::Obj>> &value,
+                         std::shared_ptr<Ctx> &ctx,
+                         Expr *expr);
+
+    std::shared_ptr<earl::value::Obj>
+    intrinsic_member_peek(std::shared_ptr<earl::value::Obj> obj,
+                         std::vector<std::shared_ptr<earl::value::Obj>> &unused,
+                         std::shared_ptr<Ctx> &ctx,
+                         Expr *expr);
 };
 
 #endif // INTRINSICS_H
@@ -36,19 +36,18 @@ struct Token;
 /**
  * A Lexer (for lexical analysis) https://en.wikipedia.org/wiki/Lexical_analysis
  * is a tool that splits up and catagorizes individual 'tokens' for parsers.
- * This implementation constructs a linked list of tokens for the parsers
- * to traverse. It starts at `m_hd` and ends at `m_tl`.
+ * This implementation stores the tokens contiguously in `m_toks`, always
+ * ending with an `Eof` token, and the parser walks them with `m_pos`.
+ * AST nodes point straight into `m_toks`, so no tokens may be appended
+ * once parsing has started.
  */
 /// @brief The API for lexical analysis of a document.
 struct Lexer {
-    /// @brief Head of the linked list
-    std::shared_ptr<Token> m_hd;
+    /// @brief Every token in source order
+    std::vector<Token> m_toks;
 
-    /// @brief Tail of the linked list
-    Token *m_tl;
-
-    /// @brief The number of tokens present
-    size_t m_len;
+    /// @brief The index of the current token
+    size_t m_pos;
 
     Lexer();
 
@@ -56,10 +55,9 @@ struct Lexer {
 
     Lexer(const Lexer &other) = delete;
 
-    /// @brief Get the current token, namely the one
-    /// that `m_hd` is currently at. It will
-    /// return that one and update the head accordingly.
-    std::shared_ptr<Token> next(void);
+    /// @brief Get the current token and advance past it.
+    /// Returns nullptr once every token has been consumed.
+    Token *next(void);
 
     /// @brief Peek `n` tokens into the lexer. This does not
     /// consume the current token, only views `n` tokens ahead.
@@ -67,11 +65,11 @@ struct Lexer {
     /// @param n (Optional) how many tokens to peek ahead
     Token *peek(size_t n = 0);
 
-    /// @brief Append a token to the lexer at the end of the tail.
+    /// @brief Append a token to the end of the lexer.
     /// @param tok The token to append
-    void append(std::shared_ptr<Token> tok);
+    void append(Token tok);
 
-    void append(std::string lexeme, TokenType type, size_t row, size_t col, std::string fp);
+    void append(std::string lexeme, TokenType type, size_t row, size_t col, uint32_t file);
 
     /// @brief The same as `Lexer::next()` except it does not give
     /// back the token that was consumed.
@@ -98,6 +96,11 @@ lex_file(std::string &src_code,
          std::vector<std::string> &types,
          std::string &comment);
 
+/// @brief Get the path that `read_file` would open for `filepath`,
+/// looking in the installed stdlib first
+std::string
+resolve_filepath(const char *filepath);
+
 char *
 read_file(const char *filepath);
 
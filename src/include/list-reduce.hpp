@@ -0,0 +1,55 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef LIST_REDUCE_H
+#define LIST_REDUCE_H
+
+#include <cstddef>
+
+/// @brief Reductions over the unboxed elements of a packed list.
+/// On x86-64 they work on 16 (SSE2) or 32 (AVX2, picked at runtime)
+/// bytes at a time. Float sums are always added in the same order
+/// (four running sums, then the tail), so the result does not depend
+/// on which path was taken.
+namespace ListReduce {
+    constexpr size_t npos = static_cast<size_t>(-1);
+
+    /// @brief Int sums wrap around on overflow
+    int sum(const int *xs, size_t n);
+    double sum(const double *xs, size_t n);
+
+    /// @note `n` must not be 0
+    int min(const int *xs, size_t n);
+    double min(const double *xs, size_t n);
+    int max(const int *xs, size_t n);
+    double max(const double *xs, size_t n);
+
+    /// @brief Get the index of the first element equal to `x`.
+    /// @return `npos` if it is not found
+    size_t index_of(const int *xs, size_t n, int x);
+    size_t index_of(const double *xs, size_t n, double x);
+    size_t index_of(const char *xs, size_t n, char x);
+};
+
+#endif // LIST_REDUCE_H
@@ -0,0 +1,83 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef LIST_SORT_H
+#define LIST_SORT_H
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+/// @brief Sorting for lists. The plain element sorts run on several
+/// threads once the input is large enough: each thread sorts one chunk,
+/// then neighbouring chunks are merged until one run is left. All of
+/// them are stable.
+namespace ListSort {
+    /// @brief Inputs shorter than this are sorted on the calling thread
+    constexpr size_t parallel_threshold = 1 << 16;
+
+    void sort(int *xs, size_t n);
+
+    /// @brief NaNs are put after every other value
+    void sort(double *xs, size_t n);
+
+    /// @brief A counting sort, always O(n)
+    void sort(char *xs, size_t n);
+
+    /// @brief Sort the indices `idx` by the keys they point to
+    void sort_indices(std::vector<size_t> &idx, const std::vector<int> &keys);
+    void sort_indices(std::vector<size_t> &idx, const std::vector<double> &keys);
+    void sort_indices(std::vector<size_t> &idx, const std::vector<std::string_view> &keys);
+
+    /// @brief A stable merge sort of `idx` that calls `before(a, b)` to ask
+    /// whether index `a` goes before index `b`. It only ever looks inside
+    /// the bounds of `idx`, so it is safe with a comparator that is not a
+    /// strict weak ordering or that throws, and it keeps the number of
+    /// calls low, as each one may run a closure.
+    template <typename Before> void
+    merge_sort(std::vector<size_t> &idx, Before before) {
+        const size_t n = idx.size();
+        std::vector<size_t> buf(n);
+        for (size_t width = 1; width < n; width *= 2) {
+            for (size_t lo = 0; lo < n; lo += 2*width) {
+                size_t mid = lo+width < n ? lo+width : n;
+                size_t hi = lo+2*width < n ? lo+2*width : n;
+                size_t i = lo, j = mid, k = lo;
+                while (i < mid && j < hi) {
+                    if (before(idx[j], idx[i]))
+                        buf[k++] = idx[j++];
+                    else
+                        buf[k++] = idx[i++];
+                }
+                while (i < mid)
+                    buf[k++] = idx[i++];
+                while (j < hi)
+                    buf[k++] = idx[j++];
+            }
+            idx.swap(buf);
+        }
+    }
+};
+
+#endif // LIST_SORT_H
@@ -0,0 +1,61 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef OPTIMIZER_H
+#define OPTIMIZER_H
+
+#include <memory>
+
+#include "ast.hpp"
+#include "earl.hpp"
+
+/// @brief A pass that runs after the resolver and computes every
+/// expression whose value is known at parse time: literals, scalar
+/// operators applied to them and list/tuple literals made only of
+/// constants. The value is stored in `Expr::m_const` and the
+/// interpreter hands out a copy of it instead of evaluating the
+/// expression again.
+///
+/// Nothing that could fail at runtime (i.e., division by zero,
+/// an `int` literal that is out of range) is folded, so the error
+/// is still reported where it happens.
+namespace Optimizer {
+    /// @brief Fold the constants of every expression in `program`.
+    void optimize_program(Program *program);
+
+    /// @brief Get a fresh value of a constant made by `optimize_program`
+    /// that shares nothing mutable with it.
+    std::shared_ptr<earl::value::Obj> instance(earl::value::Obj *value);
+
+    /// @brief Get the value of an int, float, str, char or bool literal
+    /// @return nullptr if `expr` is not one of them, or if it cannot be
+    /// represented (i.e., an `int` literal that is out of range)
+    std::shared_ptr<earl::value::Obj> fold_literal(ExprTerm *expr);
+
+    /// @brief Get the character of a char literal, with its escape
+    /// sequence (if any) applied.
+    char charlit_value(ExprCharLit *expr);
+};
+
+#endif // OPTIMIZER_H
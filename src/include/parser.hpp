@@ -34,61 +34,61 @@
 namespace Parser {
     /// @brief The entrypoint to parsing.
     /// @param lexer The lexer that has
-    /// the linked list of tokens to parse
+    /// the tokens to parse
     std::unique_ptr<Program> parse_program(Lexer &lexer, const std::string filepath);
 
     /// @brief Parses a statement.
-    /// @param lexer The lexer with the linked list
+    /// @param lexer The lexer with the tokens
     /// of tokens
     std::unique_ptr<Stmt> parse_stmt(Lexer &lexer);
 
     /// @brief Parses a statement of type statement definition.
     /// @note ex:
     /// def my_func(a: int, b: int) -> int { ... }
-    /// @param lexer The lexer with the linked list of tokens
+    /// @param lexer The lexer with the tokens
     std::unique_ptr<StmtDef> parse_stmt_def(Lexer &lexer, uint32_t attrs);
 
     /// @brief Parses a statement of type
     /// statement expression. Examples of this are functions
     /// where there is no return value (or the value is to
     /// be ignored), or math equations for the REPL i.e., 1+3.
-    /// @param lexer The lexer with the linked list of tokens
+    /// @param lexer The lexer with the tokens
     std::unique_ptr<StmtExpr> parse_stmt_expr(Lexer &lexer);
 
     /// @brief Parses a statement of type 'let'.
     /// @note ex: let x: int = 3;
-    /// @param lexer The lexer with the linked list of tokens
+    /// @param lexer The lexer with the tokens
     std::unique_ptr<StmtLet> parse_stmt_let(Lexer &lexer, uint32_t attrs);
 
     /// @brief Parses a statement of type mutate.
     /// @note ex: x = 3 + a * 4 / 2;
-    /// @param lexer The lexer with the linked list of tokens
+    /// @param lexer The lexer with the tokens
     std::unique_ptr<StmtMut> parse_stmt_mut(Lexer &lexer);
 
     /// @brief Parses a statement of type block
-    /// @param lexer The lexer with the linked list of tokens
+    /// @param lexer The lexer with the tokens
     std::unique_ptr<StmtBlock> parse_stmt_block(Lexer &lexer);
 
     /// @brief Parses a statement of type if.
-    /// @param lexer The lexer with the linked list of tokens
+    /// @param lexer The lexer with the tokens
     std::unique_ptr<StmtIf> parse_stmt_if(Lexer &lexer);
 
     /// @brief Parses an expression. It uses
     /// a recursive descent parser to determine precidence.
-    /// @param lexer The lexer with the linked list of tokens
+    /// @param lexer The lexer with the tokens
     Expr *parse_expr(Lexer &lexer, char fail_on = '\0');
 
     /// @brief A utility function for the parsers
     /// to use to expect the next token to be an EARL keyword.
-    /// @param lexer The lexer with the linked list of tokens
+    /// @param lexer The lexer with the tokens
     /// @param expected The keyword to expect
-    std::shared_ptr<Token> parse_expect_keyword(Lexer &lexer, std::string expected);
+    Token *parse_expect_keyword(Lexer &lexer, std::string expected);
 
     /// @brief A utility function for the parsers
     /// to use to expect the next token to be of type `expected`.
-    /// @param lexer The lexer with the linked list of tokens
+    /// @param lexer The lexer with the tokens
     /// @param expected The type to expect
-    std::shared_ptr<Token> parse_expect(Lexer &lexer, TokenType expected);
+    Token *parse_expect(Lexer &lexer, TokenType expected);
 };
 
 #endif // PARSER_H
@@ -0,0 +1,44 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef RESOLVER_H
+#define RESOLVER_H
+
+#include "ast.hpp"
+
+/// @brief A pass that runs after parsing and assigns every
+/// local variable of a function (parameters, `let` bindings and
+/// loop enumerators) an index into a flat per-call frame. Uses
+/// of those locals get annotated with the same `Slot` so that
+/// `FunctionCtx` can find them without a string lookup.
+///
+/// Anything the resolver cannot prove statically (closures,
+/// `some(x)` match bindings, world/class/module variables) is
+/// left with a null `Slot::m_frame` and resolved by name.
+namespace Resolver {
+    /// @brief Resolve every function definition in `program`.
+    void resolve_program(Program *program);
+};
+
+#endif // RESOLVER_H
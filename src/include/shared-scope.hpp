@@ -181,6 +181,14 @@ template <typename K, typename V> struct SharedScope {
         m_map.clear();
     }
 
+    /// @brief Empty every scope back down to a single one, keeping
+    /// the allocated storage for reuse.
+    inline void reset(void) {
+        m_map.resize(1);
+        m_map.back().clear();
+        m_cache.cache.clear();
+    }
+
     inline void debug_dump(void) const {
         int i = 1;
         for (const auto &map : m_map) {
@@ -0,0 +1,53 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef STR_SEARCH_H
+#define STR_SEARCH_H
+
+#include <cstddef>
+#include <string_view>
+
+/// @brief Substring search used by the str member intrinsics.
+/// On x86-64 candidate positions are found 16 (SSE2) or 32 (AVX2,
+/// picked at runtime) at a time by comparing the first and last
+/// char of the needle against a block of the haystack, and only
+/// those candidates are compared in full. Everything else falls
+/// back to `std::string_view`.
+namespace StrSearch {
+    constexpr size_t npos = std::string_view::npos;
+
+    /// @brief Get the index of the first `needle` in `hay` at or after `from`.
+    /// @return `npos` if it is not found
+    size_t find(std::string_view hay, std::string_view needle, size_t from = 0);
+
+    /// @brief Get the index of the last `needle` in `hay`.
+    /// @return `npos` if it is not found
+    size_t rfind(std::string_view hay, std::string_view needle);
+
+    /// @brief Count the non-overlapping occurrences of `needle` in `hay`.
+    /// An empty `needle` is never counted.
+    size_t count(std::string_view hay, std::string_view needle);
+};
+
+#endif // STR_SEARCH_H
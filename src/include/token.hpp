@@ -31,6 +31,7 @@
 #define TOKEN_H
 
 #include <string>
+#include <cstdint>
 #include <memory>
 
 //#include "lexer.hpp"
@@ -111,16 +112,21 @@ enum class TokenType {
 
 std::string tokentype_to_str(TokenType type);
 
+/// @brief Intern `fp` in the global file table and get its index.
+/// Every token of a file shares the one copy of its path.
+uint32_t filetable_intern(const std::string &fp);
+
+/// @brief Get the filepath stored at `idx` in the global file table
+const std::string &filetable_get(uint32_t idx);
+
 /// @brief The definition of a token.
 struct Token {
-    Token(char *start, size_t len,
-          TokenType type,
-          size_t row, size_t col, std::string &fp);
-
-    Token(std::string lexeme, TokenType type, size_t row, size_t col, std::string fp);
+    Token(std::string lexeme, TokenType type, size_t row, size_t col, uint32_t file);
 
     Token(const Token &) = delete;
 
+    Token(Token &&) = default;
+
     ~Token() = default;
 
     /// @brief The actual value of the `Token`
@@ -135,32 +141,33 @@ struct Token {
     /// @brief The column of the token
     size_t m_col;
 
-    /// @brief The filepath of the token
-    std::string m_fp;
-
-    /// @brief A pointer to the next token
-    std::shared_ptr<Token> m_next;
+    /// @brief The index of the filepath of the token in the file table
+    uint32_t m_file;
 
     /// @brief Get the `lexeme` of the current token
     std::string &lexeme(void);
 
     /// @brief Get the `type` of the current token
     TokenType type(void) const;
+
+    /// @brief Get the filepath of the current token
+    const std::string &fp(void) const;
+
+    /// @brief Get the token that follows this one in its lexer,
+    /// or nullptr if this is the `Eof` token.
+    Token *next(void);
 };
 
-/// @brief Allocate a `Token` using an `Arena Allocator`
-/// @param lexer The lexer that is currently being used. It is needed for it's `arena`.
+/// @brief Create a `Token`, resolving the escape sequences of string literals
+/// @param lexer The lexer that is currently being used
 /// @param start A pointer to the start of the lexeme to create
 /// @param len How many characters for the lexeme
 /// @param type The type of the token to create
 /// @param row The row of the token
 /// @param col The column of the token
-/// @param fp The filepath of the token
-std::shared_ptr<Token> token_alloc(Lexer &lexer, char *start, size_t len, TokenType type, size_t row, size_t col, std::string fp);
+/// @param file The index of the filepath of the token in the file table
+Token token_alloc(Lexer &lexer, char *start, size_t len, TokenType type, size_t row, size_t col, uint32_t file);
 
-/// @brief Prints tokens from the current token to the end of line.
-/// @param tok The token to start from
-/// @param padding The number of spaces to prepend the output
 void token_dump_until_eol(Token *tok, int padding = 2);
 
 #endif // TOKEN_H
@@ -0,0 +1,134 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+/**
+ * Provides a small bytecode compiler and register based
+ * virtual machine that can run function bodies in place of
+ * the tree walking interpreter. Only a subset of the language
+ * is compiled; anything else keeps running in the interpreter.
+ */
+
+#ifndef VM_H
+#define VM_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ast.hpp"
+#include "ctx.hpp"
+#include "earl.hpp"
+
+namespace VM {
+    /// @brief The instructions understood by the VM.
+    /// `R` is the register file, `K` is the constant pool.
+    enum class Op : uint8_t {
+        /** R[a] = copy of K[b] */
+        LoadK,
+        /** R[a] = K[b] (only for values that are never retained) */
+        LoadKRef,
+        /** R[a] = R[b] */
+        Move,
+        /** R[a] = copy of R[b] */
+        Copy,
+        /** R[a] = R[b] <p> R[c], copy R[c] first if d != 0 and not a scalar */
+        BinOp,
+        /** R[a] = <p> R[b] */
+        UnaryOp,
+        /** R[a] := R[b] */
+        Mutate,
+        /** R[a] <p>= R[b] */
+        SpecMutate,
+        /** Mark R[a] as @const if c != 0 or if it is a tuple */
+        SetConst,
+        /** Fail if `names[b]` already exists in the @world scope */
+        CheckFree,
+        /** pc = a */
+        Jmp,
+        /** if !R[a] then pc = b */
+        JmpFalse,
+        /** if R[a] then pc = b */
+        JmpTrue,
+        /** Verify `for` bounds R[a] and R[b], store the direction in R[c] */
+        ForPrep,
+        /** if the `for` loop in R[a], R[b], R[c] is done then pc = d */
+        ForTest,
+        /** Step the enumerator R[a] in the direction R[c] */
+        ForStep,
+        /** R[a] = names[d](R[b], ..., R[b+c-1]) */
+        CallIntrinsic,
+        /** R[a] = callees[d](R[b], ..., R[b+c-1]) */
+        Call,
+        /** Handle an expression statement that produced R[a] */
+        ExprStmt,
+        /** return R[a] */
+        Ret,
+        /** return; */
+        RetVoid,
+        /** Fell off the end of the function */
+        End,
+    };
+
+    /// @brief A single VM instruction.
+    struct Instr {
+        Op op;
+        int a, b, c, d;
+        void *p;
+    };
+
+    /// @brief A function called by a chunk. It is not owned by the
+    /// chunk, as that would keep recursive functions alive forever,
+    /// and is looked up again by `id` if it has been freed.
+    struct Callee {
+        std::string id;
+        std::weak_ptr<earl::function::Obj> func;
+    };
+
+    /// @brief A compiled function body.
+    struct Chunk {
+        std::vector<Instr> code;
+        std::vector<std::shared_ptr<earl::value::Obj>> consts;
+        std::vector<std::string> names;
+        std::vector<Callee> callees;
+        size_t nregs;
+        WorldCtx *world;
+    };
+
+    /// @brief Compile the body of `func` for the @world scope `world`.
+    /// @return The compiled chunk, or nullptr if the function uses
+    /// something the VM does not support.
+    std::shared_ptr<Chunk> compile(earl::function::Obj *func, WorldCtx *world);
+
+    /// @brief Call `func` using the VM.
+    /// @param params The already evaluated arguments
+    /// @param ctx The context the function is being called from
+    /// @return The result of the call, or nullptr if the function
+    /// cannot be ran by the VM and the interpreter should be used instead.
+    std::shared_ptr<earl::value::Obj> call(earl::function::Obj *func,
+                                           std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                                           std::shared_ptr<Ctx> &ctx);
+};
+
+#endif // VM_H
@@ -23,6 +23,7 @@
 // SOFTWARE.
 
 #include <cassert>
+#include <filesystem>
 #include <vector>
 #include <iostream>
 #include <memory>
@@ -41,6 +42,9 @@
 #include "common.hpp"
 #include "earl.hpp"
 #include "lexer.hpp"
+#include "earlc.hpp"
+#include "vm.hpp"
+#include "optimizer.hpp"
 
 using namespace Interpreter;
 
@@ -61,15 +65,18 @@ eval_user_defined_function(ExprFuncCall *expr,
                            std::shared_ptr<Ctx> &ctx,
                            bool from_outside = false);
 
-std::shared_ptr<earl::value::Obj>
+SR
 eval_stmt_let(StmtLet *stmt, std::shared_ptr<Ctx> &ctx);
 
-std::shared_ptr<earl::value::Obj>
+SR
 eval_stmt_def(StmtDef *stmt, std::shared_ptr<Ctx> &ctx);
 
 static std::shared_ptr<earl::value::Obj>
 unpack_ER(ER &er, std::shared_ptr<Ctx> &ctx, bool ref, PackedERPreliminary *perp = nullptr);
 
+static ER
+eval_expr_term_array_access(ExprArrayAccess *expr, std::shared_ptr<Ctx> &ctx, bool ref, bool receiver = false);
+
 static std::string
 identifier_not_declared(std::string given, std::vector<std::string> possible, bool include_intrinsics=true) {
     if (include_intrinsics) {
@@ -123,10 +130,23 @@ method_not_declared(std::string given, std::shared_ptr<earl::value::Obj> accesso
     case earl::value::Type::DictInt:
     case earl::value::Type::DictStr:
     case earl::value::Type::DictFloat:
-    case earl::value::Type::DictChar: {
+    case earl::value::Type::DictChar:
+    case earl::value::Type::DictTuple: {
         for (auto it = Intrinsics::intrinsic_dict_member_functions.begin(); it != Intrinsics::intrinsic_dict_member_functions.end(); ++it)
             possible.push_back(it->first);
     } break;
+    case earl::value::Type::Set: {
+        for (auto it = Intrinsics::intrinsic_set_member_functions.begin(); it != Intrinsics::intrinsic_set_member_functions.end(); ++it)
+            possible.push_back(it->first);
+    } break;
+    case earl::value::Type::Deque: {
+        for (auto it = Intrinsics::intrinsic_deque_member_functions.begin(); it != Intrinsics::intrinsic_deque_member_functions.end(); ++it)
+            possible.push_back(it->first);
+    } break;
+    case earl::value::Type::Heap: {
+        for (auto it = Intrinsics::intrinsic_heap_member_functions.begin(); it != Intrinsics::intrinsic_heap_member_functions.end(); ++it)
+            possible.push_back(it->first);
+    } break;
     default: {
         return identifier_not_declared(given, possible);
     } break;
@@ -135,7 +155,7 @@ method_not_declared(std::string given, std::shared_ptr<earl::value::Obj> accesso
     return identifier_not_declared(given, possible, /*include_intrinsics=*/false);
 }
 
-static std::shared_ptr<earl::value::Obj>
+static SR
 eval_stmt_let_wmultiple_vars_wcustom_buffer_in_class(StmtLet *stmt,
                                              std::unordered_map<std::string, std::shared_ptr<earl::variable::Obj>> &buffer,
                                              std::shared_ptr<Ctx> &ctx,
@@ -151,7 +171,7 @@ eval_stmt_let_wmultiple_vars_wcustom_buffer_in_class(StmtLet *stmt,
             if (dynamic_cast<ClassCtx *>(ctx.get())->variable_exists_wo__m_class_constructor_tmp_args(id->lexeme())) {
                 std::string msg = "variable `"+id->lexeme()+"` is already declared";
                 auto conflict = ctx->variable_get(id->lexeme());
-                Err::err_wconflict(stmt->m_ids.at(i).get(), conflict->gettok());
+                Err::err_wconflict(stmt->m_ids.at(i), conflict->gettok());
                 throw InterpreterException(msg);
                 ++i;
             }
@@ -196,16 +216,16 @@ eval_stmt_let_wmultiple_vars_wcustom_buffer_in_class(StmtLet *stmt,
                 tuple->value().at(i)->set_const();
 
             std::shared_ptr<earl::variable::Obj> var
-                = std::make_shared<earl::variable::Obj>(stmt->m_ids.at(i).get(), tuple->value().at(i), stmt->m_attrs);
+                = std::make_shared<earl::variable::Obj>(stmt->m_ids.at(i), tuple->value().at(i), stmt->m_attrs);
             ctx->variable_add(var);
         }
         ++i;
     }
 
-    return std::make_shared<earl::value::Void>();
+    return {};
 }
 
-static std::shared_ptr<earl::value::Obj>
+static SR
 eval_stmt_let_wcustom_buffer_in_class(StmtLet *stmt,
                              std::unordered_map<std::string, std::shared_ptr<earl::variable::Obj>> &buffer,
                              std::shared_ptr<Ctx> &ctx,
@@ -219,7 +239,7 @@ eval_stmt_let_wcustom_buffer_in_class(StmtLet *stmt,
     if (dynamic_cast<ClassCtx *>(ctx.get())->variable_exists_wo__m_class_constructor_tmp_args(id)) {
         std::string msg = "variable `"+id+"` is already declared";
         auto conflict = ctx->variable_get(id);
-        Err::err_wconflict(stmt->m_ids.at(0).get(), conflict->gettok());
+        Err::err_wconflict(stmt->m_ids.at(0), conflict->gettok());
         throw InterpreterException(msg);
     }
 
@@ -240,12 +260,12 @@ eval_stmt_let_wcustom_buffer_in_class(StmtLet *stmt,
         value = unpack_ER(rhs, ctx, _ref);
 
     if (id == "_")
-        return std::make_shared<earl::value::Void>();
+        return {};
 
     std::shared_ptr<earl::variable::Obj> var
-        = std::make_shared<earl::variable::Obj>(stmt->m_ids.at(0).get(), value, stmt->m_attrs);
+        = std::make_shared<earl::variable::Obj>(stmt->m_ids.at(0), value, stmt->m_attrs);
     ctx->variable_add(var);
-    return std::make_shared<earl::value::Void>();
+    return {};
 }
 
 static std::shared_ptr<earl::value::Obj>
@@ -297,7 +317,7 @@ eval_class_instantiation(ExprFuncCall *expr,
 
     // Add the constructor arguments to a temporary pushed scope
     for (size_t i = 0; i < class_stmt->m_constructor_args.size(); ++i) {
-        auto var = std::make_shared<earl::variable::Obj>(class_stmt->m_constructor_args[i].get(), params[i]);
+        auto var = std::make_shared<earl::variable::Obj>(class_stmt->m_constructor_args[i], params[i]);
 
         // MAKE SURE TO CLEAR AT THE END OF THIS FUNC!
         class_ctx->fill___m_class_constructor_tmp_args(var);
@@ -334,7 +354,7 @@ eval_class_instantiation(ExprFuncCall *expr,
 static std::vector<std::shared_ptr<earl::value::Obj>>
 evaluate_function_parameters(ExprFuncCall *funccall, std::shared_ptr<Ctx> ctx, bool ref) {
     std::vector<std::shared_ptr<earl::value::Obj>> res = {};
-    PackedERPreliminary perp(nullptr, /*this_=*/false, /*errtok=*/funccall->m_tok.get());
+    PackedERPreliminary perp(nullptr, /*this_=*/false, /*errtok=*/funccall->m_tok);
     for (size_t i = 0; i < funccall->m_params.size(); ++i) {
         ER er = Interpreter::eval_expr(funccall->m_params[i].get(), ctx, ref);
         res.push_back(unpack_ER(er, ctx, ref, /*perp=*/&perp));
@@ -347,45 +367,39 @@ evaluate_function_parameters_wrefs(ExprFuncCall *funccall,
                                    std::variant<std::shared_ptr<earl::function::Obj>, earl::value::Closure *> &func_proper,
                                    std::shared_ptr<Ctx> ctx) {
     std::vector<std::shared_ptr<earl::value::Obj>> res = {};
-    std::vector<int> refs = {};
+    res.reserve(funccall->m_params.size());
 
     std::visit([&](auto &&fun) {
         using T = std::decay_t<decltype(fun)>;
         if constexpr (std::is_same_v<T, std::shared_ptr<earl::function::Obj>>) {
 
-            // Build reference table
-            for (size_t i = 0; i < fun->params_len(); ++i)
-                refs.push_back(static_cast<bool>(fun->param_at_is_ref(i)));
-
-            if (refs.size() != funccall->m_params.size()) {
-                const std::string msg = "function `"+fun->id()+"` expects "+std::to_string(refs.size())+" arguments but got "+std::to_string(funccall->m_params.size());
+            if (fun->params_len() != funccall->m_params.size()) {
+                const std::string msg = "function `"+fun->id()+"` expects "+std::to_string(fun->params_len())+" arguments but got "+std::to_string(funccall->m_params.size());
                 Err::err_wexpr(funccall);
                 throw InterpreterException(msg);
             }
 
-            // Evaluate the parameters based on the reference table
+            // Evaluate each parameter by reference if the function takes it so
             for (size_t i = 0; i < funccall->m_params.size(); ++i) {
-                ER er = Interpreter::eval_expr(funccall->m_params[i].get(), ctx, /*ref=*/refs.at(i));
-                res.push_back(unpack_ER(er, ctx, refs[i]));
+                bool ref = fun->param_at_is_ref(i);
+                ER er = Interpreter::eval_expr(funccall->m_params[i].get(), ctx, ref);
+                res.push_back(unpack_ER(er, ctx, ref));
             }
         }
 
         else if constexpr (std::is_same_v<T, earl::value::Closure *>) {
 
-            // Build reference table
-            for (size_t i = 0; i < fun->params_len(); ++i)
-                refs.push_back(static_cast<bool>(fun->param_at_is_ref(i)));
-
-            if (refs.size() != funccall->m_params.size()) {
-                const std::string msg = "closure `"+fun->tok()->lexeme()+"` expects "+std::to_string(refs.size())+" arguments but got "+std::to_string(funccall->m_params.size());
+            if (fun->params_len() != funccall->m_params.size()) {
+                const std::string msg = "closure `"+fun->tok()->lexeme()+"` expects "+std::to_string(fun->params_len())+" arguments but got "+std::to_string(funccall->m_params.size());
                 Err::err_wexpr(funccall);
                 throw InterpreterException(msg);
             }
 
-            // Evaluate the parameters based on the reference table
+            // Evaluate each parameter by reference if the closure takes it so
             for (size_t i = 0; i < funccall->m_params.size(); ++i) {
-                ER er = Interpreter::eval_expr(funccall->m_params[i].get(), ctx, /*ref=*/refs[i]);
-                res.push_back(unpack_ER(er, ctx, refs[i]));
+                bool ref = fun->param_at_is_ref(i);
+                ER er = Interpreter::eval_expr(funccall->m_params[i].get(), ctx, ref);
+                res.push_back(unpack_ER(er, ctx, ref));
             }
         }
 
@@ -398,6 +412,25 @@ evaluate_function_parameters_wrefs(ExprFuncCall *funccall,
     return res;
 }
 
+Interpreter::ConstArgs::ConstArgs(const std::vector<std::shared_ptr<earl::value::Obj>> &params) {
+    for (size_t i = 0; i < params.size(); ++i) {
+        bool c = params[i]->is_const();
+        if (i < 64)
+            m_bits |= static_cast<uint64_t>(c) << i;
+        else
+            m_rest.push_back(c);
+    }
+}
+
+void
+Interpreter::ConstArgs::restore(std::vector<std::shared_ptr<earl::value::Obj>> &params) const {
+    for (size_t i = 0; i < params.size(); ++i) {
+        bool c = i < 64 ? ((m_bits >> i) & 1) != 0 : m_rest[i-64];
+        if (!c)
+            params[i]->unset_const();
+    }
+}
+
 static std::shared_ptr<earl::value::Obj>
 eval_user_defined_function_wo_params(const std::string &id,
                                      ExprFuncCall *funccall,
@@ -405,8 +438,6 @@ eval_user_defined_function_wo_params(const std::string &id,
                                      std::shared_ptr<Ctx> &ctx,
                                      bool from_outside = false) {
     std::vector<std::shared_ptr<earl::value::Obj>> params = {};
-    std::vector<bool> originally_was_const = {};
-    std::vector<int> refs = {};
     std::variant<std::shared_ptr<earl::function::Obj>, earl::value::Closure *> v;
 
     if (ctx->function_exists(id)) {
@@ -423,12 +454,7 @@ eval_user_defined_function_wo_params(const std::string &id,
         }
 
         params = evaluate_function_parameters_wrefs(funccall, v, funccall_ctx);
-        for (auto &p : params) {
-            if (p->is_const())
-                originally_was_const.push_back(true);
-            else
-                originally_was_const.push_back(false);
-        }
+        ConstArgs consts(params);
 
         if (func->params_len() != params.size()) {
             const std::string msg = "function `"+func->id()+"` expects "+std::to_string(func->params_len())+" arguments but got "+std::to_string(params.size());
@@ -436,25 +462,30 @@ eval_user_defined_function_wo_params(const std::string &id,
             throw InterpreterException(msg);
         }
 
-        auto fctx = std::make_shared<FunctionCtx>(ctx, func->attrs());
-        fctx->set_curfunc(id);
-        func->load_parameters(params, fctx);
+        std::shared_ptr<earl::value::Obj> res = nullptr;
+        if ((flags & __VM) != 0)
+            res = VM::call(func.get(), params, ctx);
 
-        // Recursion optimization
-        if (ctx->type() == CtxType::Function) {
-            if (fctx->get_curfuncid() == dynamic_cast<FunctionCtx *>(ctx.get())->get_curfuncid()) {
-                fctx->setrec();
-            }
-        }
+        if (!res) {
+            auto fctx = FunctionCtx::acquire(ctx, func->attrs());
+            fctx->set_curfunc(id);
+            func->load_parameters(params, fctx);
 
-        std::shared_ptr<Ctx> mask = fctx;
-        auto res = Interpreter::eval_stmt_block(func->block(), mask);
+            // Recursion optimization
+            if (ctx->type() == CtxType::Function) {
+                if (fctx->get_curfuncid() == dynamic_cast<FunctionCtx *>(ctx.get())->get_curfuncid()) {
+                    fctx->setrec();
+                }
+            }
 
-        for (size_t i = 0; i < originally_was_const.size(); ++i) {
-            if (!originally_was_const[i])
-                params[i]->unset_const();
+            std::shared_ptr<Ctx> mask = fctx;
+            res = Interpreter::eval_body(func->block(), mask);
+            mask = nullptr;
+            FunctionCtx::release(fctx);
         }
 
+        consts.restore(params);
+
         return res;
     }
     else if (ctx->closure_exists(id)) {
@@ -470,7 +501,7 @@ eval_user_defined_function_wo_params(const std::string &id,
         }
         clvalue->load_parameters(params, clctx);
         std::shared_ptr<Ctx> mask = clctx;
-        return Interpreter::eval_stmt_block(clvalue->block(), mask);
+        return Interpreter::eval_body(clvalue->block(), mask);
     }
 
     Err::err_wexpr(funccall);
@@ -505,8 +536,7 @@ eval_user_defined_function(ExprFuncCall *expr,
                 Err::err_wexpr(expr);
             throw InterpreterException(msg);
         }
-        auto fctx = std::make_shared<FunctionCtx>(ctx, func->attrs());
-        func->load_parameters(params, fctx);
+        auto fctx = FunctionCtx::acquire(ctx, func->attrs());
         fctx->set_curfunc(id);
         func->load_parameters(params, fctx);
 
@@ -517,7 +547,10 @@ eval_user_defined_function(ExprFuncCall *expr,
         }
 
         std::shared_ptr<Ctx> mask = fctx;
-        return Interpreter::eval_stmt_block(func->block(), mask);
+        auto res = Interpreter::eval_body(func->block(), mask);
+        mask = nullptr;
+        FunctionCtx::release(fctx);
+        return res;
     }
     else if (ctx->closure_exists(id)) {
         auto cl = ctx->variable_get(id);
@@ -530,7 +563,7 @@ eval_user_defined_function(ExprFuncCall *expr,
         }
         clvalue->load_parameters(params, clctx);
         std::shared_ptr<Ctx> mask = clctx;
-        return Interpreter::eval_stmt_block(clvalue->block(), mask);
+        return Interpreter::eval_body(clvalue->block(), mask);
     }
 
     Err::err_wexpr(expr);
@@ -543,6 +576,13 @@ eval_user_defined_function(ExprFuncCall *expr,
     return nullptr; // unreachable
 }
 
+// Record `var` in the frame slot the resolver gave it.
+static inline void
+bind_slot(const Slot &slot, const std::shared_ptr<earl::variable::Obj> &var, std::shared_ptr<Ctx> &ctx) {
+    if (slot.m_frame && ctx->type() == CtxType::Function)
+        static_cast<FunctionCtx *>(ctx.get())->slot_set(slot, var);
+}
+
 static std::shared_ptr<earl::value::Obj>
 unpack_ER(ER &er, std::shared_ptr<Ctx> &ctx, bool ref, PackedERPreliminary *perp) {
     // CLASSES
@@ -623,6 +663,15 @@ unpack_ER(ER &er, std::shared_ptr<Ctx> &ctx, bool ref, PackedERPreliminary *perp
             if (lhs->has_entry(er.id))
                 return lhs->get_entry(er.id)->value()->copy();
         }
+        // Locals that the resolver gave a slot are read straight from the frame.
+        if (ctx->type() == CtxType::Function && er.ctx.get() == ctx.get()) {
+            auto var = static_cast<FunctionCtx *>(ctx.get())->slot_get(static_cast<ExprIdent *>(er.extra)->m_slot);
+            if (var) {
+                if (!ref)
+                    return var->value()->copy();
+                return var->value();
+            }
+        }
         if (ctx->variable_exists(er.id)) {
             auto var = ctx->variable_get(er.id);
             if ((!perp || !perp->this_) && (er.ctx != ctx && !var->is_pub())) {
@@ -820,7 +869,12 @@ eval_expr_term_mod_access(ExprModAccess *expr, std::shared_ptr<Ctx> &ctx, bool r
 
 ER
 eval_expr_term_get(ExprGet *expr, std::shared_ptr<Ctx> &ctx, bool ref) {
-    ER left_er = Interpreter::eval_expr(expr->m_left.get(), ctx, ref);
+    // A method may change the element it is called on, i.e., `lst[i].append(x)`.
+    Expr *left = expr->m_left.get();
+    ER left_er = left->get_type() == ExprType::Term
+        && static_cast<ExprTerm *>(left)->get_term_type() == ExprTermType::Array_Access
+        ? eval_expr_term_array_access(static_cast<ExprArrayAccess *>(left), ctx, ref, /*receiver=*/true)
+        : Interpreter::eval_expr(left, ctx, ref);
     ER right_er(std::shared_ptr<earl::value::Obj>{}, ERT::None);
 
     std::visit([&](auto &&arg) {
@@ -879,7 +933,7 @@ eval_expr_term_get(ExprGet *expr, std::shared_ptr<Ctx> &ctx, bool ref) {
     }
     else {
         auto left_value = unpack_ER(left_er, ctx, true);
-        PackedERPreliminary perp(left_value, /*this=*/false, /*errtok=*/expr->m_tok.get());
+        PackedERPreliminary perp(left_value, /*this=*/false, /*errtok=*/expr->m_tok);
         std::shared_ptr<earl::value::Obj> value = nullptr;
 
         if (left_value->type() == earl::value::Type::Class) {
@@ -901,19 +955,7 @@ eval_expr_term_get(ExprGet *expr, std::shared_ptr<Ctx> &ctx, bool ref) {
 
 static ER
 eval_expr_term_charlit(ExprCharLit *expr) {
-    std::shared_ptr<earl::value::Char> value = nullptr;
-    if (expr->m_tok->lexeme() == "\\n")
-        value = std::make_shared<earl::value::Char>('\n');
-    else if (expr->m_tok->lexeme() == "\\t")
-        value = std::make_shared<earl::value::Char>('\t');
-    else if (expr->m_tok->lexeme() == "\\r")
-        value = std::make_shared<earl::value::Char>('\r');
-    else if (expr->m_tok->lexeme() == "\\0")
-        value = std::make_shared<earl::value::Char>('\0');
-    else if (expr->m_tok->lexeme() == "\\\\")
-        value = std::make_shared<earl::value::Char>('\\');
-    else
-        value = std::make_shared<earl::value::Char>(expr->m_tok->lexeme()[0]);
+    auto value = std::make_shared<earl::value::Char>(Optimizer::charlit_value(expr));
     return ER(value, ERT::Literal);
 }
 
@@ -929,7 +971,7 @@ eval_expr_term_listlit(ExprListLit *expr, std::shared_ptr<Ctx> &ctx, bool ref) {
 }
 
 static ER
-eval_expr_term_array_access(ExprArrayAccess *expr, std::shared_ptr<Ctx> &ctx, bool ref) {
+eval_expr_term_array_access(ExprArrayAccess *expr, std::shared_ptr<Ctx> &ctx, bool ref, bool receiver) {
     ER left_er = Interpreter::eval_expr(expr->m_left.get(), ctx, ref);
     ER idx_er = Interpreter::eval_expr(expr->m_expr.get(), ctx, ref);
 
@@ -938,10 +980,15 @@ eval_expr_term_array_access(ExprArrayAccess *expr, std::shared_ptr<Ctx> &ctx, bo
 
     if (left_value->type() == earl::value::Type::List) {
         auto list = dynamic_cast<earl::value::List *>(left_value.get());
-        return ER(list->nth(idx_value, expr), static_cast<ERT>(ERT::Literal|ERT::ListAccess));
+        auto elem = ref || receiver ? list->nth(idx_value, expr) : list->nth_value(idx_value, expr);
+        return ER(elem, static_cast<ERT>(ERT::Literal|ERT::ListAccess));
     }
     else if (left_value->type() == earl::value::Type::Str) {
         auto str = dynamic_cast<earl::value::Str *>(left_value.get());
+        if (idx_value->type() == earl::value::Type::Slice) {
+            auto slice = dynamic_cast<earl::value::Slice *>(idx_value.get());
+            return ER(str->slice(slice->start(), slice->end(), expr), static_cast<ERT>(ERT::Literal|ERT::ListAccess));
+        }
         return ER(str->nth(idx_value, expr), static_cast<ERT>(ERT::Literal|ERT::ListAccess));
     }
     else if (left_value->type() == earl::value::Type::Tuple) {
@@ -964,6 +1011,10 @@ eval_expr_term_array_access(ExprArrayAccess *expr, std::shared_ptr<Ctx> &ctx, bo
         auto dict = dynamic_cast<earl::value::Dict<double> *>(left_value.get());
         return ER(dict->nth(idx_value, expr), static_cast<ERT>(ERT::Literal|ERT::ListAccess));
     }
+    else if (left_value->type() == earl::value::Type::DictTuple) {
+        auto dict = dynamic_cast<earl::value::Dict<earl::value::DictKey> *>(left_value.get());
+        return ER(dict->nth(idx_value, expr), static_cast<ERT>(ERT::Literal|ERT::ListAccess));
+    }
     else {
         std::string msg = "cannot use `[]` on non-list, non-tuple, non-dict, or non-str type";
         Err::err_wexpr(expr);
@@ -990,7 +1041,7 @@ eval_expr_term_closure(ExprClosure *expr, std::shared_ptr<Ctx> &ctx, bool ref) {
     std::vector<std::pair<Token *, uint32_t>> args;
     for (auto &entry : expr->m_args) {
         if (entry.first->lexeme() != "_")
-            args.push_back(std::make_pair(entry.first.get(), entry.second));
+            args.push_back(std::make_pair(entry.first, entry.second));
     }
     auto cl = std::make_shared<earl::value::Closure>(expr, std::move(args), ctx);
     return ER(cl, ERT::Literal);
@@ -1002,8 +1053,11 @@ eval_expr_term_floatlit(ExprFloatLit *expr) {
     return ER(value, ERT::Literal);
 }
 
-static ER
-eval_expr_term_range(ExprRange *expr, std::shared_ptr<Ctx> &ctx, bool ref) {
+// Evaluates the bounds of a range as `[start, end)`. Ranges over
+// chars are given as their character codes. `end` is wider than
+// an int so that `a..=2147483647` does not overflow.
+static earl::value::Type
+eval_range_bounds(ExprRange *expr, std::shared_ptr<Ctx> &ctx, bool ref, int64_t &start, int64_t &end) {
     ER left_er = Interpreter::eval_expr(expr->m_start.get(), ctx, ref);
     ER right_er = Interpreter::eval_expr(expr->m_end.get(), ctx, ref);
     auto lvalue = unpack_ER(left_er, ctx, ref);
@@ -1016,41 +1070,42 @@ eval_expr_term_range(ExprRange *expr, std::shared_ptr<Ctx> &ctx, bool ref) {
         throw InterpreterException(msg);
     }
 
-    std::vector<std::shared_ptr<earl::value::Obj>> values = {};
-
     switch (lvalue->type()) {
     case earl::value::Type::Int: {
-        int start = dynamic_cast<earl::value::Int *>(lvalue.get())->value();
-        int end = dynamic_cast<earl::value::Int *>(rvalue.get())->value();
-        if (expr->m_inclusive) {
-            while (start <= end)
-                values.push_back(std::make_shared<earl::value::Int>(start++));
-        }
-        else {
-            while (start < end)
-                values.push_back(std::make_shared<earl::value::Int>(start++));
-        }
-        return ER(std::make_shared<earl::value::List>(values), ERT::Literal);
+        start = dynamic_cast<earl::value::Int *>(lvalue.get())->value();
+        end = dynamic_cast<earl::value::Int *>(rvalue.get())->value();
     } break;
     case earl::value::Type::Char: {
-        char start = dynamic_cast<earl::value::Char *>(lvalue.get())->value();
-        char end = dynamic_cast<earl::value::Char *>(rvalue.get())->value();
-        if (expr->m_inclusive) {
-            while (start <= end)
-                values.push_back(std::make_shared<earl::value::Char>(start++));
-        }
-        else {
-            while (start < end)
-                values.push_back(std::make_shared<earl::value::Char>(start++));
-        }
-        return ER(std::make_shared<earl::value::List>(values), ERT::Literal);
-    }
+        start = dynamic_cast<earl::value::Char *>(lvalue.get())->value();
+        end = dynamic_cast<earl::value::Char *>(rvalue.get())->value();
+    } break;
     default: {
         std::string msg = "invalid type "+earl::value::type_to_str(lvalue->type())+"` for type range";
         Err::err_wexpr(expr->m_start.get());
         throw InterpreterException(msg);
     } break;
     }
+
+    if (expr->m_inclusive)
+        ++end;
+    return lvalue->type();
+}
+
+static ER
+eval_expr_term_range(ExprRange *expr, std::shared_ptr<Ctx> &ctx, bool ref) {
+    int64_t start, end;
+    earl::value::Type ty = eval_range_bounds(expr, ctx, ref, start, end);
+
+    auto values = std::make_shared<earl::value::List>();
+    if (ty == earl::value::Type::Int) {
+        while (start < end)
+            values->append_scalar(earl::value::Scalar::of_int(static_cast<int>(start++)));
+    }
+    else {
+        while (start < end)
+            values->append_scalar(earl::value::Scalar::of_char(static_cast<char>(start++)));
+    }
+    return ER(values, ERT::Literal);
 }
 
 static ER
@@ -1144,7 +1199,7 @@ eval_expr_term_dict(ExprDict *expr, std::shared_ptr<Ctx> &ctx, bool ref) {
     } break;
     case earl::value::Type::Str: {
         auto dict = std::make_shared<earl::value::Dict<std::string>>(ty);
-        std::string __first_key = dynamic_cast<earl::value::Str *>(first_key.get())->value();
+        const std::string &__first_key = dynamic_cast<earl::value::Str *>(first_key.get())->value();
         dict->insert(__first_key, first_value);
 
         for (size_t i = 1; i < expr->m_values.size(); ++i) {
@@ -1159,7 +1214,7 @@ eval_expr_term_dict(ExprDict *expr, std::shared_ptr<Ctx> &ctx, bool ref) {
                 throw InterpreterException(msg);
             }
 
-            std::string __key = dynamic_cast<earl::value::Str *>(key.get())->value();
+            const std::string &__key = dynamic_cast<earl::value::Str *>(key.get())->value();
             dict->insert(__key, value);
         }
 
@@ -1211,6 +1266,36 @@ eval_expr_term_dict(ExprDict *expr, std::shared_ptr<Ctx> &ctx, bool ref) {
 
         return ER(dict, ERT::Literal);
     } break;
+    case earl::value::Type::Tuple: {
+        auto dict = std::make_shared<earl::value::Dict<earl::value::DictKey>>(ty);
+        dict->extract().reserve(expr->m_values.size());
+
+        for (size_t i = 0; i < expr->m_values.size(); ++i) {
+            std::shared_ptr<earl::value::Obj> key = first_key, value = first_value;
+            if (i != 0) {
+                ER key_er = Interpreter::eval_expr(expr->m_values.at(i).first.get(), ctx, false);
+                ER value_er = Interpreter::eval_expr(expr->m_values.at(i).second.get(), ctx, false);
+                key = unpack_ER(key_er, ctx, false);
+                value = unpack_ER(value_er, ctx, false);
+            }
+
+            if (key->type() != ty) {
+                const std::string msg = "all keys must be the same type in dictionaries";
+                Err::err_wexpr(expr->m_values.at(i).first.get());
+                throw InterpreterException(msg);
+            }
+
+            earl::value::DictKey __key;
+            if (!earl::value::DictKey::from(key.get(), __key)) {
+                const std::string msg = "tuple keys may only hold int, float, bool, char, str or tuple values";
+                Err::err_wexpr(expr->m_values.at(i).first.get());
+                throw InterpreterException(msg);
+            }
+            dict->insert(std::move(__key), value);
+        }
+
+        return ER(dict, ERT::Literal);
+    } break;
     default: {
         Err::err_wexpr(expr->m_values.at(0).first.get());
         const std::string msg = "type `"+earl::value::type_to_str(ty)+"` is not supported as a key in dictionaries";
@@ -1224,42 +1309,24 @@ eval_expr_term_dict(ExprDict *expr, std::shared_ptr<Ctx> &ctx, bool ref) {
 
 static ER
 eval_expr_term_fstr(ExprFStr *expr, std::shared_ptr<Ctx> &ctx, bool ref) {
-    const std::string &str = expr->m_tok->lexeme();
-    auto result = std::make_shared<earl::value::Str>();
-
-    auto until_closing = [](const std::string &s, size_t &it) -> std::string {
-        std::string buf = "";
-        while (it < s.size() && s[it] != '}') {
-            buf.push_back(s.at(it));
-            ++it;
-        }
-        return buf;
-    };
-
-    for (size_t i = 0; i < str.size(); ++i) {
-        char c = str.at(i);
-        if (c == '{') {
-            ++i;
-            std::string id = until_closing(str, i);
-            if (!ctx->variable_exists(id)) {
-                Err::err_wexpr(expr);
-
-                std::string msg = "variable `" + id + "` has not been defined\n";
-                auto avail = ctx->get_available_variable_names();
-                if (avail.size() != 0)
-                    msg += "did you mean: " + identifier_not_declared(id, avail) + "?";
-
-                throw InterpreterException(msg);
-            }
-            auto var = ctx->variable_get(id);
-            std::string strified = var->value()->to_cxxstring();
-            result->append(strified);
-        }
+    // Room for the text and a short value in every `{}`.
+    size_t len = expr->m_exprs.size() * 16;
+    for (auto &part : expr->m_parts)
+        len += part.size();
+
+    std::string result = expr->m_parts[0];
+    result.reserve(len);
+    for (size_t i = 0; i < expr->m_exprs.size(); ++i) {
+        ER er = Interpreter::eval_expr(expr->m_exprs[i].get(), ctx, ref);
+        auto value = unpack_ER(er, ctx, true);
+        if (value->type() == earl::value::Type::Str)
+            result += dynamic_cast<earl::value::Str *>(value.get())->view();
         else
-            result->append(c);
+            result += value->to_cxxstring();
+        result += expr->m_parts[i+1];
     }
 
-    return ER(result, ERT::Literal);
+    return ER(std::make_shared<earl::value::Str>(std::move(result)), ERT::Literal);
 }
 
 ER
@@ -1292,8 +1359,132 @@ eval_expr_term(ExprTerm *expr, std::shared_ptr<Ctx> &ctx, bool ref) {
     return ER(nullptr, ERT::None);
 }
 
+// Looks up the value of a variable for `eval_scalar`.
+// Returns nullptr if it is not a plain variable.
+static earl::value::Obj *
+scalar_ident_value(ExprIdent *ident, std::shared_ptr<Ctx> &ctx) {
+    std::shared_ptr<earl::variable::Obj> var = nullptr;
+    if (ctx->type() == CtxType::Function)
+        var = static_cast<FunctionCtx *>(ctx.get())->slot_get(ident->m_slot);
+    if (!var) {
+        const std::string &id = ident->m_tok->lexeme();
+        if (id == "_" || !ctx->variable_exists(id))
+            return nullptr;
+        var = ctx->variable_get(id);
+    }
+    return var->value().get();
+}
+
+// Evaluates an expression made only of scalar literals, variables
+// holding scalars and operators on them without boxing any of the
+// intermediate results. Nothing is evaluated that has side effects,
+// so on failure the caller can evaluate `expr` the normal way, which
+// also reports any errors.
+static bool
+eval_scalar(Expr *expr, std::shared_ptr<Ctx> &ctx, earl::value::Scalar &out) {
+    using earl::value::Scalar;
+
+    if (expr->m_const) {
+        out = Scalar::unbox(expr->m_const.get());
+        return out.tag != Scalar::Tag::None;
+    }
+
+    switch (expr->get_type()) {
+    case ExprType::Term: {
+        auto term = static_cast<ExprTerm *>(expr);
+        switch (term->get_term_type()) {
+        case ExprTermType::Ident: {
+            earl::value::Obj *value = scalar_ident_value(static_cast<ExprIdent *>(term), ctx);
+            if (!value)
+                return false;
+            out = Scalar::unbox(value);
+            return out.tag != Scalar::Tag::None;
+        }
+        case ExprTermType::Array_Access: {
+            // Only `list[idx]`, which reads packed lists without unpacking them.
+            auto access = static_cast<ExprArrayAccess *>(term);
+            Expr *left = access->m_left.get();
+            if (left->get_type() != ExprType::Term
+                || static_cast<ExprTerm *>(left)->get_term_type() != ExprTermType::Ident)
+                return false;
+            earl::value::Obj *value = scalar_ident_value(static_cast<ExprIdent *>(left), ctx);
+            Scalar idx;
+            if (!value || value->type() != earl::value::Type::List
+                || !eval_scalar(access->m_expr.get(), ctx, idx) || idx.tag != Scalar::Tag::Int)
+                return false;
+            return static_cast<earl::value::List *>(value)->scalar_at(idx.i, out);
+        }
+        case ExprTermType::Int_Literal: {
+            out = Scalar::of_int(std::stoi(static_cast<ExprIntLit *>(term)->m_tok->lexeme()));
+            return true;
+        }
+        case ExprTermType::Float_Literal: {
+            out = Scalar::of_float(std::stof(static_cast<ExprFloatLit *>(term)->m_tok->lexeme()));
+            return true;
+        }
+        case ExprTermType::Bool: {
+            out = Scalar::of_bool(static_cast<ExprBool *>(term)->m_value);
+            return true;
+        }
+        case ExprTermType::Char_Literal: {
+            out = Scalar::of_char(Optimizer::charlit_value(static_cast<ExprCharLit *>(term)));
+            return true;
+        }
+        default: return false;
+        }
+    }
+    case ExprType::Binary: {
+        auto bin = static_cast<ExprBinary *>(expr);
+        if (!bin->m_unboxed)
+            return false;
+        Scalar lhs, rhs;
+        if (!eval_scalar(bin->m_lhs.get(), ctx, lhs) || !eval_scalar(bin->m_rhs.get(), ctx, rhs)) {
+            bin->m_unboxed = false;
+            return false;
+        }
+        TokenType op = bin->m_op->type();
+        if (op == TokenType::Double_Ampersand || op == TokenType::Double_Pipe) {
+            bool cond;
+            if (!lhs.truthy(cond))
+                return false;
+            out = (op == TokenType::Double_Ampersand) == cond ? rhs : lhs;
+            return true;
+        }
+        return earl::value::scalar_binop(op, lhs, rhs, out);
+    }
+    case ExprType::Unary: {
+        auto unary = static_cast<ExprUnary *>(expr);
+        Scalar value;
+        return eval_scalar(unary->m_expr.get(), ctx, value)
+            && earl::value::scalar_unaryop(unary->m_op->type(), value, out);
+    }
+    default: return false;
+    }
+}
+
+// Evaluates the condition of an `if` or `while` without boxing it when
+// it is a scalar operation. Plain terms are left to the caller as they
+// may alias a variable.
+static bool
+eval_scalar_condition(Expr *expr, std::shared_ptr<Ctx> &ctx, bool &out) {
+    if (expr->get_type() == ExprType::Term)
+        return false;
+    earl::value::Scalar value;
+    return eval_scalar(expr, ctx, value) && value.truthy(out);
+}
+
 ER
 eval_expr_bin(ExprBinary *expr, std::shared_ptr<Ctx> &ctx, bool ref) {
+    // `&&` and `||` can yield their (unpacked later) left hand side, keep that as is.
+    if (expr->m_unboxed
+        && expr->m_op->type() != TokenType::Double_Ampersand
+        && expr->m_op->type() != TokenType::Double_Pipe) {
+        earl::value::Scalar value;
+        if (eval_scalar(expr, ctx, value))
+            return ER(value.box(), ERT::Literal);
+        expr->m_unboxed = false;
+    }
+
     ER lhs = Interpreter::eval_expr(expr->m_lhs.get(), ctx, ref);
     auto lhs_value = unpack_ER(lhs, ctx, true);
 
@@ -1317,7 +1508,7 @@ eval_expr_bin(ExprBinary *expr, std::shared_ptr<Ctx> &ctx, bool ref) {
 
     ER rhs = Interpreter::eval_expr(expr->m_rhs.get(), ctx, ref);
     auto rhs_value = unpack_ER(rhs, ctx, ref);
-    auto result = lhs_value->binop(expr->m_op.get(), rhs_value);
+    auto result = lhs_value->binop(expr->m_op, rhs_value);
     return ER(result, ERT::Literal);
 }
 
@@ -1325,12 +1516,15 @@ ER
 eval_expr_unary(ExprUnary *expr, std::shared_ptr<Ctx> &ctx, bool ref) {
     ER rhs = Interpreter::eval_expr(expr->m_expr.get(), ctx, ref);
     auto expr_value = unpack_ER(rhs, ctx, ref);
-    auto result = expr_value->unaryop(expr->m_op.get());
+    auto result = expr_value->unaryop(expr->m_op);
     return ER(result, ERT::Literal);
 }
 
 ER
 Interpreter::eval_expr(Expr *expr, std::shared_ptr<Ctx> &ctx, bool ref) {
+    if (expr->m_const)
+        return ER(Optimizer::instance(expr->m_const.get()), ERT::Literal);
+
     switch (expr->get_type()) {
     case ExprType::Term: {
         return eval_expr_term(dynamic_cast<ExprTerm *>(expr), ctx, ref);
@@ -1346,7 +1540,7 @@ Interpreter::eval_expr(Expr *expr, std::shared_ptr<Ctx> &ctx, bool ref) {
     }
 }
 
-std::shared_ptr<earl::value::Obj>
+SR
 eval_stmt_let_wmultiple_vars(StmtLet *stmt, std::shared_ptr<Ctx> &ctx) {
     if (ctx->type() == CtxType::Closure)
         // Special case for when we declare a variable in a recursive closure.
@@ -1358,7 +1552,7 @@ eval_stmt_let_wmultiple_vars(StmtLet *stmt, std::shared_ptr<Ctx> &ctx) {
             if (ctx->variable_exists(id->lexeme())) {
                 std::string msg = "variable `"+id->lexeme()+"` is already declared";
                 auto conflict = ctx->variable_get(id->lexeme());
-                Err::err_wconflict(stmt->m_ids.at(i).get(), conflict->gettok());
+                Err::err_wconflict(stmt->m_ids.at(i), conflict->gettok());
                 throw InterpreterException(msg);
                 ++i;
             }
@@ -1404,17 +1598,19 @@ eval_stmt_let_wmultiple_vars(StmtLet *stmt, std::shared_ptr<Ctx> &ctx) {
                 tuple->value().at(i)->set_const();
 
             std::shared_ptr<earl::variable::Obj> var
-                = std::make_shared<earl::variable::Obj>(stmt->m_ids.at(i).get(), tuple->value().at(i), stmt->m_attrs);
+                = std::make_shared<earl::variable::Obj>(stmt->m_ids.at(i), tuple->value().at(i), stmt->m_attrs);
             ctx->variable_add(var);
+            if (i < static_cast<int>(stmt->m_slots.size()))
+                bind_slot(stmt->m_slots[i], var, ctx);
         }
         ++i;
     }
 
     stmt->m_evald = true;
-    return std::make_shared<earl::value::Void>();
+    return {};
 }
 
-std::shared_ptr<earl::value::Obj>
+SR
 eval_stmt_let(StmtLet *stmt, std::shared_ptr<Ctx> &ctx) {
     if (stmt->m_ids.size() > 1)
         return eval_stmt_let_wmultiple_vars(stmt, ctx);
@@ -1428,7 +1624,7 @@ eval_stmt_let(StmtLet *stmt, std::shared_ptr<Ctx> &ctx) {
         if (ctx->variable_exists(id)) {
             std::string msg = "variable `"+id+"` is already declared";
             auto conflict = ctx->variable_get(id);
-            Err::err_wconflict(stmt->m_ids.at(0).get(), conflict->gettok());
+            Err::err_wconflict(stmt->m_ids.at(0), conflict->gettok());
             throw InterpreterException(msg);
         }
     }
@@ -1455,85 +1651,89 @@ eval_stmt_let(StmtLet *stmt, std::shared_ptr<Ctx> &ctx) {
     }
 
     if (id == "_")
-        return std::make_shared<earl::value::Void>();
+        return {};
 
     if (_const || value->type() == earl::value::Type::Tuple)
         value->set_const();
 
     std::shared_ptr<earl::variable::Obj> var
-        = std::make_shared<earl::variable::Obj>(stmt->m_ids.at(0).get(), value, stmt->m_attrs);
+        = std::make_shared<earl::variable::Obj>(stmt->m_ids.at(0), value, stmt->m_attrs);
     ctx->variable_add(var);
+    if (!stmt->m_slots.empty())
+        bind_slot(stmt->m_slots[0], var, ctx);
     stmt->m_evald = true;
-    return std::make_shared<earl::value::Void>();
+    return {};
 }
 
-std::shared_ptr<earl::value::Obj>
+SR
 eval_stmt_expr(StmtExpr *stmt, std::shared_ptr<Ctx> &ctx) {
     ER er = Interpreter::eval_expr(stmt->m_expr.get(), ctx, false);
     stmt->m_evald = true;
     auto value = unpack_ER(er, ctx, false);
-    if (value->type() == earl::value::Type::Return)
-        std::cout << "HERE" << std::endl;
-    if (value && value->type() != earl::value::Type::Void && ctx->type() != CtxType::World) {
+    if (!value || value->type() == earl::value::Type::Void)
+        return {};
+    if (ctx->type() != CtxType::World) {
         Err::err_wexpr(stmt->m_expr.get());
         Err::warn("Inplace expression will be evaluated and returned. Either explicitly `return` or assign the unused value to a unit binding: `let _ = <expr>;`");
     }
-    return value;
+    return {Flow::Return, value};
 }
 
-std::shared_ptr<earl::value::Obj>
+SR
 Interpreter::eval_stmt_block(StmtBlock *block, std::shared_ptr<Ctx> &ctx) {
-    std::shared_ptr<earl::value::Obj> result = nullptr;
+    SR result;
     ctx->push_scope();
 
     for (size_t i = 0; i < block->m_stmts.size(); ++i) {
         result = Interpreter::eval_stmt(block->m_stmts.at(i).get(), ctx);
-        if (result && result->type() != earl::value::Type::Void)
+        if (result.flow != Flow::Normal)
             break;
-        // if (block->m_stmts.at(i)->stmt_type() == StmtType::Return)
-        //     break;
-        if (block->m_stmts.at(i)->stmt_type() == StmtType::Return) {
-            if (!result || result->type() == earl::value::Type::Void) {
-                result = std::make_shared<earl::value::Return>();
-            }
-            break;
-        }
     }
 
     ctx->pop_scope();
     block->m_evald = true;
-    if (!result)
-        result = std::make_shared<earl::value::Void>();
     return result;
 }
 
 std::shared_ptr<earl::value::Obj>
+Interpreter::eval_body(StmtBlock *block, std::shared_ptr<Ctx> &ctx) {
+    SR result = Interpreter::eval_stmt_block(block, ctx);
+    if (result.flow == Flow::Return && result.value)
+        return result.value;
+    return std::make_shared<earl::value::Void>();
+}
+
+SR
 eval_stmt_def(StmtDef *stmt, std::shared_ptr<Ctx> &ctx) {
     const std::string &id = stmt->m_id->lexeme();
     if (ctx->function_exists(id)) {
         std::string msg = "function `"+id+"` has already been declared";
         auto conflict = ctx->function_get(id);
-        Err::err_wconflict(stmt->m_id.get(), conflict->gettok());
+        Err::err_wconflict(stmt->m_id, conflict->gettok());
         throw InterpreterException(msg);
     }
 
     std::vector<std::pair<Token *, uint32_t>> args;
     for (auto &entry : stmt->m_args)
-        args.push_back(std::make_pair(entry.first.get(), entry.second));
+        args.push_back(std::make_pair(entry.first, entry.second));
 
-    auto func = std::make_shared<earl::function::Obj>(stmt, args, stmt->m_id.get());
+    auto func = std::make_shared<earl::function::Obj>(stmt, args, stmt->m_id);
     ctx->function_add(func);
     stmt->m_evald = true;
-    return std::make_shared<earl::value::Void>();
+    return {};
 }
 
-std::shared_ptr<earl::value::Obj>
+SR
 eval_stmt_if(StmtIf *stmt, std::shared_ptr<Ctx> &ctx) {
-    auto er = Interpreter::eval_expr(stmt->m_expr.get(), ctx, false);
-    auto condition = unpack_ER(er, ctx, true); // POSSIBLE BREAK, WAS FALSE
-    std::shared_ptr<earl::value::Obj> result = nullptr;
+    SR result;
+    bool condition;
 
-    if (condition->boolean())
+    if (!eval_scalar_condition(stmt->m_expr.get(), ctx, condition)) {
+        auto er = Interpreter::eval_expr(stmt->m_expr.get(), ctx, false);
+        condition = unpack_ER(er, ctx, true)->boolean(); // POSSIBLE BREAK, WAS FALSE
+    }
+
+    if (condition)
         result = Interpreter::eval_stmt_block(stmt->m_block.get(), ctx);
     else if (stmt->m_else.has_value())
         result = Interpreter::eval_stmt_block(stmt->m_else.value().get(), ctx);
@@ -1542,29 +1742,31 @@ eval_stmt_if(StmtIf *stmt, std::shared_ptr<Ctx> &ctx) {
     return result;
 }
 
-std::shared_ptr<earl::value::Obj>
+SR
 eval_stmt_return(StmtReturn *stmt, std::shared_ptr<Ctx> &ctx) {
     if (stmt->m_expr.has_value()) {
         ER er = Interpreter::eval_expr(stmt->m_expr.value().get(), ctx, false);
         stmt->m_evald = true;
-        return unpack_ER(er, ctx, false);
+        return {Flow::Return, unpack_ER(er, ctx, false)};
     }
     stmt->m_evald = true;
-    return std::make_shared<earl::value::Void>();
+    return {Flow::Return};
 }
 
-std::shared_ptr<earl::value::Obj>
+SR
 eval_stmt_break(StmtBreak *stmt, std::shared_ptr<Ctx> &ctx) {
     (void)stmt;
     (void)ctx;
     stmt->m_evald = true;
-    return std::make_shared<earl::value::Break>();
+    return {Flow::Break};
 }
 
-std::shared_ptr<earl::value::Obj>
+SR
 eval_stmt_mut(StmtMut *stmt, std::shared_ptr<Ctx> &ctx) {
     ER left_er = Interpreter::eval_expr(stmt->m_left.get(), ctx, true);
-    ER right_er = Interpreter::eval_expr(stmt->m_right.get(), ctx, false);
+    earl::value::Scalar scalar;
+    bool unboxed = eval_scalar(stmt->m_right.get(), ctx, scalar);
+    ER right_er = unboxed ? ER(nullptr, ERT::Literal) : Interpreter::eval_expr(stmt->m_right.get(), ctx, false);
 
     if (left_er.is_tuple_access()) {
         Err::err_wexpr(stmt->m_left.get());
@@ -1574,7 +1776,18 @@ eval_stmt_mut(StmtMut *stmt, std::shared_ptr<Ctx> &ctx) {
     }
 
     auto l = unpack_ER(left_er, ctx, true);
-    auto r = unpack_ER(right_er, ctx, false);
+    std::shared_ptr<earl::value::Obj> r = nullptr;
+
+    if (unboxed) {
+        // Scalars are written into the left hand side in place.
+        if (earl::value::scalar_mutate(l.get(), stmt->m_equals->type(), scalar)) {
+            stmt->m_evald = true;
+            return {};
+        }
+        r = scalar.box();
+    }
+    else
+        r = unpack_ER(right_er, ctx, false);
 
     switch (stmt->m_equals->type()) {
     case TokenType::Equals: {
@@ -1588,117 +1801,214 @@ eval_stmt_mut(StmtMut *stmt, std::shared_ptr<Ctx> &ctx) {
     case TokenType::Backtick_Pipe_Equals:
     case TokenType::Backtick_Ampersand_Equals:
     case TokenType::Backtick_Caret_Equals: {
-        l->spec_mutate(stmt->m_equals.get(), r, stmt);
+        l->spec_mutate(stmt->m_equals, r, stmt);
     } break;
     default: {
-        Err::err_wtok(stmt->m_equals.get());
+        Err::err_wtok(stmt->m_equals);
         std::string msg = "invalid mutation operation `"+stmt->m_equals->lexeme()+"`";
         throw InterpreterException(msg);
     } break;
     }
     stmt->m_evald = true;
-    return std::make_shared<earl::value::Void>();
+    return {};
 }
 
-std::shared_ptr<earl::value::Obj>
+SR
 eval_stmt_while(StmtWhile *stmt, std::shared_ptr<Ctx> &ctx) {
-    std::shared_ptr<earl::value::Obj>
-        expr_result = nullptr,
-        result = nullptr;
-
-    ER expr_er = Interpreter::eval_expr(stmt->m_expr.get(), ctx, /*ref=*/false);
-    expr_result = unpack_ER(expr_er, ctx, /*ref=*/true);
+    std::shared_ptr<earl::value::Obj> expr_result = nullptr;
+    SR result;
+
+    // `&&` and `||` may yield a variable's value which `continue` below
+    // re-checks, so only other operators are evaluated unboxed.
+    Expr *cond = stmt->m_expr.get();
+    bool unboxed = cond->get_type() != ExprType::Binary
+        || (static_cast<ExprBinary *>(cond)->m_op->type() != TokenType::Double_Ampersand
+            && static_cast<ExprBinary *>(cond)->m_op->type() != TokenType::Double_Pipe);
+    bool condition;
+
+    if (unboxed && eval_scalar_condition(cond, ctx, condition))
+        expr_result = std::make_shared<earl::value::Bool>(condition);
+    else {
+        ER expr_er = Interpreter::eval_expr(cond, ctx, /*ref=*/false);
+        expr_result = unpack_ER(expr_er, ctx, /*ref=*/true);
+    }
 
     while (expr_result->boolean()) {
         result = Interpreter::eval_stmt_block(stmt->m_block.get(), ctx);
 
-        if (result && result->type() == earl::value::Type::Break) {
-            result = nullptr;
+        if (result.flow == Flow::Break) {
+            result = {};
             break;
         }
 
-        if (result && result->type() == earl::value::Type::Continue)
+        if (result.flow == Flow::Continue)
             continue;
 
-        if (result && result->type() != earl::value::Type::Void) {
+        if (result.flow == Flow::Return) {
             break;
         }
 
-        expr_er = Interpreter::eval_expr(stmt->m_expr.get(), ctx, /*ref=*/false);
+        if (unboxed && eval_scalar_condition(cond, ctx, condition)) {
+            if (!condition)
+                break;
+            continue;
+        }
+        ER expr_er = Interpreter::eval_expr(cond, ctx, /*ref=*/false);
         expr_result = unpack_ER(expr_er, ctx, /*ref=*/true);
         if (!expr_result->boolean())
             break;
     }
 
-    if (result && (result->type() == earl::value::Type::Continue || result->type() == earl::value::Type::Break))
-        result = std::make_shared<earl::value::Void>();
+    if (result.flow != Flow::Return)
+        result = {};
 
     stmt->m_evald = true;
     return result;
 }
 
-std::shared_ptr<earl::value::Obj>
+// Iterates `foreach i in a..b` without materializing the range as a
+// list. Each element is a fresh value unless the previous one is no
+// longer referenced by anything but the enumerator, then it is reused.
+static SR
+eval_stmt_foreach_range(StmtForeach *stmt, ExprRange *range, bool ref, std::shared_ptr<Ctx> &ctx) {
+    SR result;
+
+    int64_t start, end;
+    earl::value::Type ty = eval_range_bounds(range, ctx, ref, start, end);
+
+    // Checked even for an empty range, which is never bound.
+    const std::string &id = stmt->m_enumerator->lexeme();
+    if (ctx->variable_exists(id)) {
+        std::string msg = "variable `"+id+"` is already declared";
+        auto conflict = ctx->variable_get(id);
+        Err::err_wconflict(stmt->m_enumerator, conflict->gettok());
+        throw InterpreterException(msg);
+    }
+    if (start >= end) {
+        stmt->m_evald = true;
+        return result;
+    }
+
+    auto make = [ty](int value) -> std::shared_ptr<earl::value::Obj> {
+        if (ty == earl::value::Type::Int)
+            return std::make_shared<earl::value::Int>(value);
+        return std::make_shared<earl::value::Char>(static_cast<char>(value));
+    };
+
+    std::shared_ptr<earl::value::Obj> current = make(static_cast<int>(start));
+    auto enumerator = std::make_shared<earl::variable::Obj>(stmt->m_enumerator, current);
+    ctx->variable_add(enumerator);
+    bind_slot(stmt->m_slot, enumerator, ctx);
+
+    for (int64_t i = start; i < end; ++i) {
+        if (i != start) {
+            // Held by `current` and the enumerator only.
+            if (current.use_count() == 2 && !current->is_const()) {
+                if (ty == earl::value::Type::Int)
+                    static_cast<earl::value::Int *>(current.get())->fill(static_cast<int>(i));
+                else
+                    static_cast<earl::value::Char *>(current.get())->fill(static_cast<char>(i));
+            }
+            else {
+                current = make(static_cast<int>(i));
+                enumerator->reset(current);
+            }
+        }
+        result = Interpreter::eval_stmt_block(stmt->m_block.get(), ctx);
+        if (result.flow == Flow::Break) {
+            result = {};
+            break;
+        }
+        if (result.flow == Flow::Continue)
+            continue;
+        if (result.flow == Flow::Return)
+            break;
+    }
+    ctx->variable_remove(enumerator->id());
+
+    if (result.flow != Flow::Return)
+        result = {};
+
+    stmt->m_evald = true;
+    return result;
+}
+
+SR
 eval_stmt_foreach(StmtForeach *stmt, std::shared_ptr<Ctx> &ctx) {
     bool ref = (stmt->m_attrs & static_cast<uint32_t>(Attr::Ref)) != 0;
 
-    std::shared_ptr<earl::value::Obj> result = nullptr;
+    if (stmt->m_expr->get_type() == ExprType::Term
+        && static_cast<ExprTerm *>(stmt->m_expr.get())->get_term_type() == ExprTermType::Range)
+        return eval_stmt_foreach_range(stmt, static_cast<ExprRange *>(stmt->m_expr.get()), ref, ctx);
+
+    SR result;
     ER expr_er = Interpreter::eval_expr(stmt->m_expr.get(), ctx, ref);
     auto expr = unpack_ER(expr_er, ctx, ref);
 
     if (expr->type() == earl::value::Type::List) {
         auto lst = std::dynamic_pointer_cast<earl::value::List>(expr);
-        if (lst->value().size() == 0) {
+        if (lst->size() == 0) {
             stmt->m_evald = true;
             return result;
         }
-        auto enumerator = std::make_shared<earl::variable::Obj>(stmt->m_enumerator.get(), lst->value()[0]);
+        // Without `@ref` the loop is over a copy, which may still share
+        // its elements with the list, so each one is copied as it is
+        // reached. A packed list hands out new values anyway.
+        auto elem = [&](size_t i) {
+            if (ref)
+                return lst->elem_ref(i);
+            return lst->packed() ? lst->elem_value(i) : lst->elem_value(i)->copy();
+        };
+        auto enumerator = std::make_shared<earl::variable::Obj>(stmt->m_enumerator, elem(0));
         if (ctx->variable_exists(enumerator->id())) {
             std::string msg = "variable `"+stmt->m_enumerator->lexeme()+"` is already declared";
             auto conflict = ctx->variable_get(enumerator->id());
-            Err::err_wconflict(stmt->m_enumerator.get(), conflict->gettok());
+            Err::err_wconflict(stmt->m_enumerator, conflict->gettok());
             throw InterpreterException(msg);
         }
         ctx->variable_add(enumerator);
-        for (size_t i = 0; i < lst->value().size(); ++i) {
+        bind_slot(stmt->m_slot, enumerator, ctx);
+        for (size_t i = 0; i < lst->size(); ++i) {
             if (i != 0)
-                enumerator->reset(lst->value()[i]);
+                enumerator->reset(elem(i));
             result = Interpreter::eval_stmt_block(stmt->m_block.get(), ctx);
-            if (result && result->type() == earl::value::Type::Break) {
-                result = nullptr;
+            if (result.flow == Flow::Break) {
+                result = {};
                 break;
             }
-            if (result && result->type() == earl::value::Type::Continue)
+            if (result.flow == Flow::Continue)
                 continue;
-            if (result && result->type() != earl::value::Type::Void)
+            if (result.flow == Flow::Return)
                 break;
         }
         ctx->variable_remove(enumerator->id());
     }
     else if (expr->type() == earl::value::Type::Tuple) {
         auto tuple = std::dynamic_pointer_cast<earl::value::Tuple>(expr);
-        if (tuple->value().size() == 0) {
+        if (tuple->size() == 0) {
             stmt->m_evald = true;
             return result;
         }
-        auto enumerator = std::make_shared<earl::variable::Obj>(stmt->m_enumerator.get(), tuple->value()[0]);
+        auto enumerator = std::make_shared<earl::variable::Obj>(stmt->m_enumerator, tuple->at(0));
         if (ctx->variable_exists(enumerator->id())) {
             std::string msg = "variable `"+stmt->m_enumerator->lexeme()+"` is already declared";
             auto conflict = ctx->variable_get(enumerator->id());
-            Err::err_wconflict(stmt->m_enumerator.get(), conflict->gettok());
+            Err::err_wconflict(stmt->m_enumerator, conflict->gettok());
             throw InterpreterException(msg);
         }
         ctx->variable_add(enumerator);
-        for (size_t i = 0; i < tuple->value().size(); ++i) {
+        bind_slot(stmt->m_slot, enumerator, ctx);
+        for (size_t i = 0; i < tuple->size(); ++i) {
             if (i != 0)
-                enumerator->reset(tuple->value()[i]);
+                enumerator->reset(tuple->at(i));
             result = Interpreter::eval_stmt_block(stmt->m_block.get(), ctx);
-            if (result && result->type() == earl::value::Type::Break) {
-                result = nullptr;
+            if (result.flow == Flow::Break) {
+                result = {};
                 break;
             }
-            if (result && result->type() == earl::value::Type::Continue)
+            if (result.flow == Flow::Continue)
                 continue;
-            if (result && result->type() != earl::value::Type::Void)
+            if (result.flow == Flow::Return)
                 break;
         }
         ctx->variable_remove(enumerator->id());
@@ -1709,44 +2019,108 @@ eval_stmt_foreach(StmtForeach *stmt, std::shared_ptr<Ctx> &ctx) {
             stmt->m_evald = true;
             return result;
         }
-        auto enumerator = std::make_shared<earl::variable::Obj>(stmt->m_enumerator.get(), nullptr);
+        auto enumerator = std::make_shared<earl::variable::Obj>(stmt->m_enumerator, nullptr);
         if (ctx->variable_exists(enumerator->id())) {
             std::string msg = "variable `"+stmt->m_enumerator->lexeme()+"` is already declared";
             auto conflict = ctx->variable_get(enumerator->id());
-            Err::err_wconflict(stmt->m_enumerator.get(), conflict->gettok());
+            Err::err_wconflict(stmt->m_enumerator, conflict->gettok());
             throw InterpreterException(msg);
         }
         ctx->variable_add(enumerator);
+        bind_slot(stmt->m_slot, enumerator, ctx);
         for (size_t i = 0; i < str->value().size(); ++i) {
             enumerator->reset(str->__get_elem(i));
             result = Interpreter::eval_stmt_block(stmt->m_block.get(), ctx);
-            if (result && result->type() == earl::value::Type::Break) {
-                result = nullptr;
+            if (result.flow == Flow::Break) {
+                result = {};
                 break;
             }
-            if (result && result->type() == earl::value::Type::Continue)
+            if (result.flow == Flow::Continue)
                 continue;
-            if (result && result->type() != earl::value::Type::Void)
+            if (result.flow == Flow::Return)
+                break;
+        }
+        ctx->variable_remove(enumerator->id());
+    }
+    else if (expr->type() == earl::value::Type::Set) {
+        auto set = std::dynamic_pointer_cast<earl::value::Set>(expr);
+        if (set->size() == 0) {
+            stmt->m_evald = true;
+            return result;
+        }
+        auto enumerator = std::make_shared<earl::variable::Obj>(stmt->m_enumerator, set->elem(0));
+        if (ctx->variable_exists(enumerator->id())) {
+            std::string msg = "variable `"+stmt->m_enumerator->lexeme()+"` is already declared";
+            auto conflict = ctx->variable_get(enumerator->id());
+            Err::err_wconflict(stmt->m_enumerator, conflict->gettok());
+            throw InterpreterException(msg);
+        }
+        ctx->variable_add(enumerator);
+        bind_slot(stmt->m_slot, enumerator, ctx);
+        // The elements are unboxed, so each one is handed out as a new
+        // value (and `@ref` cannot change the set).
+        for (size_t i = 0; i < set->size(); ++i) {
+            if (i != 0)
+                enumerator->reset(set->elem(i));
+            result = Interpreter::eval_stmt_block(stmt->m_block.get(), ctx);
+            if (result.flow == Flow::Break) {
+                result = {};
+                break;
+            }
+            if (result.flow == Flow::Continue)
+                continue;
+            if (result.flow == Flow::Return)
+                break;
+        }
+        ctx->variable_remove(enumerator->id());
+    }
+    else if (expr->type() == earl::value::Type::Deque) {
+        auto deque = std::dynamic_pointer_cast<earl::value::Deque>(expr);
+        if (deque->size() == 0) {
+            stmt->m_evald = true;
+            return result;
+        }
+        auto enumerator = std::make_shared<earl::variable::Obj>(stmt->m_enumerator, deque->value()[0]);
+        if (ctx->variable_exists(enumerator->id())) {
+            std::string msg = "variable `"+stmt->m_enumerator->lexeme()+"` is already declared";
+            auto conflict = ctx->variable_get(enumerator->id());
+            Err::err_wconflict(stmt->m_enumerator, conflict->gettok());
+            throw InterpreterException(msg);
+        }
+        ctx->variable_add(enumerator);
+        bind_slot(stmt->m_slot, enumerator, ctx);
+        // Indexed so that pushes/pops in the body do not invalidate the loop.
+        for (size_t i = 0; i < deque->size(); ++i) {
+            if (i != 0)
+                enumerator->reset(deque->value()[i]);
+            result = Interpreter::eval_stmt_block(stmt->m_block.get(), ctx);
+            if (result.flow == Flow::Break) {
+                result = {};
+                break;
+            }
+            if (result.flow == Flow::Continue)
+                continue;
+            if (result.flow == Flow::Return)
                 break;
         }
         ctx->variable_remove(enumerator->id());
     }
     else {
-        std::string msg = "unable to perform a `for` loop with an expression other than a list, str, or tuple type";
+        std::string msg = "unable to perform a `for` loop with an expression other than a list, str, tuple, set, or deque type";
         Err::err_wexpr(stmt->m_expr.get());
         throw InterpreterException(msg);
     }
 
-    if (result && (result->type() == earl::value::Type::Continue || result->type() == earl::value::Type::Break))
-        result = std::make_shared<earl::value::Void>();
+    if (result.flow != Flow::Return)
+        result = {};
 
     stmt->m_evald = true;
     return result;
 }
 
-std::shared_ptr<earl::value::Obj>
+SR
 eval_stmt_for(StmtFor *stmt, std::shared_ptr<Ctx> &ctx) {
-    std::shared_ptr<earl::value::Obj> result = nullptr;
+    SR result;
 
     ER start_er = Interpreter::eval_expr(stmt->m_start.get(), ctx, false);
     ER end_er = Interpreter::eval_expr(stmt->m_end.get(), ctx, false);
@@ -1754,102 +2128,114 @@ eval_stmt_for(StmtFor *stmt, std::shared_ptr<Ctx> &ctx) {
     auto start_expr = unpack_ER(start_er, ctx, false); // DO NOT MAKE THIS TRUE! BREAKS LOOPS ENTIRELY
     auto end_expr = unpack_ER(end_er, ctx, true); // POSSIBLE BREAK, WAS FALSE
 
-    auto enumerator = std::make_shared<earl::variable::Obj>(stmt->m_enumerator.get(), start_expr);
+    if (start_expr->type() != earl::value::Type::Int || end_expr->type() != earl::value::Type::Int) {
+        Err::err_wtok(stmt->m_enumerator);
+        std::string msg = "the range of a `for` loop must be of type `int`";
+        throw InterpreterException(msg);
+    }
+
+    auto enumerator = std::make_shared<earl::variable::Obj>(stmt->m_enumerator, start_expr);
 
     if (ctx->variable_exists(enumerator->id())) {
         std::string msg = "variable `"+stmt->m_enumerator->lexeme()+"` is already declared";
         auto conflict = ctx->variable_get(enumerator->id());
-        Err::err_wconflict(stmt->m_enumerator.get(), conflict->gettok());
+        Err::err_wconflict(stmt->m_enumerator, conflict->gettok());
         throw InterpreterException(msg);
     }
     ctx->variable_add(enumerator);
+    bind_slot(stmt->m_slot, enumerator, ctx);
 
-    earl::value::Int *start = dynamic_cast<earl::value::Int *>(start_expr.get());
-    earl::value::Int *end = dynamic_cast<earl::value::Int *>(end_expr.get());
-
-    bool lt = start->value() <= end->value();
-    bool gt = start->value() > end->value();
-
-    while (true) {
-        if (lt && start->value() > end->value()-1)
-            break;
-        else if (gt && start->value() < end->value())
-            break;
+    // The enumerator is stepped in place, `end` is read every pass
+    // as it may alias a variable that the body changes.
+    auto *start = static_cast<earl::value::Int *>(start_expr.get());
+    auto *end = static_cast<earl::value::Int *>(end_expr.get());
+    const bool lt = start->value() <= end->value();
+    const int step = lt ? 1 : -1;
 
+    while (lt ? start->value() <= end->value()-1 : start->value() >= end->value()) {
         result = Interpreter::eval_stmt_block(stmt->m_block.get(), ctx);
 
-        if (result && result->type() == earl::value::Type::Break) {
-            result = nullptr;
+        if (result.flow == Flow::Break) {
+            result = {};
             break;
         }
 
-        if (result && result->type() == earl::value::Type::Continue) {
-            if (lt)
-                start->mutate(std::make_shared<earl::value::Int>(start->value()+1), nullptr);
-            else if (gt)
-                start->mutate(std::make_shared<earl::value::Int>(start->value()-1), nullptr);
-            continue;
-        }
-
-        if (result && result->type() != earl::value::Type::Void)
+        if (result.flow == Flow::Return)
             break;
 
-        if (lt)
-            start->mutate(std::make_shared<earl::value::Int>(start->value()+1), nullptr);
-        else if (gt)
-            start->mutate(std::make_shared<earl::value::Int>(start->value()-1), nullptr);
+        if (start->is_const())
+            // Reports the error.
+            start->mutate(std::make_shared<earl::value::Int>(start->value()+step), nullptr);
+        start->fill(start->value()+step);
     }
 
     ctx->variable_remove(enumerator->id());
 
-    if (result && (result->type() == earl::value::Type::Continue || result->type() == earl::value::Type::Break))
-        result = std::make_shared<earl::value::Void>();
+    if (result.flow != Flow::Return)
+        result = {};
 
     stmt->m_evald = true;
     return result;
 }
 
-std::shared_ptr<earl::value::Obj>
+SR
 eval_stmt_class(StmtClass *stmt, std::shared_ptr<Ctx> &ctx) {
     dynamic_cast<WorldCtx *>(ctx.get())->define_class(stmt);
     stmt->m_evald = true;
-    return std::make_shared<earl::value::Void>();
+    return {};
 }
 
-std::shared_ptr<earl::value::Obj>
+SR
 eval_stmt_mod(StmtMod *stmt, std::shared_ptr<Ctx> &ctx) {
     dynamic_cast<WorldCtx *>(ctx.get())->set_mod(stmt->m_id->lexeme());
     stmt->m_evald = true;
-    return std::make_shared<earl::value::Void>();
+    return {};
 }
 
-std::shared_ptr<earl::value::Obj>
+SR
 eval_stmt_import(StmtImport *stmt, std::shared_ptr<Ctx> &ctx) {
     if (ctx->type() != CtxType::World) {
-        Err::err_wtok(stmt->m_fp.get());
+        Err::err_wtok(stmt->m_fp);
         std::string msg = "`import` statements must be used in the @world context";
         throw InterpreterException(msg);
     }
 
-    std::vector<std::string> keywords = COMMON_EARLKW_ASCPL;
-    std::vector<std::string> types    = {};
-    std::string comment               = COMMON_EARL_COMMENT;
+    const std::string &fp = stmt->m_fp->lexeme();
+    std::string path = resolve_filepath(fp.c_str());
+    std::error_code ec;
+    auto canonical = std::filesystem::weakly_canonical(path, ec);
+    if (!ec)
+        path = canonical.string();
 
-    std::string src_code              = read_file(stmt->m_fp.get()->lexeme().c_str());
-    std::unique_ptr<Lexer> lexer      = lex_file(src_code,
-                                                 stmt->m_fp.get()->lexeme(),
-                                                 keywords,
-                                                 types,
-                                                 comment);
-    std::unique_ptr<Program> program  = Parser::parse_program(*lexer.get(), stmt->m_fp->lexeme());
+    // Each file is only lexed, parsed and evaluated once, and every
+    // later import of it shares that module.
+    std::shared_ptr<Ctx> child_ctx = WorldCtx::module_cache_get(path);
+    if ((flags & __SHOWIMPORTS) != 0)
+        std::cout << "[EARL show-import] " << (child_ctx ? "cached " : "") << path << '\n';
+
+    if (!child_ctx) {
+        std::vector<std::string> keywords = COMMON_EARLKW_ASCPL;
+        std::vector<std::string> types    = {};
+        std::string comment               = COMMON_EARL_COMMENT;
+
+        std::string src_code              = read_file(fp.c_str());
+        std::unique_ptr<Lexer> lexer      = earlc::lex(src_code,
+                                                       fp,
+                                                       keywords,
+                                                       types,
+                                                       comment);
+        std::unique_ptr<Program> program  = Parser::parse_program(*lexer.get(), fp);
+
+        child_ctx = Interpreter::interpret(std::move(program), std::move(lexer));
+        assert(child_ctx->type() == CtxType::World);
+        WorldCtx::module_cache_add(path, child_ctx);
+    }
 
-    std::shared_ptr<Ctx> child_ctx = Interpreter::interpret(std::move(program), std::move(lexer));
-    assert(child_ctx->type() == CtxType::World);
     if (stmt->__m_depth == COMMON_DEPTH_ALMOST)
-        dynamic_cast<WorldCtx *>(child_ctx.get())->strip_funs_and_classes();
+        child_ctx = WorldCtx::without_funs_and_classes(std::move(child_ctx));
     dynamic_cast<WorldCtx *>(ctx.get())->add_import(std::move(child_ctx));
     stmt->m_evald = true;
-    return std::make_shared<earl::value::Void>();
+    return {};
 }
 
 static std::shared_ptr<earl::variable::Obj>
@@ -1867,18 +2253,18 @@ handle_match_some_branch(ExprFuncCall *expr, std::shared_ptr<earl::value::Obj> i
     auto *ident = dynamic_cast<ExprIdent *>(term);
 
     if (ctx->variable_exists(ident->m_tok->lexeme())) {
-        Err::err_wtok(ident->m_tok.get());
+        Err::err_wtok(ident->m_tok);
         const std::string msg = "variable `"+ident->m_tok->lexeme()+"` in match statement is already declared";
         throw InterpreterException(msg);
     }
 
     auto unwrapped_value = dynamic_cast<earl::value::Option *>(inject_value.get())->value()->copy();
-    auto var = std::make_shared<earl::variable::Obj>(ident->m_tok.get(), unwrapped_value, 0);
+    auto var = std::make_shared<earl::variable::Obj>(ident->m_tok, unwrapped_value, 0);
 
     return var;
 }
 
-std::shared_ptr<earl::value::Obj>
+SR
 eval_stmt_match(StmtMatch *stmt, std::shared_ptr<Ctx> &ctx) {
     ER match_er = Interpreter::eval_expr(stmt->m_expr.get(), ctx, true);
     auto match_value = unpack_ER(match_er, ctx, true);
@@ -1946,21 +2332,21 @@ eval_stmt_match(StmtMatch *stmt, std::shared_ptr<Ctx> &ctx) {
     }
 
     stmt->m_evald = true;
-    return nullptr;
+    return {};
 }
 
-static std::shared_ptr<earl::value::Obj>
+static SR
 eval_stmt_enum(StmtEnum *stmt, std::shared_ptr<Ctx> &ctx) {
     if (ctx->type() != CtxType::World) {
         std::string msg = "enum statements are only allowed in the @world scope";
-        Err::err_wtok(stmt->m_id.get());
+        Err::err_wtok(stmt->m_id);
         throw InterpreterException(msg);
     }
 
     WorldCtx *wctx = dynamic_cast<WorldCtx *>(ctx.get());
 
     if (wctx->enum_exists(stmt->m_id->lexeme())) {
-        Err::err_wtok(stmt->m_id.get());
+        Err::err_wtok(stmt->m_id);
         std::string msg = "enum `"+stmt->m_id->lexeme()+"` is already declared";
         throw InterpreterException(msg);
     }
@@ -1978,14 +2364,14 @@ eval_stmt_enum(StmtEnum *stmt, std::shared_ptr<Ctx> &ctx) {
             auto value = unpack_ER(er, ctx, false);
             if (value->type() != earl::value::Type::Int)
                 mixed_types = true;
-            var = std::make_shared<earl::variable::Obj>(p.first.get(), value);
+            var = std::make_shared<earl::variable::Obj>(p.first, value);
             last_value = dynamic_cast<earl::value::Int *>(value.get());
         }
         else {
             found_unassigned = true;
             if (mixed_types) {
                 std::string msg = "if using datatypes other than integers inside of an enum, all entries must be explicitly assigned";
-                Err::err_wtok(p.first.get());
+                Err::err_wtok(p.first);
                 Err::err_wexpr(p.second.get());
                 throw InterpreterException(msg);
             }
@@ -1994,59 +2380,59 @@ eval_stmt_enum(StmtEnum *stmt, std::shared_ptr<Ctx> &ctx) {
                 actual = last_value->value()+1;
             auto value = std::make_shared<earl::value::Int>(actual);
             last_value = value.get();
-            var = std::make_shared<earl::variable::Obj>(p.first.get(), std::shared_ptr<earl::value::Obj>(value));
+            var = std::make_shared<earl::variable::Obj>(p.first, std::shared_ptr<earl::value::Obj>(value));
         }
         elems.insert({p.first->lexeme(), std::move(var)});
     }
 
     if (mixed_types && found_unassigned) {
         std::string msg = "if using datatypes other than integers inside of an enum, all entries must be explicitly assigned";
-        Err::err_wtok(stmt->m_id.get());
+        Err::err_wtok(stmt->m_id);
         throw InterpreterException(msg);
     }
 
     auto _enum = std::make_shared<earl::value::Enum>(stmt, std::move(elems), stmt->m_attrs);
     wctx->enum_add(std::move(_enum));
     stmt->m_evald = true;
-    return std::make_shared<earl::value::Void>();
+    return {};
 }
 
-static std::shared_ptr<earl::value::Obj>
+static SR
 eval_stmt_continue(Stmt *stmt, std::shared_ptr<Ctx> &ctx) {
     (void)stmt;
     (void)ctx;
     stmt->m_evald = true;
-    return std::make_shared<earl::value::Continue>();
+    return {Flow::Continue};
 }
 
-static std::shared_ptr<earl::value::Obj>
+static SR
 eval_stmt_loop(StmtLoop *stmt, std::shared_ptr<Ctx> &ctx) {
-    std::shared_ptr<earl::value::Obj> result = nullptr;
+    SR result;
 
     while (1) {
         result = Interpreter::eval_stmt_block(stmt->m_block.get(), ctx);
 
-        if (result && result->type() == earl::value::Type::Break) {
-            result = nullptr;
+        if (result.flow == Flow::Break) {
+            result = {};
             break;
         }
 
-        if (result && result->type() == earl::value::Type::Continue)
+        if (result.flow == Flow::Continue)
             continue;
 
-        if (result && result->type() != earl::value::Type::Void)
+        if (result.flow == Flow::Return)
             break;
     }
 
-    if (result && (result->type() == earl::value::Type::Continue || result->type() == earl::value::Type::Break))
-        result = std::make_shared<earl::value::Void>();
+    if (result.flow != Flow::Return)
+        result = {};
 
     stmt->m_evald = true;
 
     return result;
 }
 
-std::shared_ptr<earl::value::Obj>
+SR
 Interpreter::eval_stmt(Stmt *stmt, std::shared_ptr<Ctx> &ctx) {
     switch (stmt->stmt_type()) {
     case StmtType::Def:       return eval_stmt_def(dynamic_cast<StmtDef *>(stmt), ctx);
@@ -2071,7 +2457,7 @@ Interpreter::eval_stmt(Stmt *stmt, std::shared_ptr<Ctx> &ctx) {
     }
     std::string msg = "A serious internal error has ocured and has gotten to an unreachable case. Something is very wrong";
     throw InterpreterException(msg);
-    return nullptr;
+    return {};
 }
 
 std::shared_ptr<Ctx>
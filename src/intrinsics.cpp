@@ -64,6 +64,9 @@ Intrinsics::intrinsic_functions = {
     {"list", &Intrinsics::intrinsic_list},
     {"unit", &Intrinsics::intrinsic_unit},
     {"Dict", &Intrinsics::intrinsic_Dict},
+    {"Set", &Intrinsics::intrinsic_Set},
+    {"Deque", &Intrinsics::intrinsic_Deque},
+    {"Heap", &Intrinsics::intrinsic_Heap},
 };
 
 const std::unordered_map<std::string, Intrinsics::IntrinsicMemberFunction>
@@ -78,10 +81,23 @@ Intrinsics::intrinsic_member_functions = {
     {"pop", &Intrinsics::intrinsic_member_pop},
     {"contains", &Intrinsics::intrinsic_member_contains},
     {"map", &Intrinsics::intrinsic_member_map},
+    {"sum", &Intrinsics::intrinsic_member_sum},
+    {"min", &Intrinsics::intrinsic_member_min},
+    {"max", &Intrinsics::intrinsic_member_max},
+    {"index_of", &Intrinsics::intrinsic_member_index_of},
+    {"sort", &Intrinsics::intrinsic_member_sort},
+    {"sort_by", &Intrinsics::intrinsic_member_sort_by},
+    {"sorted", &Intrinsics::intrinsic_member_sorted},
     // Str
     {"split", &Intrinsics::intrinsic_member_split},
     {"substr", &Intrinsics::intrinsic_member_substr},
     {"trim", &Intrinsics::intrinsic_member_trim},// UNIMPLEMENTED
+    {"find", &Intrinsics::intrinsic_member_find},
+    {"rfind", &Intrinsics::intrinsic_member_rfind},
+    {"count", &Intrinsics::intrinsic_member_count},
+    {"replace", &Intrinsics::intrinsic_member_replace},
+    {"starts_with", &Intrinsics::intrinsic_member_starts_with},
+    {"ends_with", &Intrinsics::intrinsic_member_ends_with},
     {"remove_lines", &Intrinsics::intrinsic_member_remove_lines},// UNIMPLEMENTED
     // File
     {"dump", &Intrinsics::intrinsic_member_dump},
@@ -99,6 +115,20 @@ Intrinsics::intrinsic_member_functions = {
     {"insert", &Intrinsics::intrinsic_member_insert},
     {"has_key", &Intrinsics::intrinsic_member_has_key},
     {"has_value", &Intrinsics::intrinsic_member_has_value},
+    // Set
+    {"remove", &Intrinsics::intrinsic_member_remove},
+    {"union", &Intrinsics::intrinsic_member_union},
+    {"intersection", &Intrinsics::intrinsic_member_intersection},
+    {"difference", &Intrinsics::intrinsic_member_difference},
+    // Deque
+    {"push_back", &Intrinsics::intrinsic_member_push_back},
+    {"push_front", &Intrinsics::intrinsic_member_push_front},
+    {"pop_back", &Intrinsics::intrinsic_member_pop_back},
+    {"pop_front", &Intrinsics::intrinsic_member_pop_front},
+    {"front", &Intrinsics::intrinsic_member_front},
+    // Heap
+    {"push", &Intrinsics::intrinsic_member_push},
+    {"peek", &Intrinsics::intrinsic_member_peek},
 };
 
 std::shared_ptr<earl::value::Obj>
@@ -131,7 +161,11 @@ Intrinsics::is_member_intrinsic(const std::string &id, int ty) {
     case earl::value::Type::DictInt:
     case earl::value::Type::DictStr:
     case earl::value::Type::DictChar:
-    case earl::value::Type::DictFloat: return Intrinsics::intrinsic_dict_member_functions.find(id) != Intrinsics::intrinsic_dict_member_functions.end();
+    case earl::value::Type::DictFloat:
+    case earl::value::Type::DictTuple: return Intrinsics::intrinsic_dict_member_functions.find(id) != Intrinsics::intrinsic_dict_member_functions.end();
+    case earl::value::Type::Set: return Intrinsics::intrinsic_set_member_functions.find(id) != Intrinsics::intrinsic_set_member_functions.end();
+    case earl::value::Type::Deque: return Intrinsics::intrinsic_deque_member_functions.find(id) != Intrinsics::intrinsic_deque_member_functions.end();
+    case earl::value::Type::Heap: return Intrinsics::intrinsic_heap_member_functions.find(id) != Intrinsics::intrinsic_heap_member_functions.end();
     default: return false;
     }
     return Intrinsics::intrinsic_member_functions.find(id) != Intrinsics::intrinsic_member_functions.end();
@@ -157,7 +191,11 @@ Intrinsics::call_member(const std::string &id,
     case earl::value::Type::DictInt:
     case earl::value::Type::DictStr:
     case earl::value::Type::DictChar:
-    case earl::value::Type::DictFloat: return Intrinsics::intrinsic_dict_member_functions.at(id)(accessor, params, ctx, expr);
+    case earl::value::Type::DictFloat:
+    case earl::value::Type::DictTuple: return Intrinsics::intrinsic_dict_member_functions.at(id)(accessor, params, ctx, expr);
+    case earl::value::Type::Set: return Intrinsics::intrinsic_set_member_functions.at(id)(accessor, params, ctx, expr);
+    case earl::value::Type::Deque: return Intrinsics::intrinsic_deque_member_functions.at(id)(accessor, params, ctx, expr);
+    case earl::value::Type::Heap: return Intrinsics::intrinsic_heap_member_functions.at(id)(accessor, params, ctx, expr);
     default: assert(false);
     }
 }
@@ -196,7 +234,7 @@ Intrinsics::intrinsic_int(std::vector<std::shared_ptr<earl::value::Obj>> &params
         return std::make_shared<earl::value::Int>(static_cast<int>(f));
     } break;
     case earl::value::Type::Str: {
-        std::string s = dynamic_cast<earl::value::Str *>(params[0].get())->value();
+        const std::string &s = dynamic_cast<earl::value::Str *>(params[0].get())->value();
         return std::make_shared<earl::value::Int>(std::stoi(s));
     } break;
     case earl::value::Type::Char: {
@@ -240,7 +278,7 @@ Intrinsics::intrinsic_float(std::vector<std::shared_ptr<earl::value::Obj>> &para
         return std::make_shared<earl::value::Float>(f);
     } break;
     case earl::value::Type::Str: {
-        std::string s = dynamic_cast<earl::value::Str *>(params[0].get())->value();
+        const std::string &s = dynamic_cast<earl::value::Str *>(params[0].get())->value();
         return std::make_shared<earl::value::Float>(std::stof(s));
     } break;
     default: {
@@ -276,7 +314,7 @@ Intrinsics::intrinsic_bool(std::vector<std::shared_ptr<earl::value::Obj>> &param
         return std::make_shared<earl::value::Bool>(static_cast<bool>(f));
     } break;
     case earl::value::Type::Str: {
-        std::string s = dynamic_cast<earl::value::Str *>(params[0].get())->value();
+        const std::string &s = dynamic_cast<earl::value::Str *>(params[0].get())->value();
         if (s == COMMON_EARLKW_TRUE)
             return std::make_shared<earl::value::Bool>(true);
         else if (s == COMMON_EARLKW_FALSE)
@@ -333,7 +371,8 @@ Intrinsics::intrinsic_Dict(std::vector<std::shared_ptr<earl::value::Obj>> &param
     case earl::value::Type::Int: return std::make_shared<earl::value::Dict<int>>(ty);
     case earl::value::Type::Str: return std::make_shared<earl::value::Dict<std::string>>(ty);
     case earl::value::Type::Char: return std::make_shared<earl::value::Dict<char>>(ty);
-    case earl::value::Type::Float: return std::make_shared<earl::value::Dict<float>>(ty);
+    case earl::value::Type::Float: return std::make_shared<earl::value::Dict<double>>(ty);
+    case earl::value::Type::Tuple: return std::make_shared<earl::value::Dict<earl::value::DictKey>>(ty);
     default: {
         Err::err_wexpr(expr);
         const std::string msg = "cannot create an empty dictionary of type `"+earl::value::type_to_str(ty)+"` (unsupported)";
@@ -345,6 +384,108 @@ Intrinsics::intrinsic_Dict(std::vector<std::shared_ptr<earl::value::Obj>> &param
     return nullptr; // unreachable
 }
 
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_Set(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                          std::shared_ptr<Ctx> &ctx,
+                          Expr *expr) {
+    (void)ctx;
+    auto set = std::make_shared<earl::value::Set>();
+    if (params.size() == 0)
+        return set;
+
+    __INTR_ARGS_MUSTBE_SIZE(params, 1, "Set", expr);
+    {
+        std::vector<earl::value::Type> lst = {earl::value::Type::List, earl::value::Type::Tuple};
+        __MEMBER_INTR_ARG_MUSTBE_TYPE_COMPAT_OR_LST(params[0], lst, 1, "Set", expr);
+    }
+
+    if (params[0]->type() == earl::value::Type::List) {
+        auto list = dynamic_cast<earl::value::List *>(params[0].get());
+        for (size_t i = 0; i < list->size(); ++i) {
+            auto value = list->elem_value(i);
+            set->insert(value, expr);
+        }
+    }
+    else {
+        for (auto &value : dynamic_cast<earl::value::Tuple *>(params[0].get())->value())
+            set->insert(value, expr);
+    }
+    return set;
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_Deque(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                            std::shared_ptr<Ctx> &ctx,
+                            Expr *expr) {
+    (void)ctx;
+    auto deque = std::make_shared<earl::value::Deque>();
+    if (params.size() == 0)
+        return deque;
+
+    __INTR_ARGS_MUSTBE_SIZE(params, 1, "Deque", expr);
+    {
+        std::vector<earl::value::Type> lst = {earl::value::Type::List, earl::value::Type::Tuple};
+        __MEMBER_INTR_ARG_MUSTBE_TYPE_COMPAT_OR_LST(params[0], lst, 1, "Deque", expr);
+    }
+
+    if (params[0]->type() == earl::value::Type::List) {
+        auto list = dynamic_cast<earl::value::List *>(params[0].get());
+        for (size_t i = 0; i < list->size(); ++i)
+            deque->push_back(list->elem_value(i)->copy());
+    }
+    else {
+        for (auto &value : dynamic_cast<earl::value::Tuple *>(params[0].get())->value())
+            deque->push_back(value->copy());
+    }
+    return deque;
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_Heap(std::vector<std::shared_ptr<earl::value::Obj>> &params,
+                           std::shared_ptr<Ctx> &ctx,
+                           Expr *expr) {
+    if (params.size() > 2) {
+        Err::err_wexpr(expr);
+        const std::string msg = "function `Heap` expects at most 2 arguments but "+std::to_string(params.size())+" were supplied";
+        throw InterpreterException(msg);
+    }
+
+    // Heap([init: list], [f: closure])
+    std::shared_ptr<earl::value::Obj> init = nullptr, f = nullptr;
+    for (size_t i = 0; i < params.size(); ++i) {
+        if (params[i]->type() == earl::value::Type::List && !init && !f)
+            init = params[i];
+        else if (params[i]->type() == earl::value::Type::Closure && !f)
+            f = params[i];
+        else {
+            Err::err_wexpr(expr);
+            const std::string msg = "function `Heap` expects an optional `list` followed by an optional `closure` but got `"
+                +earl::value::type_to_str(params[i]->type())+"` for argument "+std::to_string(i+1);
+            throw InterpreterException(msg);
+        }
+    }
+
+    if (f) {
+        size_t n = dynamic_cast<earl::value::Closure *>(f.get())->params_len();
+        if (n != 1 && n != 2) {
+            Err::err_wexpr(expr);
+            const std::string msg = "the closure given to `Heap` must take 1 (key) or 2 (comparator) arguments, not "+std::to_string(n);
+            throw InterpreterException(msg);
+        }
+    }
+
+    auto heap = std::make_shared<earl::value::Heap>(f);
+    if (init) {
+        auto list = dynamic_cast<earl::value::List *>(init.get());
+        std::vector<std::shared_ptr<earl::value::Obj>> values = {};
+        values.reserve(list->size());
+        for (size_t i = 0; i < list->size(); ++i)
+            values.push_back(list->elem_value(i)->copy());
+        heap->extend(values, ctx, expr);
+    }
+    return heap;
+}
+
 std::shared_ptr<earl::value::Obj>
 Intrinsics::intrinsic_len(std::vector<std::shared_ptr<earl::value::Obj>> &params,
                           std::shared_ptr<Ctx> &ctx,
@@ -352,22 +493,35 @@ Intrinsics::intrinsic_len(std::vector<std::shared_ptr<earl::value::Obj>> &params
     (void)ctx;
     __INTR_ARGS_MUSTBE_SIZE(params, 1, "len", expr);
     {
-        std::vector<earl::value::Type> lst = {earl::value::Type::List, earl::value::Type::Str, earl::value::Type::Tuple};
+        std::vector<earl::value::Type> lst = {earl::value::Type::List, earl::value::Type::Str, earl::value::Type::Tuple,
+                                              earl::value::Type::Set, earl::value::Type::Deque, earl::value::Type::Heap};
         __MEMBER_INTR_ARG_MUSTBE_TYPE_COMPAT_OR_LST(params[0], lst, 1, "len", expr);
     }
     auto &item = params[0];
     if (item->type() == earl::value::Type::List) {
-        size_t sz = dynamic_cast<earl::value::List *>(item.get())->value().size();
+        size_t sz = dynamic_cast<earl::value::List *>(item.get())->size();
         return std::make_shared<earl::value::Int>(static_cast<int>(sz));
     }
     else if (item->type() == earl::value::Type::Str) {
-        size_t sz = dynamic_cast<earl::value::Str *>(item.get())->value().size();
+        size_t sz = dynamic_cast<earl::value::Str *>(item.get())->size();
         return std::make_shared<earl::value::Int>(static_cast<int>(sz));
     }
     else if (item->type() == earl::value::Type::Tuple) {
         size_t sz = dynamic_cast<earl::value::Tuple *>(item.get())->value().size();
         return std::make_shared<earl::value::Int>(static_cast<int>(sz));
     }
+    else if (item->type() == earl::value::Type::Set) {
+        size_t sz = dynamic_cast<earl::value::Set *>(item.get())->size();
+        return std::make_shared<earl::value::Int>(static_cast<int>(sz));
+    }
+    else if (item->type() == earl::value::Type::Deque) {
+        size_t sz = dynamic_cast<earl::value::Deque *>(item.get())->size();
+        return std::make_shared<earl::value::Int>(static_cast<int>(sz));
+    }
+    else if (item->type() == earl::value::Type::Heap) {
+        size_t sz = dynamic_cast<earl::value::Heap *>(item.get())->size();
+        return std::make_shared<earl::value::Int>(static_cast<int>(sz));
+    }
     assert(false && "unreachable");
     return nullptr;
 }
@@ -530,10 +684,14 @@ Intrinsics::intrinsic_panic(std::vector<std::shared_ptr<earl::value::Obj>> &para
 }
 
 static void
-__intrinsic_print(std::shared_ptr<earl::value::Obj> param, std::ostream *stream = nullptr) {
+__intrinsic_print(const std::shared_ptr<earl::value::Obj> &param, std::ostream *stream = nullptr) {
     if (stream == nullptr)
         stream = &std::cout;
-    *stream << param->to_cxxstring();
+    // Strs are written as they are, without a copy.
+    if (param->type() == earl::value::Type::Str)
+        *stream << dynamic_cast<earl::value::Str *>(param.get())->view();
+    else
+        *stream << param->to_cxxstring();
 }
 
 std::shared_ptr<earl::value::Obj>
@@ -672,7 +830,7 @@ Intrinsics::intrinsic_open(std::vector<std::shared_ptr<earl::value::Obj>> &param
     std::fstream stream;
     std::ios_base::openmode om{};
 
-    for (char &c : mode->value()) {
+    for (char c : mode->value()) {
         switch (c) {
         case 'r': om |= std::ios::in; break;
         case 'w': om |= std::ios::out; break;
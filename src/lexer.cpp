@@ -23,11 +23,15 @@
 // SOFTWARE.
 
 #include <algorithm>
+#include <array>
 #include <cassert>
+#include <cstring>
 #include <stdexcept>
 #include <string>
-#include <unordered_map>
-#include <functional>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #include "err.hpp"
 #include "token.hpp"
@@ -36,131 +40,256 @@
 #include "common.hpp"
 #include "config.h"
 
-Lexer::Lexer() : m_hd(nullptr), m_tl(nullptr), m_len(0) {}
+Lexer::Lexer() : m_toks(), m_pos(0) {}
 
-void Lexer::append(std::shared_ptr<Token> tok) {
-    if (!m_hd) {
-        m_hd = tok;
-        m_tl = m_hd.get();
-    } else {
-        m_tl->m_next = tok;
-        m_tl = m_tl->m_next.get();
-    }
-    ++m_len;
+void Lexer::append(Token tok) {
+    m_toks.push_back(std::move(tok));
 }
 
-void Lexer::append(std::string lexeme, TokenType type, size_t row, size_t col, std::string fp) {
-    auto tok = std::make_shared<Token>(lexeme, type, row, col, fp);
-    this->append(std::move(tok));
+void Lexer::append(std::string lexeme, TokenType type, size_t row, size_t col, uint32_t file) {
+    m_toks.emplace_back(std::move(lexeme), type, row, col, file);
 }
 
 Token *Lexer::peek(size_t n) {
-    Token *tok = m_hd.get();
-    for (size_t i = 0; i < n && tok; ++i) {
-        if (!tok)
-            return nullptr;
-        tok = tok->m_next.get();
-    }
-    return tok;
+    if (m_pos+n >= m_toks.size())
+        return nullptr;
+    return &m_toks[m_pos+n];
 }
 
-std::shared_ptr<Token> Lexer::next(void) {
-    if (!m_hd)
+Token *Lexer::next(void) {
+    if (m_pos >= m_toks.size())
         return nullptr;
-
-    std::shared_ptr<Token> tok = m_hd;
-    m_hd = tok->m_next;
-
-    if (!m_hd)
-        m_tl = nullptr;
-
-    --m_len;
-    return tok;
+    return &m_toks[m_pos++];
 }
 
 void Lexer::discard(void) {
-    if (!m_hd)
-        return;
-    m_hd = m_hd->m_next;
+    if (m_pos < m_toks.size())
+        ++m_pos;
 }
 
 void Lexer::dump(void) {
-    Token *it = m_hd.get();
-    while (it) {
+    for (size_t i = m_pos; i < m_toks.size(); ++i) {
+        Token *it = &m_toks[i];
         printf("lexeme: \"%s\", type: %s, row: %zu, col: %zu, fp: %s\n",
-               it->m_lexeme.c_str(), tokentype_to_str(it->type()).c_str(), it->m_row, it->m_col, it->m_fp.c_str());
-        it = it->m_next.get();
+               it->m_lexeme.c_str(), tokentype_to_str(it->type()).c_str(), it->m_row, it->m_col, it->fp().c_str());
     }
 }
 
-static size_t consume_until(const std::string &s, const std::function<bool(char)> &predicate) {
-    size_t i;
-    bool skip = false;
-    for (i = 0; s[i]; ++i) {
-        if (!skip && predicate(s[i]))
-            return i;
-        if (s[i] == '\\')
-            skip = true;
-        else
-            skip = false;
-    }
-    return i;
+enum CharClass : uint8_t {
+    CC_ALPHA = 1 << 0, // a-z, A-Z and `_`
+    CC_DIGIT = 1 << 1,
+    CC_BLANK = 1 << 2, // ` `, `\t` and the `\r` of CRLF line endings
+};
+
+static constexpr std::array<uint8_t, 256>
+make_char_classes(void) {
+    std::array<uint8_t, 256> t = {};
+    for (int c = 'a'; c <= 'z'; ++c)
+        t[c] |= CC_ALPHA;
+    for (int c = 'A'; c <= 'Z'; ++c)
+        t[c] |= CC_ALPHA;
+    t['_'] |= CC_ALPHA;
+    for (int c = '0'; c <= '9'; ++c)
+        t[c] |= CC_DIGIT;
+    t[' '] |= CC_BLANK;
+    t['\t'] |= CC_BLANK;
+    t['\r'] |= CC_BLANK;
+    return t;
 }
 
-static size_t find_comment_end(char *s) {
-    size_t i;
-    for (i = 0; s[i]; ++i)
-        if (s[i] == '\n')
-            return i;
-    return i;
+static constexpr std::array<uint8_t, 256> char_classes = make_char_classes();
+
+static inline bool
+is_cc(char c, uint8_t cls) {
+    return (char_classes[static_cast<unsigned char>(c)] & cls) != 0;
 }
 
-static bool
-is_keyword(char *s, size_t len, std::vector<std::string> &keywords) {
-    std::string word(s, len);
-    for (std::string &kw : keywords)
-        if (word == kw)
-            return true;
-    return false;
+/// @brief Get the first byte in [p, end) that is not a blank,
+/// or `end` if there is none.
+static const char *
+skip_blanks(const char *p, const char *end) {
+#ifdef __SSE2__
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i cr = _mm_set1_epi8('\r');
+    while (end-p >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        __m128i blank = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, tab)),
+                                     _mm_cmpeq_epi8(chunk, cr));
+        unsigned mask = ~static_cast<unsigned>(_mm_movemask_epi8(blank)) & 0xFFFF;
+        if (mask)
+            return p + __builtin_ctz(mask);
+        p += 16;
+    }
+#endif
+    while (p < end && is_cc(*p, CC_BLANK))
+        ++p;
+    return p;
 }
 
-static bool
-is_type(char *s, size_t len, std::vector<std::string> &types) {
-    std::string word(s, len);
-    for (std::string &ty : types)
-        if (word == ty)
-            return true;
-    return false;
+/// @brief Get the first `c` in [p, end), or `end` if there is none.
+static const char *
+find_byte(const char *p, const char *end, char c) {
+    // memchr is vectorised by the C library for the host CPU.
+    const void *found = memchr(p, c, end-p);
+    return found ? static_cast<const char *>(found) : end;
 }
 
-static bool
-issym(char c) {
-    return !isalnum(c) && c != '_';
+/// @brief Get the length of the body of the string literal starting
+/// at `p`, namely everything up to the first `"` not directly
+/// preceded by a `\`.
+static size_t
+strlit_body_len(const char *p, const char *end) {
+    const char *it = p;
+    while (true) {
+        it = find_byte(it, end, '"');
+        if (it == end || it == p || *(it-1) != '\\')
+            return it-p;
+        ++it;
+    }
 }
 
+/// @brief Look up the operator spelled by the `len` bytes at `s`.
+/// Every operator is at most three bytes, so the first two bytes
+/// select the candidate directly and the third is checked by hand.
 static bool
-try_comment(char *src, std::string &comment) {
-    if (std::string(src).compare(0, comment.length(), comment) == 0)
-        return find_comment_end(src);
-    return false;
+lookup_op(const char *s, size_t len, TokenType &type) {
+    char a = s[0], b = len > 1 ? s[1] : '\0', c = len > 2 ? s[2] : '\0';
+
+    if (len == 3) {
+        if (a != '`' || c != '=')
+            return false;
+        switch (b) {
+        case '|': type = TokenType::Backtick_Pipe_Equals; return true;
+        case '&': type = TokenType::Backtick_Ampersand_Equals; return true;
+        case '^': type = TokenType::Backtick_Caret_Equals; return true;
+        default: return false;
+        }
+    }
+
+    if (len == 2) {
+        switch (a) {
+        case '&': if (b == '&') { type = TokenType::Double_Ampersand; return true; } break;
+        case '|': if (b == '|') { type = TokenType::Double_Pipe; return true; } break;
+        case '>':
+            if (b == '=') { type = TokenType::Greaterthan_Equals; return true; }
+            if (b == '>') { type = TokenType::Double_Greaterthan; return true; }
+            break;
+        case '<':
+            if (b == '=') { type = TokenType::Lessthan_Equals; return true; }
+            if (b == '<') { type = TokenType::Double_Lessthan; return true; }
+            break;
+        case '=': if (b == '=') { type = TokenType::Double_Equals; return true; } break;
+        case '!': if (b == '=') { type = TokenType::Bang_Equals; return true; } break;
+        case '+': if (b == '=') { type = TokenType::Plus_Equals; return true; } break;
+        case '-':
+            if (b == '=') { type = TokenType::Minus_Equals; return true; }
+            if (b == '>') { type = TokenType::RightArrow; return true; }
+            break;
+        case '*':
+            if (b == '=') { type = TokenType::Asterisk_Equals; return true; }
+            if (b == '*') { type = TokenType::Double_Asterisk; return true; }
+            break;
+        case '/': if (b == '=') { type = TokenType::Forwardslash_Equals; return true; } break;
+        case '%': if (b == '=') { type = TokenType::Percent_Equals; return true; } break;
+        case '.': if (b == '.') { type = TokenType::Double_Period; return true; } break;
+        case ':': if (b == ':') { type = TokenType::Double_Colon; return true; } break;
+        case '`':
+            switch (b) {
+            case '|': type = TokenType::Backtick_Pipe; return true;
+            case '&': type = TokenType::Backtick_Ampersand; return true;
+            case '~': type = TokenType::Backtick_Tilde; return true;
+            case '^': type = TokenType::Backtick_Caret; return true;
+            default: break;
+            }
+            break;
+        default: break;
+        }
+        return false;
+    }
+
+    switch (a) {
+    case '(': type = TokenType::Lparen; return true;
+    case ')': type = TokenType::Rparen; return true;
+    case '[': type = TokenType::Lbracket; return true;
+    case ']': type = TokenType::Rbracket; return true;
+    case '{': type = TokenType::Lbrace; return true;
+    case '}': type = TokenType::Rbrace; return true;
+    case '#': type = TokenType::Hash; return true;
+    case '.': type = TokenType::Period; return true;
+    case ';': type = TokenType::Semicolon; return true;
+    case ',': type = TokenType::Comma; return true;
+    case '>': type = TokenType::Greaterthan; return true;
+    case '<': type = TokenType::Lessthan; return true;
+    case '=': type = TokenType::Equals; return true;
+    case '&': type = TokenType::Ampersand; return true;
+    case '*': type = TokenType::Asterisk; return true;
+    case '+': type = TokenType::Plus; return true;
+    case '-': type = TokenType::Minus; return true;
+    case '/': type = TokenType::Forwardslash; return true;
+    case '|': type = TokenType::Pipe; return true;
+    case '^': type = TokenType::Caret; return true;
+    case '?': type = TokenType::Questionmark; return true;
+    case '\\': type = TokenType::Backwardslash; return true;
+    case '!': type = TokenType::Bang; return true;
+    case '@': type = TokenType::At; return true;
+    case '$': type = TokenType::Dollarsign; return true;
+    case '%': type = TokenType::Percent; return true;
+    case '`': type = TokenType::Backtick; return true;
+    case '~': type = TokenType::Tilde; return true;
+    case ':': type = TokenType::Colon; return true;
+    default: return false;
+    }
 }
 
-char *
-read_file(const char *filepath) {
-    const char *search_path = PREFIX "/include/EARL/";
+/// @brief A fixed size open addressing set of the keywords,
+/// hashed on their length and first and last bytes.
+struct KeywordTable {
+    static constexpr size_t CAP = 128;
+    const std::string *m_slots[CAP] = {};
 
-    char full_path[256];
-    snprintf(full_path, sizeof(full_path), "%s%s", search_path, filepath);
+    static size_t
+    hash(const char *s, size_t len) {
+        return (len*31 + static_cast<unsigned char>(s[0])*7 + static_cast<unsigned char>(s[len-1])) & (CAP-1);
+    }
 
-    FILE *f = nullptr;
+    explicit KeywordTable(const std::vector<std::string> &keywords) {
+        assert(keywords.size() < CAP/2);
+        for (const auto &kw : keywords) {
+            if (kw.empty())
+                continue;
+            size_t h = hash(kw.data(), kw.size());
+            while (m_slots[h])
+                h = (h+1) & (CAP-1);
+            m_slots[h] = &kw;
+        }
+    }
 
-    if ((flags & __WITHOUT_STDLIB) == 0) {
-        f = fopen(full_path, "rb");
+    bool
+    contains(const char *s, size_t len) const {
+        for (size_t h = hash(s, len); m_slots[h]; h = (h+1) & (CAP-1))
+            if (m_slots[h]->size() == len && memcmp(m_slots[h]->data(), s, len) == 0)
+                return true;
+        return false;
     }
+};
 
-    if (f == nullptr) {
-        f = fopen(filepath, "rb");
+std::string
+resolve_filepath(const char *filepath) {
+    if ((flags & __WITHOUT_STDLIB) == 0) {
+        std::string full_path = std::string(PREFIX "/include/EARL/") + filepath;
+        FILE *f = fopen(full_path.c_str(), "rb");
+        if (f != nullptr) {
+            fclose(f);
+            return full_path;
+        }
     }
+    return filepath;
+}
+
+char *
+read_file(const char *filepath) {
+    FILE *f = fopen(resolve_filepath(filepath).c_str(), "rb");
 
     if (f == nullptr || fseek(f, 0, SEEK_END)) {
         std::string msg = "could not find the specified source filepath: " + std::string(filepath);
@@ -194,104 +323,49 @@ lex_file(std::string &src,
          std::vector<std::string> &keywords,
          std::vector<std::string> &types,
          std::string &comment) {
-    (void)is_keyword;
-    (void)is_type;
-    (void)issym;
-    (void)try_comment;
     (void)types;
     (void)comment;
     std::unique_ptr<Lexer> lexer = std::make_unique<Lexer>();
+    uint32_t file = filetable_intern(fp);
+    const KeywordTable kwtable(keywords);
 
-    const std::unordered_map<std::string, TokenType> ht = {
-        {"(", TokenType::Lparen},
-        {")", TokenType::Rparen},
-        {"[", TokenType::Lbracket},
-        {"]", TokenType::Rbracket},
-        {"{", TokenType::Lbrace},
-        {"}", TokenType::Rbrace},
-        {"#", TokenType::Hash},
-        {".", TokenType::Period},
-        {";", TokenType::Semicolon},
-        {",", TokenType::Comma},
-        {">", TokenType::Greaterthan},
-        {"<", TokenType::Lessthan},
-        {"=", TokenType::Equals},
-        {"&", TokenType::Ampersand},
-        {"*", TokenType::Asterisk},
-        {"+", TokenType::Plus},
-        {"-", TokenType::Minus},
-        {"/", TokenType::Forwardslash},
-        {"|", TokenType::Pipe},
-        {"^", TokenType::Caret},
-        {"?", TokenType::Questionmark},
-        {"\\", TokenType::Backwardslash},
-        {"!", TokenType::Bang},
-        {"@", TokenType::At},
-        {"$", TokenType::Dollarsign},
-        {"%", TokenType::Percent},
-        {"`", TokenType::Backtick},
-        {"~", TokenType::Tilde},
-        {":", TokenType::Colon},
-        {"&&", TokenType::Double_Ampersand},
-        {"||", TokenType::Double_Pipe},
-        {">=", TokenType::Greaterthan_Equals},
-        {"<=", TokenType::Lessthan_Equals},
-        {"==", TokenType::Double_Equals},
-        {"!=", TokenType::Bang_Equals},
-        {"+=", TokenType::Plus_Equals},
-        {"-=", TokenType::Minus_Equals},
-        {"*=", TokenType::Asterisk_Equals},
-        {"/=", TokenType::Forwardslash_Equals},
-        {"%=", TokenType::Percent_Equals},
-        {"->", TokenType::RightArrow},
-        {"..", TokenType::Double_Period},
-        {"::", TokenType::Double_Colon},
-        {"**", TokenType::Double_Asterisk},
-        {"<<", TokenType::Double_Lessthan},
-        {">>", TokenType::Double_Greaterthan},
-        {"`|", TokenType::Backtick_Pipe},
-        {"`&", TokenType::Backtick_Ampersand},
-        {"`~", TokenType::Backtick_Tilde},
-        {"`^", TokenType::Backtick_Caret},
-        {"`|=", TokenType::Backtick_Pipe_Equals},
-        {"`&=", TokenType::Backtick_Ampersand_Equals},
-        {"`^=", TokenType::Backtick_Caret_Equals},
-    };
+    // Roughly one token for every five bytes of typical source.
+    lexer->m_toks.reserve(src.size()/5 + 1);
 
+    const char *base = src.c_str();
+    const char *end = base + src.size();
     int row = 1, col = 0;
     size_t i = 0;
     while (i < src.size()) {
         char *lexeme = &src[i];
+        char c = src[i];
 
-        if (src[i] == '#') {
-            while (src[i] != '\n') {
-                ++i;
-                ++col;
-            }
+        if (c == '#') {
+            size_t eol = find_byte(base+i, end, '\n') - base;
+            col += eol-i;
+            i = eol;
         }
 
-        else if (src[i] == '\t' || src[i] == ' ') {
-            ++i;
-            ++col;
+        else if (is_cc(c, CC_BLANK)) {
+            size_t next = skip_blanks(base+i, end) - base;
+            col += next-i;
+            i = next;
         }
 
-        else if (src[i] == '\n') {
+        else if (c == '\n') {
             col = 0;
             ++row;
             ++i;
         }
 
-        else if (src[i] == '"') {
-            size_t strlit_len = consume_until(lexeme+1, [](const char c) {
-                return c == '"';
-            });
-            std::shared_ptr<Token> tok = token_alloc(*lexer.get(), lexeme+1, strlit_len, TokenType::Strlit, row, col, fp);
-            lexer->append(std::move(tok));
+        else if (c == '"') {
+            size_t strlit_len = strlit_body_len(lexeme+1, end);
+            lexer->append(token_alloc(*lexer.get(), lexeme+1, strlit_len, TokenType::Strlit, row, col, file));
             i += 1 + strlit_len + 1;
             col += 1 + strlit_len + 1;
         }
 
-        else if (src[i] == '\'') {
+        else if (c == '\'') {
             std::string charlit = "";
             ++i;
             if (src[i] == '\\') {
@@ -302,67 +376,73 @@ lex_file(std::string &src,
             }
             else
                 charlit = std::string(1, src[i]);
-            lexer->append(charlit, TokenType::Charlit, row, col, fp);
+            lexer->append(charlit, TokenType::Charlit, row, col, file);
             i += 2;
             col += 3;
         }
 
-        else if (isalpha(src[i]) || src[i] == '_') {
-            std::string ident = "";
-            while (src[i] == '_' || isalnum(src[i]))
-                ident += src[i++];
-            if (std::find(keywords.begin(), keywords.end(), ident) != keywords.end())
-                lexer->append(ident, TokenType::Keyword, row, col+1, fp);
-            else
-                lexer->append(ident, TokenType::Ident, row, col+1, fp);
-            col += ident.size()+1;
+        else if (is_cc(c, CC_ALPHA)) {
+            size_t start = i;
+            while (is_cc(src[i], CC_ALPHA | CC_DIGIT))
+                ++i;
+            size_t len = i-start;
+            TokenType type = kwtable.contains(base+start, len) ? TokenType::Keyword : TokenType::Ident;
+            lexer->append(std::string(base+start, len), type, row, col+1, file);
+            col += len+1;
         }
 
-        else if (isdigit(src[i])) {
-            std::string digit = "";
-            while (isdigit(src[i]))
-                digit += src[i++];
+        else if (is_cc(c, CC_DIGIT)) {
+            size_t start = i;
+            while (is_cc(src[i], CC_DIGIT))
+                ++i;
+            size_t intlen = i-start;
             if (src[i] && src[i+1] && src[i] == '.' && src[i+1] != '.') {
                 ++i;
-                std::string digit2 = ".";
-                while (isdigit(src[i]))
-                    digit2 += src[i++];
-                lexer->append(digit+digit2, TokenType::Floatlit, row, col, fp);
-                // no need for +1 for `.` because its in `digit2`
-                col += digit.size()+digit2.size();
+                while (is_cc(src[i], CC_DIGIT))
+                    ++i;
+                lexer->append(std::string(base+start, i-start), TokenType::Floatlit, row, col, file);
+                // no need for +1 for `.` because its in the length
+                col += i-start;
             }
             else {
-                lexer->append(digit, TokenType::Intlit, row, col, fp);
-                col += digit.size()+1;
+                lexer->append(std::string(base+start, intlen), TokenType::Intlit, row, col, file);
+                col += intlen+1;
             }
         }
 
         else {
-            std::string buf = "";
-            while (src[i] && !isalnum(src[i]) && src[i] != '_') // check `src[i]` first for possible fix for random segfaults on MacOS.
-                buf += src[i++];
-            while (!buf.empty()) {
-                auto it = ht.find(buf);
-                if (it != ht.end()) {
-                    if (buf == "." && src[i] && isdigit(src[i])) {
-                        std::string digit = "";
-                        while (isdigit(src[i]))
-                            digit += src[i++];
-                        lexer->append(buf+digit, TokenType::Floatlit, row, col, fp);
-                        col += digit.size()+1;
-                    }
-                    else
-                        lexer->append(buf, (*it).second, row, col, fp);
-                    break;
-                }
-                else {
-                    buf.pop_back();
-                    --i;
-                }
+            // Take the longest operator (at most three bytes) out of
+            // the run of symbols starting here.
+            size_t run = 0;
+            while (run < 3 && src[i+run] && !is_cc(src[i+run], CC_ALPHA | CC_DIGIT))
+                ++run;
+
+            TokenType type;
+            while (run > 0 && !lookup_op(base+i, run, type))
+                --run;
+
+            if (run == 0) {
+                // Typed as `Eof` so the error report stops at this token.
+                Token bad(std::string(1, c), TokenType::Eof, row, col, file);
+                Err::err_wtok(&bad);
+                const std::string msg = "unrecognised character `" + std::string(1, c) + "`";
+                throw LexerException(msg);
             }
+
+            std::string op(base+i, run);
+            i += run;
+            if (type == TokenType::Period && is_cc(src[i], CC_DIGIT)) {
+                size_t start = i;
+                while (is_cc(src[i], CC_DIGIT))
+                    ++i;
+                lexer->append(op + std::string(base+start, i-start), TokenType::Floatlit, row, col, file);
+                col += i-start+1;
+            }
+            else
+                lexer->append(std::move(op), type, row, col, file);
         }
     }
 
-    lexer->append(token_alloc(*lexer.get(), nullptr, 0, TokenType::Eof, row, col, fp));
+    lexer->append(token_alloc(*lexer.get(), nullptr, 0, TokenType::Eof, row, col, file));
     return lexer;
 }
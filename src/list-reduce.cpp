@@ -0,0 +1,288 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstdint>
+#include <cstring>
+
+#include "list-reduce.hpp"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define LIST_REDUCE_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+
+    // The kernels start at `i` and leave it at the first element they
+    // did not look at, the caller finishes the rest one at a time.
+
+#ifdef LIST_REDUCE_X86
+    bool
+    have_avx2(void) {
+        static const bool avx2 = __builtin_cpu_supports("avx2");
+        return avx2;
+    }
+
+    uint32_t
+    sum_sse2(const int *xs, size_t n, size_t &i) {
+        __m128i acc = _mm_setzero_si128();
+        for (; i+4 <= n; i += 4)
+            acc = _mm_add_epi32(acc, _mm_loadu_si128(reinterpret_cast<const __m128i *>(xs+i)));
+        uint32_t t[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(t), acc);
+        return t[0]+t[1]+t[2]+t[3];
+    }
+
+    __attribute__((target("avx2"))) uint32_t
+    sum_avx2(const int *xs, size_t n, size_t &i) {
+        __m256i acc = _mm256_setzero_si256();
+        for (; i+8 <= n; i += 8)
+            acc = _mm256_add_epi32(acc, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(xs+i)));
+        uint32_t t[8];
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(t), acc);
+        return t[0]+t[1]+t[2]+t[3]+t[4]+t[5]+t[6]+t[7];
+    }
+
+    // Lane k of the running sums holds the elements at i+k (mod 4).
+
+    void
+    sum4_sse2(const double *xs, size_t n, size_t &i, double t[4]) {
+        __m128d lo = _mm_setzero_pd(), hi = _mm_setzero_pd();
+        for (; i+4 <= n; i += 4) {
+            lo = _mm_add_pd(lo, _mm_loadu_pd(xs+i));
+            hi = _mm_add_pd(hi, _mm_loadu_pd(xs+i+2));
+        }
+        _mm_storeu_pd(t, lo);
+        _mm_storeu_pd(t+2, hi);
+    }
+
+    __attribute__((target("avx2"))) void
+    sum4_avx2(const double *xs, size_t n, size_t &i, double t[4]) {
+        __m256d acc = _mm256_setzero_pd();
+        for (; i+4 <= n; i += 4)
+            acc = _mm256_add_pd(acc, _mm256_loadu_pd(xs+i));
+        _mm256_storeu_pd(t, acc);
+    }
+
+    template <bool Max> int
+    extreme_sse2(const int *xs, size_t n, size_t &i, int m) {
+        __m128i acc = _mm_set1_epi32(m);
+        for (; i+4 <= n; i += 4) {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(xs+i));
+            // There is no pminsd/pmaxsd before SSE4.1, so select by hand.
+            __m128i take = Max ? _mm_cmpgt_epi32(x, acc) : _mm_cmpgt_epi32(acc, x);
+            acc = _mm_or_si128(_mm_and_si128(take, x), _mm_andnot_si128(take, acc));
+        }
+        int t[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(t), acc);
+        for (int k = 0; k < 4; ++k)
+            m = (Max ? t[k] > m : t[k] < m) ? t[k] : m;
+        return m;
+    }
+
+    template <bool Max> __attribute__((target("avx2"))) int
+    extreme_avx2(const int *xs, size_t n, size_t &i, int m) {
+        __m256i acc = _mm256_set1_epi32(m);
+        for (; i+8 <= n; i += 8) {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(xs+i));
+            acc = Max ? _mm256_max_epi32(acc, x) : _mm256_min_epi32(acc, x);
+        }
+        int t[8];
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(t), acc);
+        for (int k = 0; k < 8; ++k)
+            m = (Max ? t[k] > m : t[k] < m) ? t[k] : m;
+        return m;
+    }
+
+    template <bool Max> double
+    extreme_sse2(const double *xs, size_t n, size_t &i, double m) {
+        __m128d acc = _mm_set1_pd(m);
+        for (; i+2 <= n; i += 2) {
+            __m128d x = _mm_loadu_pd(xs+i);
+            acc = Max ? _mm_max_pd(acc, x) : _mm_min_pd(acc, x);
+        }
+        double t[2];
+        _mm_storeu_pd(t, acc);
+        for (int k = 0; k < 2; ++k)
+            m = (Max ? t[k] > m : t[k] < m) ? t[k] : m;
+        return m;
+    }
+
+    template <bool Max> __attribute__((target("avx2"))) double
+    extreme_avx2(const double *xs, size_t n, size_t &i, double m) {
+        __m256d acc = _mm256_set1_pd(m);
+        for (; i+4 <= n; i += 4) {
+            __m256d x = _mm256_loadu_pd(xs+i);
+            acc = Max ? _mm256_max_pd(acc, x) : _mm256_min_pd(acc, x);
+        }
+        double t[4];
+        _mm256_storeu_pd(t, acc);
+        for (int k = 0; k < 4; ++k)
+            m = (Max ? t[k] > m : t[k] < m) ? t[k] : m;
+        return m;
+    }
+
+    size_t
+    index_of_sse2(const int *xs, size_t n, int x, size_t &i) {
+        const __m128i v = _mm_set1_epi32(x);
+        for (; i+4 <= n; i += 4) {
+            __m128i eq = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(xs+i)), v);
+            int mask = _mm_movemask_ps(_mm_castsi128_ps(eq));
+            if (mask != 0)
+                return i+__builtin_ctz(mask);
+        }
+        return ListReduce::npos;
+    }
+
+    __attribute__((target("avx2"))) size_t
+    index_of_avx2(const int *xs, size_t n, int x, size_t &i) {
+        const __m256i v = _mm256_set1_epi32(x);
+        for (; i+8 <= n; i += 8) {
+            __m256i eq = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(xs+i)), v);
+            int mask = _mm256_movemask_ps(_mm256_castsi256_ps(eq));
+            if (mask != 0)
+                return i+__builtin_ctz(mask);
+        }
+        return ListReduce::npos;
+    }
+
+    size_t
+    index_of_sse2(const double *xs, size_t n, double x, size_t &i) {
+        const __m128d v = _mm_set1_pd(x);
+        for (; i+2 <= n; i += 2) {
+            int mask = _mm_movemask_pd(_mm_cmpeq_pd(_mm_loadu_pd(xs+i), v));
+            if (mask != 0)
+                return i+__builtin_ctz(mask);
+        }
+        return ListReduce::npos;
+    }
+
+    __attribute__((target("avx2"))) size_t
+    index_of_avx2(const double *xs, size_t n, double x, size_t &i) {
+        const __m256d v = _mm256_set1_pd(x);
+        for (; i+4 <= n; i += 4) {
+            int mask = _mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(xs+i), v, _CMP_EQ_OQ));
+            if (mask != 0)
+                return i+__builtin_ctz(mask);
+        }
+        return ListReduce::npos;
+    }
+#endif
+
+    template <bool Max, typename T> T
+    extreme(const T *xs, size_t n) {
+        size_t i = 1;
+        T m = xs[0];
+#ifdef LIST_REDUCE_X86
+        m = have_avx2() ? extreme_avx2<Max>(xs, n, i, m) : extreme_sse2<Max>(xs, n, i, m);
+#endif
+        for (; i < n; ++i)
+            m = (Max ? xs[i] > m : xs[i] < m) ? xs[i] : m;
+        return m;
+    }
+
+    template <typename T> size_t
+    index_of_generic(const T *xs, size_t n, T x) {
+        size_t i = 0;
+#ifdef LIST_REDUCE_X86
+        size_t at = have_avx2() ? index_of_avx2(xs, n, x, i) : index_of_sse2(xs, n, x, i);
+        if (at != ListReduce::npos)
+            return at;
+#endif
+        for (; i < n; ++i)
+            if (xs[i] == x)
+                return i;
+        return ListReduce::npos;
+    }
+
+};
+
+int
+ListReduce::sum(const int *xs, size_t n) {
+    size_t i = 0;
+    uint32_t result = 0;
+#ifdef LIST_REDUCE_X86
+    result = have_avx2() ? sum_avx2(xs, n, i) : sum_sse2(xs, n, i);
+#endif
+    for (; i < n; ++i)
+        result += static_cast<uint32_t>(xs[i]);
+    return static_cast<int>(result);
+}
+
+double
+ListReduce::sum(const double *xs, size_t n) {
+    size_t i = 0;
+    double t[4] = {0., 0., 0., 0.};
+#ifdef LIST_REDUCE_X86
+    if (have_avx2())
+        sum4_avx2(xs, n, i, t);
+    else
+        sum4_sse2(xs, n, i, t);
+#else
+    for (; i+4 <= n; i += 4)
+        for (int k = 0; k < 4; ++k)
+            t[k] += xs[i+k];
+#endif
+    double result = (t[0]+t[1])+(t[2]+t[3]);
+    for (; i < n; ++i)
+        result += xs[i];
+    return result;
+}
+
+int
+ListReduce::min(const int *xs, size_t n) {
+    return extreme<false>(xs, n);
+}
+
+double
+ListReduce::min(const double *xs, size_t n) {
+    return extreme<false>(xs, n);
+}
+
+int
+ListReduce::max(const int *xs, size_t n) {
+    return extreme<true>(xs, n);
+}
+
+double
+ListReduce::max(const double *xs, size_t n) {
+    return extreme<true>(xs, n);
+}
+
+size_t
+ListReduce::index_of(const int *xs, size_t n, int x) {
+    return index_of_generic(xs, n, x);
+}
+
+size_t
+ListReduce::index_of(const double *xs, size_t n, double x) {
+    return index_of_generic(xs, n, x);
+}
+
+size_t
+ListReduce::index_of(const char *xs, size_t n, char x) {
+    // memchr is already vectorized by the C library.
+    const void *at = std::memchr(xs, x, n);
+    return at ? static_cast<const char *>(at)-xs : npos;
+}
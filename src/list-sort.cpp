@@ -0,0 +1,141 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <functional>
+#include <system_error>
+#include <thread>
+
+#include "list-sort.hpp"
+
+namespace {
+
+    // Run every task, each on its own thread where one can be started,
+    // the rest (and the first one) on the calling thread.
+    template <typename Task> void
+    run_all(std::vector<Task> &tasks) {
+        std::vector<std::thread> threads = {};
+        size_t inline_from = tasks.size();
+        for (size_t i = 1; i < tasks.size(); ++i) {
+            try {
+                threads.emplace_back(tasks[i]);
+            }
+            catch (const std::system_error &) {
+                inline_from = i;
+                break;
+            }
+        }
+        tasks[0]();
+        for (size_t i = inline_from; i < tasks.size(); ++i)
+            tasks[i]();
+        for (auto &t : threads)
+            t.join();
+    }
+
+    template <typename T, typename Less> void
+    chunked_sort(T *xs, size_t n, Less less) {
+        size_t nthreads = std::thread::hardware_concurrency();
+        size_t nchunks = std::min<size_t>({nthreads, n / (ListSort::parallel_threshold/2), 16});
+        if (nchunks < 2) {
+            std::stable_sort(xs, xs+n, less);
+            return;
+        }
+
+        std::vector<size_t> bounds(nchunks+1);
+        for (size_t i = 0; i <= nchunks; ++i)
+            bounds[i] = n*i/nchunks;
+
+        std::vector<std::function<void()>> tasks = {};
+        for (size_t i = 0; i < nchunks; ++i)
+            tasks.push_back([=]() { std::stable_sort(xs+bounds[i], xs+bounds[i+1], less); });
+        run_all(tasks);
+
+        // Merge runs pairwise, the left run first so equal elements keep their order.
+        for (size_t width = 1; width < nchunks; width *= 2) {
+            tasks.clear();
+            for (size_t lo = 0; lo+width < nchunks; lo += 2*width) {
+                size_t mid = lo+width, hi = std::min(lo+2*width, nchunks);
+                T *a = xs+bounds[lo], *b = xs+bounds[mid], *c = xs+bounds[hi];
+                tasks.push_back([=]() { std::inplace_merge(a, b, c, less); });
+            }
+            run_all(tasks);
+        }
+    }
+
+    template <typename T, typename Less> void
+    sort_any(T *xs, size_t n, Less less) {
+        if (n < ListSort::parallel_threshold)
+            std::stable_sort(xs, xs+n, less);
+        else
+            chunked_sort(xs, n, less);
+    }
+
+    bool
+    float_less(double a, double b) {
+        return a < b || (!std::isnan(a) && std::isnan(b));
+    }
+
+};
+
+void
+ListSort::sort(int *xs, size_t n) {
+    sort_any(xs, n, [](int a, int b) { return a < b; });
+}
+
+void
+ListSort::sort(double *xs, size_t n) {
+    sort_any(xs, n, float_less);
+}
+
+void
+ListSort::sort(char *xs, size_t n) {
+    size_t counts[256] = {0};
+    for (size_t i = 0; i < n; ++i)
+        ++counts[static_cast<unsigned char>(xs[i])];
+    // `char` may be signed, so start at the smallest value.
+    size_t k = 0;
+    for (int c = CHAR_MIN; c <= CHAR_MAX; ++c)
+        for (size_t m = counts[static_cast<unsigned char>(c)]; m > 0; --m)
+            xs[k++] = static_cast<char>(c);
+}
+
+void
+ListSort::sort_indices(std::vector<size_t> &idx, const std::vector<int> &keys) {
+    const int *k = keys.data();
+    sort_any(idx.data(), idx.size(), [k](size_t a, size_t b) { return k[a] < k[b]; });
+}
+
+void
+ListSort::sort_indices(std::vector<size_t> &idx, const std::vector<double> &keys) {
+    const double *k = keys.data();
+    sort_any(idx.data(), idx.size(), [k](size_t a, size_t b) { return float_less(k[a], k[b]); });
+}
+
+void
+ListSort::sort_indices(std::vector<size_t> &idx, const std::vector<std::string_view> &keys) {
+    const std::string_view *k = keys.data();
+    sort_any(idx.data(), idx.size(), [k](size_t a, size_t b) { return k[a] < k[b]; });
+}
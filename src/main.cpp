@@ -22,6 +22,7 @@
 // SOFTWARE.
 
 #include <filesystem>
+#include <chrono>
 #include <iostream>
 #include <vector>
 #include <iostream>
@@ -36,6 +37,7 @@
 #include "repl.hpp"
 #include "config.h"
 #include "hot-reload.hpp"
+#include "earlc.hpp"
 
 std::vector<std::string> earl_argv = {};
 static std::vector<std::string> watch_files = {};
@@ -61,6 +63,11 @@ usage(void) {
     std::cerr << "      --repl-nocolor      Do not use color in the REPL" << std::endl;
     std::cerr << "      --watch [files...]  Watch files for changes and hot reload" << std::endl;
     std::cerr << "      --show-funs         Print every function call evaluated" << std::endl;
+    std::cerr << "      --show-imports      Print every import and whether it was cached" << std::endl;
+    std::cerr << "      --cache             Reuse lexed files from the token cache (~/.cache/earl)" << std::endl;
+    std::cerr << "      --show-cache        Print whether every lexed file hit the token cache" << std::endl;
+    std::cerr << "      --bench-lexer       Report the lexer throughput on <file> instead of running it" << std::endl;
+    std::cerr << "      --engine=<ast|vm>   Select the execution engine (default: ast)" << std::endl;
 
     std::exit(0);
 }
@@ -115,6 +122,25 @@ parse_2hypharg(std::string arg, std::vector<std::string> &args) {
     }
     else if (arg == COMMON_EARL2ARG_SHOWFUNS)
         flags |= __SHOWFUNS;
+    else if (arg == COMMON_EARL2ARG_SHOWIMPORTS)
+        flags |= __SHOWIMPORTS;
+    else if (arg == COMMON_EARL2ARG_CACHE)
+        flags |= __CACHE;
+    else if (arg == COMMON_EARL2ARG_SHOWCACHE)
+        flags |= __SHOWCACHE;
+    else if (arg == COMMON_EARL2ARG_BENCHLEXER)
+        flags |= __BENCHLEXER;
+    else if (arg.rfind(COMMON_EARL2ARG_ENGINE "=", 0) == 0) {
+        std::string engine = arg.substr(std::string(COMMON_EARL2ARG_ENGINE "=").size());
+        if (engine == "vm")
+            flags |= __VM;
+        else if (engine == "ast")
+            flags &= ~(__VM);
+        else {
+            std::cerr << "Unrecognised engine: " << engine << " (expected `ast` or `vm`)" << std::endl;
+            exit(1);
+        }
+    }
     else {
         std::cerr << "Unrecognised argument: " << arg << std::endl;
         std::cerr << "Did you mean: " << try_guess_wrong_arg(arg) << "?" << std::endl;
@@ -191,6 +217,29 @@ handlecli(int argc, char **argv) {
     return filepath;
 }
 
+static int
+bench_lexer(std::string &filepath,
+            std::vector<std::string> &keywords,
+            std::vector<std::string> &types,
+            std::string &comment) {
+    std::string src_code = read_file(filepath.c_str());
+    size_t ntoks = 0, runs = 0;
+    double secs = 0.0;
+
+    // Lex repeatedly until enough time has passed to smooth out noise.
+    auto start = std::chrono::steady_clock::now();
+    do {
+        ntoks = lex_file(src_code, filepath, keywords, types, comment)->m_toks.size();
+        ++runs;
+        secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } while (secs < 0.5);
+
+    double mb = static_cast<double>(src_code.size()) * runs / (1024.0*1024.0);
+    std::cout << filepath << ": " << src_code.size() << " bytes, " << ntoks << " tokens, "
+              << runs << " runs, " << mb/secs << " MB/s" << std::endl;
+    return 0;
+}
+
 int
 main(int argc, char **argv) {
     ++argv; --argc;
@@ -208,6 +257,14 @@ main(int argc, char **argv) {
         hot_reload::register_watch_files(watch_files);
     }
 
+    if ((flags & __BENCHLEXER) != 0) {
+        if (filepath == "") {
+            std::cerr << "Cannot use flag `" << COMMON_EARL2ARG_BENCHLEXER << "` with no input file\n";
+            std::exit(1);
+        }
+        return bench_lexer(filepath, keywords, types, comment);
+    }
+
     bool locked = true;
 
     if (filepath != "") {
@@ -220,14 +277,17 @@ main(int argc, char **argv) {
             else
                 locked = false;
 
-            if ((flags & __WATCH) != 0)
+            if ((flags & __WATCH) != 0) {
                 std::cout << "=== Run: " << run_count++ << " ======================" << std::endl;
+                // Imported files may be the ones that changed.
+                WorldCtx::module_cache_clear();
+            }
 
             std::unique_ptr<Lexer> lexer = nullptr;
             std::unique_ptr<Program> program = nullptr;
             try {
                 std::string src_code = read_file(filepath.c_str());
-                lexer = lex_file(src_code, filepath, keywords, types, comment);
+                lexer = earlc::lex(src_code, filepath, keywords, types, comment);
             } catch (const LexerException &e) {
                 std::cerr << "Lexer error: " << e.what() << std::endl;
                 if ((flags & __WATCH) == 0)
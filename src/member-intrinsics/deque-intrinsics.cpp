@@ -0,0 +1,94 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cassert>
+#include <unordered_map>
+
+#include "intrinsics.hpp"
+#include "err.hpp"
+#include "ctx.hpp"
+#include "ast.hpp"
+#include "earl.hpp"
+
+const std::unordered_map<std::string, Intrinsics::IntrinsicMemberFunction>
+Intrinsics::intrinsic_deque_member_functions = {
+    {"push_back", &Intrinsics::intrinsic_member_push_back},
+    {"push_front", &Intrinsics::intrinsic_member_push_front},
+    {"pop_back", &Intrinsics::intrinsic_member_pop_back},
+    {"pop_front", &Intrinsics::intrinsic_member_pop_front},
+    {"back", &Intrinsics::intrinsic_member_back},
+    {"front", &Intrinsics::intrinsic_member_front},
+};
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_member_push_back(std::shared_ptr<earl::value::Obj> obj,
+                                       std::vector<std::shared_ptr<earl::value::Obj>> &value,
+                                       std::shared_ptr<Ctx> &ctx,
+                                       Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(value, 1, "push_back", expr);
+    dynamic_cast<earl::value::Deque *>(obj.get())->push_back(value[0]);
+    return std::make_shared<earl::value::Void>();
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_member_push_front(std::shared_ptr<earl::value::Obj> obj,
+                                        std::vector<std::shared_ptr<earl::value::Obj>> &value,
+                                        std::shared_ptr<Ctx> &ctx,
+                                        Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(value, 1, "push_front", expr);
+    dynamic_cast<earl::value::Deque *>(obj.get())->push_front(value[0]);
+    return std::make_shared<earl::value::Void>();
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_member_pop_back(std::shared_ptr<earl::value::Obj> obj,
+                                      std::vector<std::shared_ptr<earl::value::Obj>> &unused,
+                                      std::shared_ptr<Ctx> &ctx,
+                                      Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(unused, 0, "pop_back", expr);
+    return dynamic_cast<earl::value::Deque *>(obj.get())->pop_back();
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_member_pop_front(std::shared_ptr<earl::value::Obj> obj,
+                                       std::vector<std::shared_ptr<earl::value::Obj>> &unused,
+                                       std::shared_ptr<Ctx> &ctx,
+                                       Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(unused, 0, "pop_front", expr);
+    return dynamic_cast<earl::value::Deque *>(obj.get())->pop_front();
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_member_front(std::shared_ptr<earl::value::Obj> obj,
+                                   std::vector<std::shared_ptr<earl::value::Obj>> &unused,
+                                   std::shared_ptr<Ctx> &ctx,
+                                   Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(unused, 0, "front", expr);
+    return dynamic_cast<earl::value::Deque *>(obj.get())->front();
+}
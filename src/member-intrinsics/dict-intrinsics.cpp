@@ -43,6 +43,12 @@ Intrinsics::intrinsic_member_insert(std::shared_ptr<earl::value::Obj> obj,
                                     std::vector<std::shared_ptr<earl::value::Obj>> &params,
                                     std::shared_ptr<Ctx> &ctx,
                                     Expr *expr) {
+    if (obj->type() == earl::value::Type::Set) {
+        __INTR_ARGS_MUSTBE_SIZE(params, 1, "insert", expr);
+        dynamic_cast<earl::value::Set *>(obj.get())->insert(params[0], expr);
+        return std::make_shared<earl::value::Void>();
+    }
+
     __INTR_ARGS_MUSTBE_SIZE(params, 2, "insert", expr);
     switch (obj->type()) {
     case earl::value::Type::DictInt: {
@@ -54,7 +60,7 @@ Intrinsics::intrinsic_member_insert(std::shared_ptr<earl::value::Obj> obj,
     case earl::value::Type::DictStr: {
         auto dict = dynamic_cast<earl::value::Dict<std::string> *>(obj.get());
         __INTR_ARG_MUSTBE_TYPE_COMPAT(params[0], dict->ktype(), 1, "insert", expr);
-        std::string key = dynamic_cast<earl::value::Str *>(params[0].get())->value();
+        const std::string &key = dynamic_cast<earl::value::Str *>(params[0].get())->value();
         dict->insert(key, params[1]);
     } break;
     case earl::value::Type::DictChar: {
@@ -69,6 +75,17 @@ Intrinsics::intrinsic_member_insert(std::shared_ptr<earl::value::Obj> obj,
         double key = dynamic_cast<earl::value::Float *>(params[0].get())->value();
         dict->insert(key, params[1]);
     } break;
+    case earl::value::Type::DictTuple: {
+        auto dict = dynamic_cast<earl::value::Dict<earl::value::DictKey> *>(obj.get());
+        __INTR_ARG_MUSTBE_TYPE_COMPAT(params[0], dict->ktype(), 1, "insert", expr);
+        earl::value::DictKey key;
+        if (!earl::value::DictKey::from(params[0].get(), key)) {
+            Err::err_wexpr(expr);
+            const std::string msg = "tuple keys may only hold int, float, bool, char, str or tuple values";
+            throw InterpreterException(msg);
+        }
+        dict->insert(std::move(key), params[1]);
+    } break;
     default: {
         Err::err_wexpr(expr);
         const std::string &msg = "cannot insert value of type `"
@@ -96,7 +113,7 @@ Intrinsics::intrinsic_member_has_key(std::shared_ptr<earl::value::Obj> obj,
     case earl::value::Type::DictStr: {
         auto dict = dynamic_cast<earl::value::Dict<std::string> *>(obj.get());
         __INTR_ARG_MUSTBE_TYPE_COMPAT(key[0], dict->ktype(), 1, "has_key", expr);
-        std::string k = dynamic_cast<earl::value::Str *>(key[0].get())->value();
+        const std::string &k = dynamic_cast<earl::value::Str *>(key[0].get())->value();
         return std::make_shared<earl::value::Bool>(dict->has_key(k));
     } break;
     case earl::value::Type::DictChar: {
@@ -111,6 +128,12 @@ Intrinsics::intrinsic_member_has_key(std::shared_ptr<earl::value::Obj> obj,
         double k = dynamic_cast<earl::value::Float *>(key[0].get())->value();
         return std::make_shared<earl::value::Bool>(dict->has_key(k));
     } break;
+    case earl::value::Type::DictTuple: {
+        auto dict = dynamic_cast<earl::value::Dict<earl::value::DictKey> *>(obj.get());
+        __INTR_ARG_MUSTBE_TYPE_COMPAT(key[0], dict->ktype(), 1, "has_key", expr);
+        earl::value::DictKey k;
+        return std::make_shared<earl::value::Bool>(earl::value::DictKey::from(key[0].get(), k) && dict->has_key(k));
+    } break;
     default: {
         Err::err_wexpr(expr);
         const std::string &msg = "cannot check if a key exists in a dictionary of type `"
@@ -144,6 +167,10 @@ Intrinsics::intrinsic_member_has_value(std::shared_ptr<earl::value::Obj> obj,
         auto dict = dynamic_cast<earl::value::Dict<double> *>(obj.get());
         return std::make_shared<earl::value::Bool>(dict->has_value(value[0]));
     } break;
+    case earl::value::Type::DictTuple: {
+        auto dict = dynamic_cast<earl::value::Dict<earl::value::DictKey> *>(obj.get());
+        return std::make_shared<earl::value::Bool>(dict->has_value(value[0]));
+    } break;
     default: {
         Err::err_wexpr(expr);
         const std::string &msg = "cannot check if a value exists in a dictionary of type `"
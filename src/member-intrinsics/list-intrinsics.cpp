@@ -42,6 +42,13 @@ Intrinsics::intrinsic_list_member_functions = {
     {"pop", &Intrinsics::intrinsic_member_pop},
     {"contains", &Intrinsics::intrinsic_member_contains},
     {"map", &Intrinsics::intrinsic_member_map},
+    {"sum", &Intrinsics::intrinsic_member_sum},
+    {"min", &Intrinsics::intrinsic_member_min},
+    {"max", &Intrinsics::intrinsic_member_max},
+    {"index_of", &Intrinsics::intrinsic_member_index_of},
+    {"sort", &Intrinsics::intrinsic_member_sort},
+    {"sort_by", &Intrinsics::intrinsic_member_sort_by},
+    {"sorted", &Intrinsics::intrinsic_member_sorted},
 };
 
 std::shared_ptr<earl::value::Obj>
@@ -80,6 +87,8 @@ Intrinsics::intrinsic_member_back(std::shared_ptr<earl::value::Obj> obj,
     __INTR_ARGS_MUSTBE_SIZE(unused, 0, "back", expr);
     if (obj->type() == earl::value::Type::List)
         return dynamic_cast<earl::value::List *>(obj.get())->back();
+    else if (obj->type() == earl::value::Type::Deque)
+        return dynamic_cast<earl::value::Deque *>(obj.get())->back();
     else if (obj->type() == earl::value::Type::Tuple)
         return dynamic_cast<earl::value::Tuple *>(obj.get())->back();
     else
@@ -152,7 +161,11 @@ Intrinsics::intrinsic_member_pop(std::shared_ptr<earl::value::Obj> obj,
                                  std::vector<std::shared_ptr<earl::value::Obj>> &values,
                                  std::shared_ptr<Ctx> &ctx,
                                  Expr *expr) {
-    (void)ctx;
+    if (obj->type() == earl::value::Type::Heap) {
+        __INTR_ARGS_MUSTBE_SIZE(values, 0, "pop", expr);
+        return dynamic_cast<earl::value::Heap *>(obj.get())->pop(ctx, expr);
+    }
+
     __INTR_ARGS_MUSTBE_SIZE(values, 1, "pop", expr);
     __INTR_ARG_MUSTBE_TYPE_COMPAT(values[0], earl::value::Type::Int, 1, "pop", expr);
     if (obj->type() == earl::value::Type::List)
@@ -172,17 +185,12 @@ Intrinsics::intrinsic_member_contains(std::shared_ptr<earl::value::Obj> obj,
 
     if (obj->type() == earl::value::Type::List)
         return dynamic_cast<earl::value::List *>(obj.get())->contains(value[0]);
-    else if (obj->type() == earl::value::Type::Str) {
-        if (value[0]->type() != earl::value::Type::Char) {
-            Err::err_wexpr(expr);
-            const std::string msg = "cannot use member intrinsic `contains` on type str with a argument other than of type char";
-            throw InterpreterException(msg);
-        }
-        auto ch = std::dynamic_pointer_cast<earl::value::Char>(value[0]);
-        return dynamic_cast<earl::value::Str *>(obj.get())->contains(ch);
-    }
+    else if (obj->type() == earl::value::Type::Str)
+        return dynamic_cast<earl::value::Str *>(obj.get())->contains(value[0], expr);
     else if (obj->type() == earl::value::Type::Tuple)
         return dynamic_cast<earl::value::Tuple *>(obj.get())->contains(value[0]);
+    else if (obj->type() == earl::value::Type::Set)
+        return dynamic_cast<earl::value::Set *>(obj.get())->contains(value[0]);
     else {
         Err::err_wexpr(expr);
         const std::string msg = "cannot call intrinsic method `contains` on non list-adjacent type";
@@ -202,3 +210,100 @@ Intrinsics::intrinsic_member_map(std::shared_ptr<earl::value::Obj> obj,
     auto cl = std::dynamic_pointer_cast<earl::value::Closure>(closure[0]);
     return dynamic_cast<earl::value::List *>(obj.get())->map(cl, ctx);
 }
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_member_sum(std::shared_ptr<earl::value::Obj> obj,
+                                 std::vector<std::shared_ptr<earl::value::Obj>> &unused,
+                                 std::shared_ptr<Ctx> &ctx,
+                                 Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(unused, 0, "sum", expr);
+    return dynamic_cast<earl::value::List *>(obj.get())->sum(expr);
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_member_min(std::shared_ptr<earl::value::Obj> obj,
+                                 std::vector<std::shared_ptr<earl::value::Obj>> &unused,
+                                 std::shared_ptr<Ctx> &ctx,
+                                 Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(unused, 0, "min", expr);
+    return dynamic_cast<earl::value::List *>(obj.get())->min(expr);
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_member_max(std::shared_ptr<earl::value::Obj> obj,
+                                 std::vector<std::shared_ptr<earl::value::Obj>> &unused,
+                                 std::shared_ptr<Ctx> &ctx,
+                                 Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(unused, 0, "max", expr);
+    return dynamic_cast<earl::value::List *>(obj.get())->max(expr);
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_member_index_of(std::shared_ptr<earl::value::Obj> obj,
+                                      std::vector<std::shared_ptr<earl::value::Obj>> &value,
+                                      std::shared_ptr<Ctx> &ctx,
+                                      Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(value, 1, "index_of", expr);
+    return dynamic_cast<earl::value::List *>(obj.get())->index_of(value[0]);
+}
+
+// A sort closure is either a key function or a comparator.
+static void
+check_sort_closure(std::shared_ptr<earl::value::Obj> &closure, const std::string &fn, Expr *expr) {
+    size_t n = dynamic_cast<earl::value::Closure *>(closure.get())->params_len();
+    if (n != 1 && n != 2) {
+        Err::err_wexpr(expr);
+        const std::string msg = "the closure given to `"+fn+"` must take 1 (key) or 2 (comparator) arguments, not "+std::to_string(n);
+        throw InterpreterException(msg);
+    }
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_member_sort(std::shared_ptr<earl::value::Obj> obj,
+                                  std::vector<std::shared_ptr<earl::value::Obj>> &unused,
+                                  std::shared_ptr<Ctx> &ctx,
+                                  Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(unused, 0, "sort", expr);
+    dynamic_cast<earl::value::List *>(obj.get())->sort(expr);
+    return std::make_shared<earl::value::Void>();
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_member_sort_by(std::shared_ptr<earl::value::Obj> obj,
+                                     std::vector<std::shared_ptr<earl::value::Obj>> &closure,
+                                     std::shared_ptr<Ctx> &ctx,
+                                     Expr *expr) {
+    __INTR_ARGS_MUSTBE_SIZE(closure, 1, "sort_by", expr);
+    __INTR_ARG_MUSTBE_TYPE_COMPAT(closure[0], earl::value::Type::Closure, 1, "sort_by", expr);
+    check_sort_closure(closure[0], "sort_by", expr);
+    dynamic_cast<earl::value::List *>(obj.get())->sort_by(closure[0], ctx, expr);
+    return std::make_shared<earl::value::Void>();
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_member_sorted(std::shared_ptr<earl::value::Obj> obj,
+                                    std::vector<std::shared_ptr<earl::value::Obj>> &closure,
+                                    std::shared_ptr<Ctx> &ctx,
+                                    Expr *expr) {
+    if (closure.size() > 1) {
+        Err::err_wexpr(expr);
+        const std::string msg = "function `sorted` expects 0 or 1 arguments but "+std::to_string(closure.size())+" were supplied";
+        throw InterpreterException(msg);
+    }
+
+    auto lst = std::dynamic_pointer_cast<earl::value::List>(obj->copy());
+    if (closure.size() == 0) {
+        lst->sort(expr);
+        return lst;
+    }
+
+    __INTR_ARG_MUSTBE_TYPE_COMPAT(closure[0], earl::value::Type::Closure, 1, "sorted", expr);
+    check_sort_closure(closure[0], "sorted", expr);
+    lst->sort_by(closure[0], ctx, expr);
+    return lst;
+}
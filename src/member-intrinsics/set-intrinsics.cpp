@@ -0,0 +1,88 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cassert>
+#include <unordered_map>
+
+#include "intrinsics.hpp"
+#include "err.hpp"
+#include "ctx.hpp"
+#include "ast.hpp"
+#include "earl.hpp"
+
+const std::unordered_map<std::string, Intrinsics::IntrinsicMemberFunction>
+Intrinsics::intrinsic_set_member_functions = {
+    {"insert", &Intrinsics::intrinsic_member_insert},
+    {"remove", &Intrinsics::intrinsic_member_remove},
+    {"contains", &Intrinsics::intrinsic_member_contains},
+    {"union", &Intrinsics::intrinsic_member_union},
+    {"intersection", &Intrinsics::intrinsic_member_intersection},
+    {"difference", &Intrinsics::intrinsic_member_difference},
+};
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_member_remove(std::shared_ptr<earl::value::Obj> obj,
+                                    std::vector<std::shared_ptr<earl::value::Obj>> &value,
+                                    std::shared_ptr<Ctx> &ctx,
+                                    Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(value, 1, "remove", expr);
+    return dynamic_cast<earl::value::Set *>(obj.get())->remove(value[0]);
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_member_union(std::shared_ptr<earl::value::Obj> obj,
+                                   std::vector<std::shared_ptr<earl::value::Obj>> &other,
+                                   std::shared_ptr<Ctx> &ctx,
+                                   Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(other, 1, "union", expr);
+    __INTR_ARG_MUSTBE_TYPE_COMPAT(other[0], earl::value::Type::Set, 1, "union", expr);
+    auto set = dynamic_cast<earl::value::Set *>(obj.get());
+    return set->set_union(dynamic_cast<earl::value::Set *>(other[0].get()), expr);
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_member_intersection(std::shared_ptr<earl::value::Obj> obj,
+                                          std::vector<std::shared_ptr<earl::value::Obj>> &other,
+                                          std::shared_ptr<Ctx> &ctx,
+                                          Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(other, 1, "intersection", expr);
+    __INTR_ARG_MUSTBE_TYPE_COMPAT(other[0], earl::value::Type::Set, 1, "intersection", expr);
+    auto set = dynamic_cast<earl::value::Set *>(obj.get());
+    return set->intersection(dynamic_cast<earl::value::Set *>(other[0].get()), expr);
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_member_difference(std::shared_ptr<earl::value::Obj> obj,
+                                        std::vector<std::shared_ptr<earl::value::Obj>> &other,
+                                        std::shared_ptr<Ctx> &ctx,
+                                        Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(other, 1, "difference", expr);
+    __INTR_ARG_MUSTBE_TYPE_COMPAT(other[0], earl::value::Type::Set, 1, "difference", expr);
+    auto set = dynamic_cast<earl::value::Set *>(obj.get());
+    return set->difference(dynamic_cast<earl::value::Set *>(other[0].get()), expr);
+}
@@ -42,6 +42,12 @@ Intrinsics::intrinsic_str_member_functions = {
     {"substr", &Intrinsics::intrinsic_member_substr},
     {"trim", &Intrinsics::intrinsic_member_trim},
     {"contains", &Intrinsics::intrinsic_member_contains},
+    {"find", &Intrinsics::intrinsic_member_find},
+    {"rfind", &Intrinsics::intrinsic_member_rfind},
+    {"count", &Intrinsics::intrinsic_member_count},
+    {"replace", &Intrinsics::intrinsic_member_replace},
+    {"starts_with", &Intrinsics::intrinsic_member_starts_with},
+    {"ends_with", &Intrinsics::intrinsic_member_ends_with},
 };
 
 std::shared_ptr<earl::value::Obj>
@@ -79,6 +85,66 @@ Intrinsics::intrinsic_member_substr(std::shared_ptr<earl::value::Obj> obj,
     return dynamic_cast<earl::value::Str *>(obj.get())->substr(idxs[0], idxs[1], expr);
 }
 
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_member_find(std::shared_ptr<earl::value::Obj> obj,
+                                  std::vector<std::shared_ptr<earl::value::Obj>> &value,
+                                  std::shared_ptr<Ctx> &ctx,
+                                  Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(value, 1, "find", expr);
+    return dynamic_cast<earl::value::Str *>(obj.get())->find(value[0], expr);
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_member_rfind(std::shared_ptr<earl::value::Obj> obj,
+                                   std::vector<std::shared_ptr<earl::value::Obj>> &value,
+                                   std::shared_ptr<Ctx> &ctx,
+                                   Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(value, 1, "rfind", expr);
+    return dynamic_cast<earl::value::Str *>(obj.get())->rfind(value[0], expr);
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_member_count(std::shared_ptr<earl::value::Obj> obj,
+                                   std::vector<std::shared_ptr<earl::value::Obj>> &value,
+                                   std::shared_ptr<Ctx> &ctx,
+                                   Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(value, 1, "count", expr);
+    return dynamic_cast<earl::value::Str *>(obj.get())->count(value[0], expr);
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_member_replace(std::shared_ptr<earl::value::Obj> obj,
+                                     std::vector<std::shared_ptr<earl::value::Obj>> &values,
+                                     std::shared_ptr<Ctx> &ctx,
+                                     Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(values, 2, "replace", expr);
+    return dynamic_cast<earl::value::Str *>(obj.get())->replace(values[0], values[1], expr);
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_member_starts_with(std::shared_ptr<earl::value::Obj> obj,
+                                         std::vector<std::shared_ptr<earl::value::Obj>> &value,
+                                         std::shared_ptr<Ctx> &ctx,
+                                         Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(value, 1, "starts_with", expr);
+    return dynamic_cast<earl::value::Str *>(obj.get())->starts_with(value[0], expr);
+}
+
+std::shared_ptr<earl::value::Obj>
+Intrinsics::intrinsic_member_ends_with(std::shared_ptr<earl::value::Obj> obj,
+                                       std::vector<std::shared_ptr<earl::value::Obj>> &value,
+                                       std::shared_ptr<Ctx> &ctx,
+                                       Expr *expr) {
+    (void)ctx;
+    __INTR_ARGS_MUSTBE_SIZE(value, 1, "ends_with", expr);
+    return dynamic_cast<earl::value::Str *>(obj.get())->ends_with(value[0], expr);
+}
+
 std::shared_ptr<earl::value::Obj>
 Intrinsics::intrinsic_member_remove_lines(std::shared_ptr<earl::value::Obj> obj,
                                           std::vector<std::shared_ptr<earl::value::Obj>> &unused,
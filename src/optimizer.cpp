@@ -0,0 +1,327 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <string>
+#include <vector>
+
+#include "optimizer.hpp"
+
+namespace {
+
+    void optimize_stmt(Stmt *stmt);
+    void optimize_expr(Expr *expr);
+
+    // A constant that is a tuple (or contains one) cannot be
+    // copied with `Obj::copy` as that shares the elements.
+    bool
+    copyable(earl::value::Obj *value) {
+        return value->type() != earl::value::Type::Tuple;
+    }
+
+    // Folds a list or tuple literal if all of its elements are constants.
+    std::shared_ptr<earl::value::Obj>
+    fold_sequence(std::vector<std::unique_ptr<Expr>> &elems, bool tuple) {
+        std::vector<std::shared_ptr<earl::value::Obj>> values = {};
+        for (auto &elem : elems) {
+            optimize_expr(elem.get());
+            // Lists copy their elements lazily with `Obj::copy`.
+            if (!elem->m_const || (!tuple && !copyable(elem->m_const.get())))
+                return nullptr;
+            values.push_back(Optimizer::instance(elem->m_const.get()));
+        }
+        if (tuple)
+            return std::make_shared<earl::value::Tuple>(std::move(values));
+        return std::make_shared<earl::value::List>(std::move(values));
+    }
+
+    // Renders an f-string if every expression in it is a constant.
+    std::shared_ptr<earl::value::Obj>
+    fold_fstr(ExprFStr *expr) {
+        bool folds = true;
+        for (auto &elem : expr->m_exprs) {
+            optimize_expr(elem.get());
+            folds = folds && elem->m_const;
+        }
+        if (!folds)
+            return nullptr;
+        std::string result = expr->m_parts[0];
+        for (size_t i = 0; i < expr->m_exprs.size(); ++i)
+            result += expr->m_exprs[i]->m_const->to_cxxstring() + expr->m_parts[i+1];
+        return std::make_shared<earl::value::Str>(result);
+    }
+
+    void
+    optimize_block(StmtBlock *block) {
+        for (auto &stmt : block->m_stmts)
+            optimize_stmt(stmt.get());
+    }
+
+    void
+    optimize_funccall(ExprFuncCall *expr) {
+        optimize_expr(expr->m_left.get());
+        for (auto &param : expr->m_params)
+            optimize_expr(param.get());
+    }
+
+    void
+    optimize_term(ExprTerm *expr) {
+        switch (expr->get_term_type()) {
+        case ExprTermType::Func_Call: {
+            optimize_funccall(dynamic_cast<ExprFuncCall *>(expr));
+        } break;
+        case ExprTermType::List_Literal: {
+            expr->m_const = fold_sequence(dynamic_cast<ExprListLit *>(expr)->m_elems, /*tuple=*/false);
+        } break;
+        case ExprTermType::Tuple: {
+            expr->m_const = fold_sequence(dynamic_cast<ExprTuple *>(expr)->m_exprs, /*tuple=*/true);
+        } break;
+        case ExprTermType::Range: {
+            auto range = dynamic_cast<ExprRange *>(expr);
+            optimize_expr(range->m_start.get());
+            optimize_expr(range->m_end.get());
+        } break;
+        case ExprTermType::Slice: {
+            auto slice = dynamic_cast<ExprSlice *>(expr);
+            if (slice->m_start.has_value())
+                optimize_expr(slice->m_start.value().get());
+            if (slice->m_end.has_value())
+                optimize_expr(slice->m_end.value().get());
+        } break;
+        case ExprTermType::Get: {
+            auto get = dynamic_cast<ExprGet *>(expr);
+            optimize_expr(get->m_left.get());
+            if (std::holds_alternative<std::unique_ptr<ExprFuncCall>>(get->m_right))
+                for (auto &param : std::get<std::unique_ptr<ExprFuncCall>>(get->m_right)->m_params)
+                    optimize_expr(param.get());
+        } break;
+        case ExprTermType::Mod_Access: {
+            auto access = dynamic_cast<ExprModAccess *>(expr);
+            if (std::holds_alternative<std::unique_ptr<ExprFuncCall>>(access->m_right))
+                for (auto &param : std::get<std::unique_ptr<ExprFuncCall>>(access->m_right)->m_params)
+                    optimize_expr(param.get());
+        } break;
+        case ExprTermType::Array_Access: {
+            auto access = dynamic_cast<ExprArrayAccess *>(expr);
+            optimize_expr(access->m_left.get());
+            optimize_expr(access->m_expr.get());
+        } break;
+        case ExprTermType::Dict: {
+            for (auto &entry : dynamic_cast<ExprDict *>(expr)->m_values) {
+                optimize_expr(entry.first.get());
+                optimize_expr(entry.second.get());
+            }
+        } break;
+        case ExprTermType::FStr: {
+            expr->m_const = fold_fstr(dynamic_cast<ExprFStr *>(expr));
+        } break;
+        case ExprTermType::Closure: {
+            optimize_block(dynamic_cast<ExprClosure *>(expr)->m_block.get());
+        } break;
+        default: {
+            expr->m_const = Optimizer::fold_literal(expr);
+        } break;
+        }
+    }
+
+    void
+    optimize_expr(Expr *expr) {
+        using earl::value::Scalar;
+
+        switch (expr->get_type()) {
+        case ExprType::Term: {
+            optimize_term(dynamic_cast<ExprTerm *>(expr));
+        } break;
+        case ExprType::Binary: {
+            auto binary = dynamic_cast<ExprBinary *>(expr);
+            optimize_expr(binary->m_lhs.get());
+            optimize_expr(binary->m_rhs.get());
+
+            // `&&` and `||` yield one of their operands which is
+            // already constant if both of them are.
+            TokenType op = binary->m_op->type();
+            if (!binary->m_lhs->m_const || !binary->m_rhs->m_const
+                || op == TokenType::Double_Ampersand || op == TokenType::Double_Pipe)
+                break;
+
+            Scalar lhs = Scalar::unbox(binary->m_lhs->m_const.get());
+            Scalar rhs = Scalar::unbox(binary->m_rhs->m_const.get());
+            Scalar result;
+            if (lhs.tag != Scalar::Tag::None && rhs.tag != Scalar::Tag::None
+                && earl::value::scalar_binop(op, lhs, rhs, result))
+                expr->m_const = result.box();
+        } break;
+        case ExprType::Unary: {
+            auto unary = dynamic_cast<ExprUnary *>(expr);
+            optimize_expr(unary->m_expr.get());
+            if (!unary->m_expr->m_const)
+                break;
+
+            Scalar value = Scalar::unbox(unary->m_expr->m_const.get());
+            Scalar result;
+            if (value.tag != Scalar::Tag::None
+                && earl::value::scalar_unaryop(unary->m_op->type(), value, result))
+                expr->m_const = result.box();
+        } break;
+        }
+    }
+
+    void
+    optimize_stmt(Stmt *stmt) {
+        switch (stmt->stmt_type()) {
+        case StmtType::Def: {
+            optimize_block(dynamic_cast<StmtDef *>(stmt)->m_block.get());
+        } break;
+        case StmtType::Let: {
+            optimize_expr(dynamic_cast<StmtLet *>(stmt)->m_expr.get());
+        } break;
+        case StmtType::Block: {
+            optimize_block(dynamic_cast<StmtBlock *>(stmt));
+        } break;
+        case StmtType::Mut: {
+            auto mut = dynamic_cast<StmtMut *>(stmt);
+            optimize_expr(mut->m_left.get());
+            optimize_expr(mut->m_right.get());
+        } break;
+        case StmtType::Stmt_Expr: {
+            optimize_expr(dynamic_cast<StmtExpr *>(stmt)->m_expr.get());
+        } break;
+        case StmtType::If: {
+            auto if_ = dynamic_cast<StmtIf *>(stmt);
+            optimize_expr(if_->m_expr.get());
+            optimize_stmt(if_->m_block.get());
+            if (if_->m_else.has_value())
+                optimize_stmt(if_->m_else.value().get());
+        } break;
+        case StmtType::Return: {
+            auto ret = dynamic_cast<StmtReturn *>(stmt);
+            if (ret->m_expr.has_value())
+                optimize_expr(ret->m_expr.value().get());
+        } break;
+        case StmtType::While: {
+            auto while_ = dynamic_cast<StmtWhile *>(stmt);
+            optimize_expr(while_->m_expr.get());
+            optimize_block(while_->m_block.get());
+        } break;
+        case StmtType::Loop: {
+            optimize_block(dynamic_cast<StmtLoop *>(stmt)->m_block.get());
+        } break;
+        case StmtType::For: {
+            auto for_ = dynamic_cast<StmtFor *>(stmt);
+            optimize_expr(for_->m_start.get());
+            optimize_expr(for_->m_end.get());
+            optimize_block(for_->m_block.get());
+        } break;
+        case StmtType::Foreach: {
+            auto foreach = dynamic_cast<StmtForeach *>(stmt);
+            optimize_expr(foreach->m_expr.get());
+            optimize_block(foreach->m_block.get());
+        } break;
+        case StmtType::Class: {
+            auto class_ = dynamic_cast<StmtClass *>(stmt);
+            for (auto &member : class_->m_members)
+                optimize_stmt(member.get());
+            for (auto &method : class_->m_methods)
+                optimize_stmt(method.get());
+        } break;
+        case StmtType::Match: {
+            auto match = dynamic_cast<StmtMatch *>(stmt);
+            optimize_expr(match->m_expr.get());
+            for (auto &branch : match->m_branches) {
+                for (auto &pattern : branch->m_expr)
+                    optimize_expr(pattern.get());
+                if (branch->m_when.has_value())
+                    optimize_expr(branch->m_when.value().get());
+                optimize_block(branch->m_block.get());
+            }
+        } break;
+        case StmtType::Enum: {
+            for (auto &elem : dynamic_cast<StmtEnum *>(stmt)->m_elems)
+                if (elem.second)
+                    optimize_expr(elem.second.get());
+        } break;
+        default: break;
+        }
+    }
+
+};
+
+void
+Optimizer::optimize_program(Program *program) {
+    for (auto &stmt : program->m_stmts)
+        optimize_stmt(stmt.get());
+}
+
+std::shared_ptr<earl::value::Obj>
+Optimizer::instance(earl::value::Obj *value) {
+    if (copyable(value))
+        return value->copy();
+    std::vector<std::shared_ptr<earl::value::Obj>> values = {};
+    for (auto &elem : dynamic_cast<earl::value::Tuple *>(value)->value())
+        values.push_back(instance(elem.get()));
+    return std::make_shared<earl::value::Tuple>(std::move(values));
+}
+
+std::shared_ptr<earl::value::Obj>
+Optimizer::fold_literal(ExprTerm *expr) {
+    switch (expr->get_term_type()) {
+    case ExprTermType::Int_Literal: {
+        try {
+            return std::make_shared<earl::value::Int>(std::stoi(dynamic_cast<ExprIntLit *>(expr)->m_tok->lexeme()));
+        } catch (...) {
+            return nullptr;
+        }
+    } break;
+    case ExprTermType::Float_Literal: {
+        try {
+            return std::make_shared<earl::value::Float>(std::stof(dynamic_cast<ExprFloatLit *>(expr)->m_tok->lexeme()));
+        } catch (...) {
+            return nullptr;
+        }
+    } break;
+    case ExprTermType::Str_Literal:
+        return std::make_shared<earl::value::Str>(dynamic_cast<ExprStrLit *>(expr)->m_tok->lexeme());
+    case ExprTermType::Char_Literal:
+        return std::make_shared<earl::value::Char>(Optimizer::charlit_value(dynamic_cast<ExprCharLit *>(expr)));
+    case ExprTermType::Bool:
+        return std::make_shared<earl::value::Bool>(dynamic_cast<ExprBool *>(expr)->m_value);
+    default:
+        return nullptr;
+    }
+}
+
+char
+Optimizer::charlit_value(ExprCharLit *expr) {
+    const std::string &lexeme = expr->m_tok->lexeme();
+    if (lexeme == "\\n")
+        return '\n';
+    else if (lexeme == "\\t")
+        return '\t';
+    else if (lexeme == "\\r")
+        return '\r';
+    else if (lexeme == "\\0")
+        return '\0';
+    else if (lexeme == "\\\\")
+        return '\\';
+    return lexeme[0];
+}
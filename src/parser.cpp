@@ -22,6 +22,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <optional>
@@ -32,14 +33,16 @@
 #include "ast.hpp"
 #include "common.hpp"
 #include "parser.hpp"
+#include "resolver.hpp"
+#include "optimizer.hpp"
 
-std::vector<std::pair<std::shared_ptr<Token>, uint32_t>> parse_stmt_def_args(Lexer &lexer);
+std::vector<std::pair<Token *, uint32_t>> parse_stmt_def_args(Lexer &lexer);
 
 static Attr
 translate_attr(Lexer &lexer) {
     auto errtok = Parser::parse_expect(lexer, TokenType::At);
 
-    std::shared_ptr<Token> attr = Parser::parse_expect(lexer, TokenType::Ident);
+    Token *attr = Parser::parse_expect(lexer, TokenType::Ident);
     if (attr->lexeme() == COMMON_EARLATTR_PUB)
         return Attr::Pub;
     if (attr->lexeme() == COMMON_EARLATTR_WORLD)
@@ -49,7 +52,7 @@ translate_attr(Lexer &lexer) {
     if (attr->lexeme() == COMMON_EARLATTR_CONST)
         return Attr::Const;
     else {
-        Err::err_wtok(errtok.get());
+        Err::err_wtok(errtok);
         std::string msg = "unknown attribute `" + attr->lexeme() + "`";
         throw ParserException(msg);
     }
@@ -63,11 +66,11 @@ gather_attrs(Lexer &lexer) {
     return attrs;
 }
 
-std::shared_ptr<Token>
+Token *
 Parser::parse_expect(Lexer &lexer, TokenType expected) {
-    std::shared_ptr<Token> tok = lexer.next();
+    Token *tok = lexer.next();
     if (tok->type() != expected) {
-        Err::err_wtok(tok.get());
+        Err::err_wtok(tok);
         std::string msg = "expected "
             + tokentype_to_str(expected)
             + ", got "
@@ -78,16 +81,16 @@ Parser::parse_expect(Lexer &lexer, TokenType expected) {
     return tok;
 }
 
-std::shared_ptr<Token>
+Token *
 Parser::parse_expect_keyword(Lexer &lexer, std::string expected) {
-    std::shared_ptr<Token> tok = lexer.next();
+    Token *tok = lexer.next();
     if (tok->type() != TokenType::Keyword) {
-        Err::err_wtok(tok.get());
+        Err::err_wtok(tok);
         std::string msg = "expected keyword `"+expected+"`, but got `" + tok->lexeme() + "` which is not a keyword";
         throw ParserException(msg);
     }
     if (tok->lexeme() != expected) {
-        Err::err_wtok(tok.get());
+        Err::err_wtok(tok);
         std::string msg = "expected keyword `"+expected+"`, but got `" + tok->lexeme() + "` which is not the correct keyword";
         throw ParserException(msg);
     }
@@ -149,9 +152,9 @@ parse_identifier_or_funccall(Lexer &lexer) {
     return ident;
 }
 
-static std::vector<std::pair<std::shared_ptr<Token>, uint32_t>>
+static std::vector<std::pair<Token *, uint32_t>>
 parse_closure_args(Lexer &lexer) {
-    std::vector<std::pair<std::shared_ptr<Token>, uint32_t>> args;
+    std::vector<std::pair<Token *, uint32_t>> args;
 
     while (lexer.peek(0) && lexer.peek()->type() != TokenType::Pipe) {
         uint32_t attr = 0;
@@ -160,8 +163,8 @@ parse_closure_args(Lexer &lexer) {
             attr |= static_cast<uint32_t>(translate_attr(lexer));
         }
 
-        std::shared_ptr<Token> id = Parser::parse_expect(lexer, TokenType::Ident);
-        std::shared_ptr<Token> var = std::move(id);
+        Token *id = Parser::parse_expect(lexer, TokenType::Ident);
+        Token *var = std::move(id);
         args.push_back(std::make_pair(std::move(var), attr));
 
         if (lexer.peek(0) && lexer.peek()->type() == TokenType::Comma)
@@ -190,6 +193,105 @@ parse_set_values(Lexer &lexer) {
     return values;
 }
 
+// Gets the index of the `}` that closes the `{` right before
+// `start` in an f-string, skipping over nested braces and quotes.
+static size_t
+fstr_closing_brace(const std::string &str, size_t start) {
+    int depth = 0;
+    char quote = '\0';
+    for (size_t i = start; i < str.size(); ++i) {
+        char c = str[i];
+        if (quote) {
+            if (c == '\\')
+                ++i;
+            else if (c == quote)
+                quote = '\0';
+        }
+        else if (c == '"' || c == '\'')
+            quote = c;
+        else if (c == '{')
+            ++depth;
+        else if (c == '}' && depth-- == 0)
+            return i;
+    }
+    return std::string::npos;
+}
+
+// Splits the f-string `tok` into its text and the expressions
+// in between `{}`. The expressions are lexed on their own and
+// their tokens are moved to where they are in the source.
+static ExprFStr *
+parse_fstr(Token *tok) {
+    std::vector<std::string> keywords = COMMON_EARLKW_ASCPL;
+    std::vector<std::string> types    = {};
+    std::string comment               = COMMON_EARL_COMMENT;
+
+    const std::string &str = tok->lexeme();
+    std::vector<std::string> parts = {""};
+    std::vector<std::unique_ptr<Expr>> exprs = {};
+    std::vector<size_t> offsets = {};
+    std::string src = "";
+
+    for (size_t i = 0; i < str.size(); ++i) {
+        if (str[i] != '{') {
+            parts.back().push_back(str[i]);
+            continue;
+        }
+        // `{{` is a literal `{`, since a lone one opens an expression.
+        if (i+1 < str.size() && str[i+1] == '{') {
+            parts.back().push_back('{');
+            ++i;
+            continue;
+        }
+        size_t end = fstr_closing_brace(str, i+1);
+        if (end == std::string::npos) {
+            Err::err_wtok(tok);
+            const std::string msg = "unterminated `{` in f-string";
+            throw ParserException(msg);
+        }
+        // Every expression goes on its own line.
+        offsets.push_back(i+1);
+        src += str.substr(i+1, end-i-1) + ";\n";
+        parts.emplace_back();
+        i = end;
+    }
+
+    if (offsets.empty())
+        return new ExprFStr(tok, std::move(parts), std::move(exprs), nullptr);
+
+    std::unique_ptr<Lexer> lexer = lex_file(src, tok->fp(), keywords, types, comment);
+    for (auto &t : lexer->m_toks) {
+        if (t.type() == TokenType::Eof)
+            continue;
+        size_t line = std::min(t.m_row, offsets.size());
+        t.m_col += tok->m_col + offsets[line-1];
+        t.m_row = tok->m_row;
+    }
+
+    for (size_t i = 0; i < offsets.size(); ++i) {
+        if (lexer->peek()->type() == TokenType::Semicolon) {
+            Err::err_wtok(tok);
+            const std::string msg = "expected an expression inside of `{}` in f-string";
+            throw ParserException(msg);
+        }
+        exprs.push_back(std::unique_ptr<Expr>(Parser::parse_expr(*lexer.get())));
+        if (lexer->peek()->type() != TokenType::Semicolon) {
+            Err::err_wtok(lexer->peek());
+            const std::string msg = "unexpected token inside of `{}` in f-string";
+            throw ParserException(msg);
+        }
+        lexer->discard();
+    }
+
+    if (lexer->peek()->type() != TokenType::Eof) {
+        Err::err_wtok(lexer->peek());
+        const std::string msg = "unexpected token inside of `{}` in f-string";
+        throw ParserException(msg);
+    }
+
+    return new ExprFStr(tok, std::move(parts), std::move(exprs), std::move(lexer));
+}
+
 static Expr *
 parse_primary_expr(Lexer &lexer, char fail_on = '\0') {
     Token *tok = nullptr;
@@ -200,7 +302,7 @@ parse_primary_expr(Lexer &lexer, char fail_on = '\0') {
     while (lexer.peek(0) && (lexer.peek()->type() == TokenType::Minus
                              || lexer.peek()->type() == TokenType::Bang
                              || lexer.peek()->type() == TokenType::Backtick_Tilde)) {
-        std::shared_ptr<Token> op = lexer.next();
+        Token *op = lexer.next();
         Expr *operand = parse_primary_expr(lexer, fail_on);
         left = new ExprUnary(std::move(op), std::unique_ptr<Expr>(operand));
     }
@@ -263,7 +365,7 @@ parse_primary_expr(Lexer &lexer, char fail_on = '\0') {
                 if (left_term->get_term_type() == ExprTermType::Ident) {
                     auto left_ident = dynamic_cast<ExprIdent *>(left_term);
                     if (left_ident->m_tok->lexeme() == "f")
-                        left = new ExprFStr(lexer.next());
+                        left = parse_fstr(lexer.next());
                     else
                         goto not_fstr;
                 }
@@ -283,7 +385,7 @@ parse_primary_expr(Lexer &lexer, char fail_on = '\0') {
                 auto tok = lexer.next(); // [
                 Expr *idx = Parser::parse_expr(lexer);
                 if (!idx) {
-                    Err::err_wtok(tok.get());
+                    Err::err_wtok(tok);
                     const std::string msg = "list access requires an index";
                     throw ParserException(msg);
                 }
@@ -328,7 +430,7 @@ parse_primary_expr(Lexer &lexer, char fail_on = '\0') {
             if (fail_on == '|')
                 return left;
             auto tok = lexer.next(); // |
-            std::vector<std::pair<std::shared_ptr<Token>, uint32_t>> args = parse_closure_args(lexer);
+            std::vector<std::pair<Token *, uint32_t>> args = parse_closure_args(lexer);
             auto block = Parser::parse_stmt_block(lexer);
             return new ExprClosure(std::move(args), std::move(block), tok);
         }
@@ -338,7 +440,7 @@ parse_primary_expr(Lexer &lexer, char fail_on = '\0') {
             if (lexer.peek(0) && lexer.peek()->lexeme() == COMMON_EARLKW_WHEN)
                 return left;
 
-            std::shared_ptr<Token> kw = lexer.next();
+            Token *kw = lexer.next();
             if (kw->lexeme() == COMMON_EARLKW_TRUE) {
                 return new ExprBool(std::move(kw), true);
             }
@@ -349,7 +451,7 @@ parse_primary_expr(Lexer &lexer, char fail_on = '\0') {
                 return new ExprNone(std::move(kw));
             }
             else {
-                Err::err_wtok(kw.get());
+                Err::err_wtok(kw);
                 std::string msg = "invalid keyword `" + kw->lexeme() + "` while parsing primary expression";
                 throw ParserException(msg);
             }
@@ -367,7 +469,7 @@ parse_power_expr(Lexer &lexer, char fail_on='\0') {
     Expr *lhs = parse_primary_expr(lexer, fail_on);
     Token *cur = lexer.peek();
     while (cur && (cur->type() == TokenType::Double_Asterisk)) {
-        std::shared_ptr<Token> op = lexer.next();
+        Token *op = lexer.next();
         Expr *rhs = parse_primary_expr(lexer, fail_on);
         lhs = new ExprBinary(std::unique_ptr<Expr>(lhs),
                              std::move(op),
@@ -384,7 +486,7 @@ parse_multiplicative_expr(Lexer &lexer, char fail_on = '\0') {
     while (cur && (cur->type() == TokenType::Asterisk
                    || cur->type() == TokenType::Forwardslash
                    || cur->type() == TokenType::Percent)) {
-        std::shared_ptr<Token> op = lexer.next();
+        Token *op = lexer.next();
         Expr *rhs = parse_power_expr(lexer, fail_on);
         lhs = new ExprBinary(std::unique_ptr<Expr>(lhs),
                              std::move(op),
@@ -400,7 +502,7 @@ parse_additive_expr(Lexer &lexer, char fail_on = '\0') {
     Token *cur = lexer.peek();
     while (cur && (cur->type() == TokenType::Plus
                    || cur->type() == TokenType::Minus)) {
-        std::shared_ptr<Token> op = lexer.next();
+        Token *op = lexer.next();
         Expr *rhs = parse_multiplicative_expr(lexer, fail_on);
         lhs = new ExprBinary(std::unique_ptr<Expr>(lhs),
                              std::move(op),
@@ -420,7 +522,7 @@ parse_equalitative_expr(Lexer &lexer, char fail_on = '\0') {
                    || cur->type() == TokenType::Lessthan_Equals
                    || cur->type() == TokenType::Lessthan
                    || cur->type() == TokenType::Bang_Equals)) {
-        std::shared_ptr<Token> op = lexer.next();
+        Token *op = lexer.next();
         Expr *rhs = parse_additive_expr(lexer, fail_on);
         lhs = new ExprBinary(std::unique_ptr<Expr>(lhs),
                              std::move(op),
@@ -436,7 +538,7 @@ parse_logical_expr(Lexer &lexer, char fail_on = '\0') {
     Token *cur = lexer.peek();
     while (cur && (cur->type() == TokenType::Double_Ampersand
                    || cur->type() == TokenType::Double_Pipe)) {
-        std::shared_ptr<Token> op = lexer.next();
+        Token *op = lexer.next();
         Expr *rhs = parse_equalitative_expr(lexer, fail_on);
         lhs = new ExprBinary(std::unique_ptr<Expr>(lhs),
                              std::move(op),
@@ -455,7 +557,7 @@ parse_bitwise_expr(Lexer &lexer, char fail_on = '\0') {
                    || cur->type() == TokenType::Backtick_Caret
                    || cur->type() == TokenType::Backtick_Pipe
                    || cur->type() == TokenType::Backtick_Ampersand)) {
-        std::shared_ptr<Token> op = lexer.next();
+        Token *op = lexer.next();
         Expr *rhs = parse_logical_expr(lexer);
         lhs = new ExprBinary(std::unique_ptr<Expr>(lhs),
                              std::move(op),
@@ -562,7 +664,7 @@ std::unique_ptr<StmtLet>
 Parser::parse_stmt_let(Lexer &lexer, uint32_t attrs) {
     (void)Parser::parse_expect_keyword(lexer, COMMON_EARLKW_LET);
 
-    std::vector<std::shared_ptr<Token>> ids = {parse_expect(lexer, TokenType::Ident)};
+    std::vector<Token *> ids = {parse_expect(lexer, TokenType::Ident)};
 
     while (lexer.peek(0) && lexer.peek(0)->type() == TokenType::Comma) {
         lexer.discard(); // ,
@@ -605,9 +707,9 @@ Parser::parse_stmt_block(Lexer &lexer) {
     return std::make_unique<StmtBlock>(std::move(stmts));
 }
 
-std::vector<std::pair<std::shared_ptr<Token>, uint32_t>>
+std::vector<std::pair<Token *, uint32_t>>
 parse_stmt_def_args(Lexer &lexer) {
-    std::vector<std::pair<std::shared_ptr<Token>, uint32_t>> args;
+    std::vector<std::pair<Token *, uint32_t>> args;
 
     (void)Parser::parse_expect(lexer, TokenType::Lparen);
     while (lexer.peek(0) && lexer.peek()->type() != TokenType::Rparen) {
@@ -617,8 +719,8 @@ parse_stmt_def_args(Lexer &lexer) {
             attr |= static_cast<uint32_t>(translate_attr(lexer));
         }
 
-        std::shared_ptr<Token> id = Parser::parse_expect(lexer, TokenType::Ident);
-        std::shared_ptr<Token> var = std::move(id);
+        Token *id = Parser::parse_expect(lexer, TokenType::Ident);
+        Token *var = std::move(id);
         args.push_back(std::make_pair(std::move(var), attr));
 
         if (lexer.peek(0) && lexer.peek()->type() == TokenType::Comma)
@@ -633,7 +735,7 @@ std::unique_ptr<StmtDef>
 Parser::parse_stmt_def(Lexer &lexer, uint32_t attrs) {
     (void)parse_expect_keyword(lexer, COMMON_EARLKW_FN);
 
-    std::shared_ptr<Token> id = Parser::parse_expect(lexer, TokenType::Ident);
+    Token *id = Parser::parse_expect(lexer, TokenType::Ident);
 
     auto args = parse_stmt_def_args(lexer);
 
@@ -668,7 +770,7 @@ std::unique_ptr<StmtForeach>
 parse_stmt_foreach(Lexer &lexer) {
     (void)Parser::parse_expect_keyword(lexer, COMMON_EARLKW_FOREACH);
     uint32_t attrs = gather_attrs(lexer);
-    std::shared_ptr<Token> enumerator = Parser::parse_expect(lexer, TokenType::Ident);
+    Token *enumerator = Parser::parse_expect(lexer, TokenType::Ident);
     (void)Parser::parse_expect_keyword(lexer, COMMON_EARLKW_IN);
     Expr *expr = Parser::parse_expr(lexer, /*fail_on=*/'{');
     std::unique_ptr<StmtBlock> block = Parser::parse_stmt_block(lexer);
@@ -682,7 +784,7 @@ std::unique_ptr<StmtFor>
 parse_stmt_for(Lexer &lexer) {
     (void)Parser::parse_expect_keyword(lexer, COMMON_EARLKW_FOR);
 
-    std::shared_ptr<Token> enumerator = Parser::parse_expect(lexer, TokenType::Ident);
+    Token *enumerator = Parser::parse_expect(lexer, TokenType::Ident);
 
     (void)Parser::parse_expect_keyword(lexer, COMMON_EARLKW_IN);
 
@@ -701,8 +803,8 @@ parse_stmt_for(Lexer &lexer) {
 std::unique_ptr<Stmt>
 parse_stmt_import(Lexer &lexer) {
     (void)Parser::parse_expect_keyword(lexer, COMMON_EARLKW_IMPORT);
-    std::shared_ptr<Token> fp = Parser::parse_expect(lexer, TokenType::Strlit);
-    std::optional<std::shared_ptr<Token>> depth = {};
+    Token *fp = Parser::parse_expect(lexer, TokenType::Strlit);
+    std::optional<Token *> depth = {};
     Token *peek = lexer.peek(0);
     if (peek && peek->type() == TokenType::Keyword && (peek->lexeme() == COMMON_EARLKW_ALMOST || peek->lexeme() == COMMON_EARLKW_FULL))
         depth = lexer.next();
@@ -712,13 +814,13 @@ parse_stmt_import(Lexer &lexer) {
 std::unique_ptr<Stmt>
 parse_stmt_mod(Lexer &lexer) {
     (void)Parser::parse_expect_keyword(lexer, COMMON_EARLKW_MODULE);
-    std::shared_ptr<Token> id = Parser::parse_expect(lexer, TokenType::Ident);
+    Token *id = Parser::parse_expect(lexer, TokenType::Ident);
     return std::make_unique<StmtMod>(std::move(id));
 }
 
-static std::vector<std::shared_ptr<Token>>
+static std::vector<Token *>
 parse_stmt_class_constructor_arguments(Lexer &lexer) {
-    std::vector<std::shared_ptr<Token>> ids;
+    std::vector<Token *> ids;
 
     if (lexer.peek(0) && lexer.peek()->type() == TokenType::Lbracket) {
         lexer.discard();
@@ -743,7 +845,7 @@ std::unique_ptr<StmtClass>
 parse_stmt_class(Lexer &lexer, uint32_t attrs) {
     (void)Parser::parse_expect_keyword(lexer, COMMON_EARLKW_CLASS);
 
-    std::shared_ptr<Token> class_id = Parser::parse_expect(lexer, TokenType::Ident);
+    Token *class_id = Parser::parse_expect(lexer, TokenType::Ident);
 
     std::vector<std::unique_ptr<StmtLet>> members;
     std::vector<std::unique_ptr<StmtDef>> methods;
@@ -849,7 +951,7 @@ parse_stmt_match(Lexer &lexer) {
 
 std::unique_ptr<StmtBreak>
 parse_stmt_break(Lexer &lexer) {
-    std::shared_ptr<Token> br = Parser::parse_expect_keyword(lexer, COMMON_EARLKW_BREAK);
+    Token *br = Parser::parse_expect_keyword(lexer, COMMON_EARLKW_BREAK);
     (void)Parser::parse_expect(lexer, TokenType::Semicolon);
     return std::make_unique<StmtBreak>(std::move(br));
 }
@@ -864,8 +966,8 @@ parse_stmt_continue(Lexer &lexer) {
 std::unique_ptr<StmtEnum>
 parse_stmt_enum(Lexer &lexer, uint32_t attrs) {
     (void)Parser::parse_expect_keyword(lexer, COMMON_EARLKW_ENUM);
-    std::shared_ptr<Token> id = Parser::parse_expect(lexer, TokenType::Ident);
-    std::vector<std::pair<std::shared_ptr<Token>, std::unique_ptr<Expr>>> elems = {};
+    Token *id = Parser::parse_expect(lexer, TokenType::Ident);
+    std::vector<std::pair<Token *, std::unique_ptr<Expr>>> elems = {};
     Parser::parse_expect(lexer, TokenType::Lbrace);
     while (1) {
         if (lexer.peek(0) && lexer.peek(0)->type() == TokenType::Rbrace) {
@@ -989,10 +1091,21 @@ Parser::parse_stmt(Lexer &lexer) {
 }
 
 std::unique_ptr<Program> Parser::parse_program(Lexer &lexer, const std::string filepath) {
+    // Declared before `stmts` so a parse error unwinds the
+    // nodes before the memory they live in. The first chunk is
+    // sized from the token count so that short programs, REPL
+    // lines in particular, do not each hold a full chunk.
+    size_t first_chunk = std::clamp<size_t>(lexer.m_toks.size()*64, 256, Arena::ARENA_MIN_CHUNK);
+    auto arena = std::make_unique<Arena>(first_chunk);
+    AstArenaScope scope(arena.get());
     std::vector<std::unique_ptr<Stmt>> stmts;
 
     while (lexer.peek(0) && lexer.peek()->type() != TokenType::Eof)
         stmts.push_back(parse_stmt(lexer));
 
-    return std::make_unique<Program>(std::move(stmts), filepath);
+    auto program = std::make_unique<Program>(std::move(arena), std::move(stmts), filepath);
+    Resolver::resolve_program(program.get());
+    Optimizer::optimize_program(program.get());
+    program->m_defines = scope.m_defines;
+    return program;
 }
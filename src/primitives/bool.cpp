@@ -33,6 +33,11 @@ using namespace earl::value;
 
 Bool::Bool(bool value) : m_value(value) {}
 
+void
+Bool::fill(bool value) {
+    m_value = value;
+}
+
 bool
 Bool::value(void) {
     return m_value;
@@ -97,8 +102,9 @@ Bool::copy(void) {
 
 bool
 Bool::eq(std::shared_ptr<Obj> &other) {
-    (void)other;
-    UNIMPLEMENTED("Bool::eq");
+    if (other->type() != Type::Bool)
+        return false;
+    return this->value() == dynamic_cast<Bool *>(other.get())->value();
 }
 
 std::string
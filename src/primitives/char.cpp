@@ -32,12 +32,24 @@
 
 using namespace earl::value;
 
-Char::Char(char value) {
+Char::Char(char value) : m_value(value), m_str(nullptr), m_idx(0) {}
+
+Char::Char(std::shared_ptr<Str> str, size_t idx)
+    : m_value(str->at(idx)), m_str(std::move(str)), m_idx(idx) {}
+
+void
+Char::fill(char value) {
     m_value = value;
+    // The str may have shrunk since, in which case this
+    // char is on its own.
+    if (m_str && m_idx < m_str->size())
+        m_str->set(m_idx, value);
 }
 
 char
 Char::value(void) {
+    if (m_str && m_idx < m_str->size())
+        m_value = m_str->at(m_idx);
     return m_value;
 }
 
@@ -75,12 +87,12 @@ Char::mutate(const std::shared_ptr<Obj> &other, StmtMut *stmt) {
     ASSERT_MUTATE_COMPAT(this, other.get(), stmt);
     ASSERT_CONSTNESS(this, stmt);
     auto c = dynamic_cast<Char *>(other.get());
-    m_value = c->value();
+    this->fill(c->value());
 }
 
 std::shared_ptr<Obj>
 Char::copy(void) {
-    return std::make_shared<Char>(m_value);
+    return std::make_shared<Char>(this->value());
 }
 
 bool
@@ -92,7 +104,7 @@ Char::eq(std::shared_ptr<Obj> &other) {
 
 std::string
 Char::to_cxxstring(void) {
-    return std::string(1, m_value);
+    return std::string(1, this->value());
 }
 
 void
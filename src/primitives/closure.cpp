@@ -45,7 +45,7 @@ Closure::block(void) {
 
 Token *
 Closure::tok(void) const {
-    return m_expr_closure->m_tok.get();
+    return m_expr_closure->m_tok;
 }
 
 void
@@ -66,7 +66,7 @@ std::shared_ptr<Obj>
 Closure::call(std::vector<std::shared_ptr<earl::value::Obj>> &values, std::shared_ptr<Ctx> &ctx) {
     ctx->push_scope();
     load_parameters(values, ctx);
-    auto result = Interpreter::eval_stmt_block(this->block(), ctx);
+    auto result = Interpreter::eval_body(this->block(), ctx);
     ctx->pop_scope();
     return result;
 }
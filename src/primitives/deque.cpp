@@ -0,0 +1,177 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cassert>
+#include <memory>
+
+#include "earl.hpp"
+#include "err.hpp"
+#include "utils.hpp"
+
+using namespace earl::value;
+
+Deque::Deque(std::deque<std::shared_ptr<Obj>> values) : m_values(std::move(values)) {}
+
+std::deque<std::shared_ptr<Obj>> &
+Deque::value(void) {
+    return m_values;
+}
+
+size_t
+Deque::size(void) const {
+    return m_values.size();
+}
+
+void
+Deque::push_back(std::shared_ptr<Obj> value) {
+    m_values.push_back(std::move(value));
+}
+
+void
+Deque::push_front(std::shared_ptr<Obj> value) {
+    m_values.push_front(std::move(value));
+}
+
+std::shared_ptr<Obj>
+Deque::pop_back(void) {
+    if (m_values.empty())
+        return std::make_shared<Option>();
+    auto value = std::move(m_values.back());
+    m_values.pop_back();
+    return value;
+}
+
+std::shared_ptr<Obj>
+Deque::pop_front(void) {
+    if (m_values.empty())
+        return std::make_shared<Option>();
+    auto value = std::move(m_values.front());
+    m_values.pop_front();
+    return value;
+}
+
+std::shared_ptr<Obj>
+Deque::back(void) {
+    if (m_values.empty())
+        return std::make_shared<Option>();
+    return m_values.back()->copy();
+}
+
+std::shared_ptr<Obj>
+Deque::front(void) {
+    if (m_values.empty())
+        return std::make_shared<Option>();
+    return m_values.front()->copy();
+}
+
+/*** OVERRIDES ***/
+Type
+Deque::type(void) const {
+    return Type::Deque;
+}
+
+std::shared_ptr<Obj>
+Deque::binop(Token *op, std::shared_ptr<Obj> &other) {
+    ASSERT_BINOP_COMPAT(this, other.get(), op);
+
+    switch (op->type()) {
+    case TokenType::Double_Equals: return std::make_shared<Bool>(this->eq(other));
+    case TokenType::Bang_Equals: return std::make_shared<Bool>(!this->eq(other));
+    default: {
+        Err::err_wtok(op);
+        std::string msg = "invalid binary operator";
+        throw InterpreterException(msg);
+    }
+    }
+    assert(false && "unreachable");
+    return nullptr;
+}
+
+bool
+Deque::boolean(void) {
+    return !m_values.empty();
+}
+
+void
+Deque::mutate(const std::shared_ptr<Obj> &other, StmtMut *stmt) {
+    ASSERT_MUTATE_COMPAT(this, other.get(), stmt);
+    ASSERT_CONSTNESS(this, stmt);
+    m_values = dynamic_cast<Deque *>(other.get())->value();
+}
+
+std::shared_ptr<Obj>
+Deque::copy(void) {
+    std::deque<std::shared_ptr<Obj>> values = {};
+    for (auto &v : m_values)
+        values.push_back(v->copy());
+    return std::make_shared<Deque>(std::move(values));
+}
+
+bool
+Deque::eq(std::shared_ptr<Obj> &other) {
+    if (other->type() != Type::Deque)
+        return false;
+
+    auto &values = dynamic_cast<Deque *>(other.get())->value();
+    if (m_values.size() != values.size())
+        return false;
+
+    for (size_t i = 0; i < m_values.size(); ++i)
+        if (!m_values[i]->eq(values[i]))
+            return false;
+    return true;
+}
+
+std::string
+Deque::to_cxxstring(void) {
+    std::string res = "<Deque [";
+    for (size_t i = 0; i < m_values.size(); ++i) {
+        res += m_values[i]->to_cxxstring();
+        if (i != m_values.size()-1)
+            res += ", ";
+    }
+    res += "]>";
+    return res;
+}
+
+void
+Deque::spec_mutate(Token *op, const std::shared_ptr<Obj> &other, StmtMut *stmt) {
+    (void)other;
+    (void)stmt;
+    Err::err_wtok(op);
+    std::string msg = "invalid operator for special mutation on type `deque`";
+    throw InterpreterException(msg);
+}
+
+std::shared_ptr<Obj>
+Deque::unaryop(Token *op) {
+    Err::err_wtok(op);
+    std::string msg = "invalid unary operator for type `deque`";
+    throw InterpreterException(msg);
+}
+
+void
+Deque::set_const(void) {
+    m_const = true;
+}
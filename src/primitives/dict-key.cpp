@@ -0,0 +1,129 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cassert>
+#include <cstring>
+
+#include "earl.hpp"
+
+using namespace earl::value;
+
+bool
+DictKey::Part::operator==(const Part &other) const {
+    return type == other.type && bits == other.bits && str == other.str;
+}
+
+bool
+DictKey::flatten(Obj *value, std::vector<Part> &parts) {
+    Part part = {value->type(), 0, ""};
+    switch (part.type) {
+    case Type::Int: {
+        part.bits = dynamic_cast<Int *>(value)->value();
+    } break;
+    case Type::Float: {
+        double f = dynamic_cast<Float *>(value)->value();
+        if (f == 0.0)
+            f = 0.0; // -0.0 == 0.0
+        std::memcpy(&part.bits, &f, sizeof f);
+    } break;
+    case Type::Bool: {
+        part.bits = dynamic_cast<Bool *>(value)->value();
+    } break;
+    case Type::Char: {
+        part.bits = dynamic_cast<Char *>(value)->value();
+    } break;
+    case Type::Str: {
+        part.str = dynamic_cast<Str *>(value)->view();
+    } break;
+    case Type::Tuple: {
+        auto &values = dynamic_cast<Tuple *>(value)->value();
+        part.bits = static_cast<int64_t>(values.size());
+        parts.push_back(part);
+        for (auto &v : values)
+            if (!flatten(v.get(), parts))
+                return false;
+        return true;
+    }
+    default: return false;
+    }
+    parts.push_back(std::move(part));
+    return true;
+}
+
+bool
+DictKey::from(Obj *value, DictKey &out) {
+    out.m_parts.clear();
+    if (!flatten(value, out.m_parts))
+        return false;
+
+    FlatHash hasher;
+    uint64_t h = 0;
+    for (auto &part : out.m_parts) {
+        h = FlatHash::mix(h ^ (static_cast<uint64_t>(part.type) << 56) ^ static_cast<uint64_t>(part.bits));
+        if (!part.str.empty())
+            h ^= hasher(std::string_view(part.str));
+    }
+    out.m_hash = h;
+    return true;
+}
+
+std::shared_ptr<Obj>
+DictKey::build(const std::vector<Part> &parts, size_t &i) {
+    const Part &part = parts[i++];
+    switch (part.type) {
+    case Type::Int: return std::make_shared<Int>(static_cast<int>(part.bits));
+    case Type::Float: {
+        double f;
+        std::memcpy(&f, &part.bits, sizeof f);
+        return std::make_shared<Float>(f);
+    }
+    case Type::Bool: return std::make_shared<Bool>(part.bits != 0);
+    case Type::Char: return std::make_shared<Char>(static_cast<char>(part.bits));
+    case Type::Str: return std::make_shared<Str>(part.str);
+    case Type::Tuple: {
+        std::vector<std::shared_ptr<Obj>> values = {};
+        for (int64_t n = 0; n < part.bits; ++n)
+            values.push_back(build(parts, i));
+        return std::make_shared<Tuple>(values);
+    }
+    default: assert(false && "unreachable");
+    }
+    return nullptr; // unreachable
+}
+
+uint64_t
+DictKey::hash(void) const {
+    return m_hash;
+}
+
+std::shared_ptr<Obj>
+DictKey::value(void) const {
+    size_t i = 0;
+    return build(m_parts, i);
+}
+
+bool
+DictKey::operator==(const DictKey &other) const {
+    return m_hash == other.m_hash && m_parts == other.m_parts;
+}
@@ -36,7 +36,7 @@ Enum::Enum(StmtEnum *stmt,
            std::unordered_map<std::string, std::shared_ptr<variable::Obj>> elems,
            uint32_t attrs)
     : m_stmt(stmt), m_elems(std::move(elems)), m_attrs(attrs) {
-    m_id = stmt->m_id.get();
+    m_id = stmt->m_id;
 }
 
 const std::string &
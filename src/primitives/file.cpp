@@ -125,7 +125,7 @@ File::write(std::shared_ptr<Obj> value) {
     } break;
     case Type::Str: {
         auto str = dynamic_cast<Str *>(value.get());
-        m_stream << str->value();
+        m_stream << str->view();
     } break;
     default: {
         std::string msg = "cannot write `"+type_to_str(value->type())+"` type to a file";
@@ -0,0 +1,215 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cassert>
+#include <memory>
+
+#include "earl.hpp"
+#include "err.hpp"
+#include "utils.hpp"
+
+using namespace earl::value;
+
+Heap::Heap(std::shared_ptr<Obj> f) : m_f(f), m_comparator(false) {
+    if (m_f)
+        m_comparator = dynamic_cast<Closure *>(m_f.get())->params_len() == 2;
+}
+
+size_t
+Heap::size(void) const {
+    return m_entries.size();
+}
+
+Heap::Entry
+Heap::make_entry(std::shared_ptr<Obj> value, std::shared_ptr<Ctx> &ctx, Expr *expr) {
+    (void)expr;
+    if (!m_f || m_comparator)
+        return {value, value};
+    std::vector<std::shared_ptr<Obj>> values = {value};
+    auto key = dynamic_cast<Closure *>(m_f.get())->call(values, ctx);
+    return {key, value};
+}
+
+bool
+Heap::before(const Entry &a, const Entry &b, std::shared_ptr<Ctx> &ctx, Expr *expr) {
+    if (m_comparator) {
+        std::vector<std::shared_ptr<Obj>> values = {a.value, b.value};
+        auto res = dynamic_cast<Closure *>(m_f.get())->call(values, ctx);
+        if (res->type() != Type::Bool) {
+            Err::err_wexpr(expr);
+            const std::string msg = "a heap comparator must return a `bool`, got `"+type_to_str(res->type())+"`";
+            throw InterpreterException(msg);
+        }
+        return dynamic_cast<Bool *>(res.get())->value();
+    }
+
+    int cmp;
+    if (!order(a.key.get(), b.key.get(), cmp)) {
+        Err::err_wexpr(expr);
+        const std::string msg = "cannot order a value of type `"+type_to_str(a.key->type())
+            +"` against a value of type `"+type_to_str(b.key->type())+"` in a heap";
+        throw InterpreterException(msg);
+    }
+    return cmp < 0;
+}
+
+void
+Heap::sift_up(size_t i, std::shared_ptr<Ctx> &ctx, Expr *expr) {
+    while (i > 0) {
+        size_t parent = (i-1)/2;
+        if (!before(m_entries[i], m_entries[parent], ctx, expr))
+            break;
+        std::swap(m_entries[i], m_entries[parent]);
+        i = parent;
+    }
+}
+
+void
+Heap::sift_down(size_t i, std::shared_ptr<Ctx> &ctx, Expr *expr) {
+    const size_t n = m_entries.size();
+    while (true) {
+        size_t first = i, l = 2*i+1, r = 2*i+2;
+        if (l < n && before(m_entries[l], m_entries[first], ctx, expr))
+            first = l;
+        if (r < n && before(m_entries[r], m_entries[first], ctx, expr))
+            first = r;
+        if (first == i)
+            break;
+        std::swap(m_entries[i], m_entries[first]);
+        i = first;
+    }
+}
+
+void
+Heap::push(std::shared_ptr<Obj> value, std::shared_ptr<Ctx> &ctx, Expr *expr) {
+    m_entries.push_back(make_entry(std::move(value), ctx, expr));
+    sift_up(m_entries.size()-1, ctx, expr);
+}
+
+void
+Heap::extend(const std::vector<std::shared_ptr<Obj>> &values, std::shared_ptr<Ctx> &ctx, Expr *expr) {
+    m_entries.reserve(m_entries.size() + values.size());
+    for (auto &value : values)
+        m_entries.push_back(make_entry(value, ctx, expr));
+    for (size_t i = m_entries.size()/2; i-- > 0;)
+        sift_down(i, ctx, expr);
+}
+
+std::shared_ptr<Obj>
+Heap::pop(std::shared_ptr<Ctx> &ctx, Expr *expr) {
+    if (m_entries.empty())
+        return std::make_shared<Option>();
+    auto value = std::move(m_entries.front().value);
+    m_entries.front() = std::move(m_entries.back());
+    m_entries.pop_back();
+    if (!m_entries.empty())
+        sift_down(0, ctx, expr);
+    return value;
+}
+
+std::shared_ptr<Obj>
+Heap::peek(void) {
+    if (m_entries.empty())
+        return std::make_shared<Option>();
+    return m_entries.front().value->copy();
+}
+
+/*** OVERRIDES ***/
+Type
+Heap::type(void) const {
+    return Type::Heap;
+}
+
+std::shared_ptr<Obj>
+Heap::binop(Token *op, std::shared_ptr<Obj> &other) {
+    (void)other;
+    Err::err_wtok(op);
+    std::string msg = "invalid binary operator for type `heap`";
+    throw InterpreterException(msg);
+}
+
+bool
+Heap::boolean(void) {
+    return !m_entries.empty();
+}
+
+void
+Heap::mutate(const std::shared_ptr<Obj> &other, StmtMut *stmt) {
+    ASSERT_MUTATE_COMPAT(this, other.get(), stmt);
+    ASSERT_CONSTNESS(this, stmt);
+
+    auto *heap = dynamic_cast<Heap *>(other.get());
+    m_entries = heap->m_entries;
+    m_f = heap->m_f;
+    m_comparator = heap->m_comparator;
+}
+
+std::shared_ptr<Obj>
+Heap::copy(void) {
+    auto heap = std::make_shared<Heap>(m_f);
+    heap->m_entries.reserve(m_entries.size());
+    for (auto &entry : m_entries) {
+        auto value = entry.value->copy();
+        heap->m_entries.push_back({entry.key == entry.value ? value : entry.key, value});
+    }
+    return heap;
+}
+
+bool
+Heap::eq(std::shared_ptr<Obj> &other) {
+    return this == other.get();
+}
+
+std::string
+Heap::to_cxxstring(void) {
+    std::string res = "<Heap [";
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        res += m_entries[i].value->to_cxxstring();
+        if (i != m_entries.size()-1)
+            res += ", ";
+    }
+    res += "]>";
+    return res;
+}
+
+void
+Heap::spec_mutate(Token *op, const std::shared_ptr<Obj> &other, StmtMut *stmt) {
+    (void)other;
+    (void)stmt;
+    Err::err_wtok(op);
+    std::string msg = "invalid operator for special mutation on type `heap`";
+    throw InterpreterException(msg);
+}
+
+std::shared_ptr<Obj>
+Heap::unaryop(Token *op) {
+    Err::err_wtok(op);
+    std::string msg = "invalid unary operator for type `heap`";
+    throw InterpreterException(msg);
+}
+
+void
+Heap::set_const(void) {
+    m_const = true;
+}
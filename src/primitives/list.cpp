@@ -25,25 +25,292 @@
 #include <iostream>
 #include <algorithm>
 #include <cassert>
+#include <climits>
 #include <memory>
+#include <numeric>
 
 #include "earl.hpp"
 #include "err.hpp"
+#include "list-reduce.hpp"
+#include "list-sort.hpp"
 #include "utils.hpp"
 
 using namespace earl::value;
 
+size_t
+List::Packed::size(void) const {
+    switch (type) {
+    case Type::Int:   return ints.size();
+    case Type::Float: return floats.size();
+    default:          return chars.size();
+    }
+}
+
 List::List(std::vector<std::shared_ptr<Obj>> value)
-    : m_value(value) {}
+    : m_value(std::make_shared<std::vector<std::shared_ptr<Obj>>>(std::move(value))) {}
+
+void
+List::materialize(void) {
+    if (!m_view)
+        return;
+
+    if (m_packed) {
+        auto own = std::make_shared<Packed>();
+        own->type = m_packed->type;
+        switch (own->type) {
+        case Type::Int:   own->ints.assign(m_packed->ints.begin()+m_off, m_packed->ints.begin()+m_off+m_len);       break;
+        case Type::Float: own->floats.assign(m_packed->floats.begin()+m_off, m_packed->floats.begin()+m_off+m_len); break;
+        default:          own->chars.assign(m_packed->chars.begin()+m_off, m_packed->chars.begin()+m_off+m_len);    break;
+        }
+        m_packed = std::move(own);
+    }
+    else {
+        // Same as `detach`, the elements are only copied if the
+        // list this was sliced from still refers to them.
+        bool shared = m_value.use_count() != 1;
+        auto own = std::make_shared<std::vector<std::shared_ptr<Obj>>>();
+        own->reserve(m_len);
+        for (size_t i = m_off; i < m_off+m_len; ++i)
+            own->push_back(shared ? (*m_value)[i]->copy() : (*m_value)[i]);
+        m_value = std::move(own);
+        if (shared) {
+            m_lent.clear();
+            m_lent_all = false;
+        }
+    }
+
+    m_view = false;
+    m_off = m_len = 0;
+}
+
+void
+List::detach(void) {
+    this->materialize();
+    if (m_packed) {
+        if (m_packed.use_count() != 1)
+            m_packed = std::make_shared<Packed>(*m_packed);
+        return;
+    }
+    if (m_value.use_count() == 1)
+        return;
+    auto own = std::make_shared<std::vector<std::shared_ptr<Obj>>>();
+    own->reserve(m_value->size());
+    for (auto &elem : *m_value)
+        own->push_back(elem->copy());
+    m_value = std::move(own);
+    m_lent.clear();
+    m_lent_all = false;
+}
+
+std::vector<std::shared_ptr<Obj>> &
+List::elems(void) {
+    this->unpack();
+    this->detach();
+    return *m_value;
+}
+
+void
+List::lend(const std::shared_ptr<Obj> &elem) {
+    if (m_lent.size() >= m_lent_cap) {
+        // Drop the ones that are no longer referred to from outside,
+        // so handing out elements stays amortized O(1).
+        (void)this->lent();
+        m_lent_cap = std::max<size_t>(16, m_lent.size()*2);
+    }
+    m_lent.emplace_back(elem);
+}
+
+bool
+List::lent(void) {
+    if (m_lent_all)
+        return true;
+    // An element only the list refers to cannot change behind it.
+    m_lent.erase(std::remove_if(m_lent.begin(), m_lent.end(),
+                                [](const std::weak_ptr<Obj> &elem) { return elem.use_count() <= 1; }),
+                 m_lent.end());
+    return !m_lent.empty();
+}
 
 void List::fill(std::vector<std::shared_ptr<Obj>> &value) {
     (void)value;
     UNIMPLEMENTED("List::fill");
 }
 
+void
+List::unpack(void) {
+    if (!m_packed)
+        return;
+    this->materialize();
+    auto elems = std::make_shared<std::vector<std::shared_ptr<Obj>>>();
+    elems->reserve(m_packed->size());
+    for (size_t i = 0; i < m_packed->size(); ++i)
+        elems->push_back(this->elem_value(i));
+    m_value = std::move(elems);
+    m_packed = nullptr;
+}
+
 std::vector<std::shared_ptr<Obj>> &
 List::value(void) {
-    return m_value;
+    auto &elems = this->elems();
+    m_lent_all = true;
+    return elems;
+}
+
+std::shared_ptr<Obj>
+List::elem_ref(size_t idx) {
+    auto &elem = this->elems()[idx];
+    this->lend(elem);
+    return elem;
+}
+
+size_t
+List::size(void) const {
+    if (m_view)
+        return m_len;
+    return m_packed ? m_packed->size() : m_value->size();
+}
+
+bool
+List::packed(void) const {
+    return m_packed != nullptr;
+}
+
+bool
+List::scalar_at(int idx, Scalar &out) const {
+    if (idx < 0 || static_cast<size_t>(idx) >= this->size())
+        return false;
+    idx += m_off;
+    if (!m_packed) {
+        out = Scalar::unbox((*m_value)[idx].get());
+        return out.tag != Scalar::Tag::None;
+    }
+    switch (m_packed->type) {
+    case Type::Int:   out = Scalar::of_int(m_packed->ints[idx]);     break;
+    case Type::Float: out = Scalar::of_float(m_packed->floats[idx]); break;
+    default:          out = Scalar::of_char(m_packed->chars[idx]);   break;
+    }
+    return true;
+}
+
+std::shared_ptr<Obj>
+List::elem_value(size_t idx) const {
+    idx += m_off;
+    if (!m_packed)
+        return (*m_value)[idx];
+    switch (m_packed->type) {
+    case Type::Int:   return std::make_shared<Int>(m_packed->ints[idx]);
+    case Type::Float: return std::make_shared<Float>(m_packed->floats[idx]);
+    default:          return std::make_shared<Char>(m_packed->chars[idx]);
+    }
+}
+
+std::shared_ptr<Obj>
+List::nth_value(std::shared_ptr<Obj> &idx, Expr *expr) {
+    // Reading does not need the list's own elements, so it hands
+    // out the shared ones.
+    if (idx->type() != Type::Int)
+        return this->nth(idx, expr);
+    int I = dynamic_cast<Int *>(idx.get())->value();
+    if (I < 0 || static_cast<size_t>(I) >= this->size()) {
+        Err::err_wexpr(expr);
+        std::string msg = "index "+std::to_string(I)+" is out of range of length "+std::to_string(this->size());
+        throw InterpreterException(msg);
+    }
+    return this->elem_value(I);
+}
+
+bool
+List::packed_append(const Scalar &value) {
+    this->materialize();
+    Type ty;
+    switch (value.tag) {
+    case Scalar::Tag::Int:   ty = Type::Int;   break;
+    case Scalar::Tag::Float: ty = Type::Float; break;
+    case Scalar::Tag::Char:  ty = Type::Char;  break;
+    default: return false;
+    }
+
+    if (!m_packed) {
+        if (!m_value->empty())
+            return false;
+        m_packed = std::make_shared<Packed>();
+        m_packed->type = ty;
+        m_value = nullptr;
+    }
+    else if (m_packed->type != ty)
+        return false;
+    else
+        this->detach();
+
+    switch (ty) {
+    case Type::Int:   m_packed->ints.push_back(value.i);   break;
+    case Type::Float: m_packed->floats.push_back(value.f); break;
+    default:          m_packed->chars.push_back(value.c);  break;
+    }
+    return true;
+}
+
+void
+List::append_scalar(const Scalar &value) {
+    if (!this->packed_append(value))
+        this->elems().push_back(value.box());
+}
+
+void
+List::extend(List &other) {
+    this->materialize();
+    other.materialize();
+    if (&other == this) {
+        List self;
+        self.m_value = m_value;
+        self.m_packed = m_packed;
+        this->extend(self);
+        return;
+    }
+
+    if (other.m_packed) {
+        if (!m_packed && m_value->empty()) {
+            m_packed = other.m_packed;
+            m_value = nullptr;
+            return;
+        }
+        if (m_packed && m_packed->type == other.m_packed->type) {
+            this->detach();
+            auto &src = *other.m_packed;
+            m_packed->ints.insert(m_packed->ints.end(), src.ints.begin(), src.ints.end());
+            m_packed->floats.insert(m_packed->floats.end(), src.floats.begin(), src.floats.end());
+            m_packed->chars.insert(m_packed->chars.end(), src.chars.begin(), src.chars.end());
+            return;
+        }
+    }
+
+    // Each list keeps its own elements, so changing one of them
+    // through `other` does not show up here.
+    for (size_t i = 0; i < other.size(); ++i)
+        this->append_copy(other.elem_value(i));
+}
+
+size_t
+List::packed_index_of(Obj *value) const {
+    const size_t n = this->size();
+    if (value->type() == Type::Void)
+        return n > 0 ? 0 : ListReduce::npos;
+    // An int finds an equal float and the other way around, like `==`.
+    if (m_packed->type == Type::Int && value->type() == Type::Float) {
+        double f = dynamic_cast<Float *>(value)->value();
+        if (f < INT_MIN || f > INT_MAX || static_cast<int>(f) != f)
+            return ListReduce::npos;
+        return ListReduce::index_of(m_packed->ints.data()+m_off, n, static_cast<int>(f));
+    }
+    if (m_packed->type == Type::Float && value->type() == Type::Int)
+        return ListReduce::index_of(m_packed->floats.data()+m_off, n, static_cast<double>(dynamic_cast<Int *>(value)->value()));
+    if (value->type() != m_packed->type)
+        return ListReduce::npos;
+    switch (m_packed->type) {
+    case Type::Int:   return ListReduce::index_of(m_packed->ints.data()+m_off, n, dynamic_cast<Int *>(value)->value());
+    case Type::Float: return ListReduce::index_of(m_packed->floats.data()+m_off, n, dynamic_cast<Float *>(value)->value());
+    default:          return ListReduce::index_of(m_packed->chars.data()+m_off, n, dynamic_cast<Char *>(value)->value());
+    }
 }
 
 Type
@@ -51,7 +318,7 @@ List::type(void) const {
     return Type::List;
 }
 
-std::vector<std::shared_ptr<Obj>>
+std::shared_ptr<List>
 List::slice(std::shared_ptr<Obj> &start, std::shared_ptr<Obj> &end, Expr *expr) {
     if (start->type() != Type::Void && start->type() != Type::Int) {
         Err::err_wexpr(expr);
@@ -64,33 +331,26 @@ List::slice(std::shared_ptr<Obj> &start, std::shared_ptr<Obj> &end, Expr *expr)
         throw InterpreterException(msg);
     }
 
-    std::vector<std::shared_ptr<Obj>> v = {};
-    if (start->type() == Type::Void && end->type() == Type::Void) {
-        std::for_each(m_value.begin(), m_value.end(), [&](auto &k) {v.push_back(k);});
-        return v;
-    }
-    int s, e;
+    const int n = static_cast<int>(this->size());
+    int s = start->type() == Type::Void ? 0 : dynamic_cast<Int *>(start.get())->value();
+    int e = end->type() == Type::Void ? n : dynamic_cast<Int *>(end.get())->value();
 
-    if (start->type() == Type::Void)
-        s = 0;
-    else
-        s = dynamic_cast<Int *>(start.get())->value();
-
-    if (end->type() == Type::Void)
-        e = m_value.size();
-    else
-        e = dynamic_cast<Int *>(end.get())->value();
-
-    for (; s < e; ++s) {
-        if (s >= m_value.size()) {
-            Err::err_wexpr(expr);
-            std::string msg = "index "+std::to_string(s)+" is out of range for list of length "+std::to_string(m_value.size());
-            throw InterpreterException(msg);
-        }
-        v.push_back(m_value.at(s));
+    if (s < e && (s < 0 || s >= n || e > n)) {
+        Err::err_wexpr(expr);
+        int bad = s < 0 || s >= n ? s : n;
+        std::string msg = "index "+std::to_string(bad)+" is out of range for list of length "+std::to_string(n);
+        throw InterpreterException(msg);
     }
 
-    return v;
+    auto lst = std::make_shared<List>();
+    lst->m_value = m_value;
+    lst->m_packed = m_packed;
+    lst->m_view = true;
+    lst->m_off = m_off + (s < e ? s : 0);
+    lst->m_len = s < e ? e-s : 0;
+    lst->m_lent = m_lent;
+    lst->m_lent_all = m_lent_all;
+    return lst;
 }
 
 std::shared_ptr<Obj>
@@ -98,17 +358,17 @@ List::nth(std::shared_ptr<Obj> &idx, Expr *expr) {
     switch (idx->type()) {
     case Type::Int: {
         auto index = dynamic_cast<Int *>(idx.get());
-        if (index->value() < 0 || static_cast<size_t>(index->value()) >= this->value().size()) {
+        if (index->value() < 0 || static_cast<size_t>(index->value()) >= this->size()) {
             Err::err_wexpr(expr);
-            std::string msg = "index "+std::to_string(index->value())+" is out of range of length "+std::to_string(this->value().size());
+            std::string msg = "index "+std::to_string(index->value())+" is out of range of length "+std::to_string(this->size());
             throw InterpreterException(msg);
         }
-        return this->value().at(index->value());
+        return this->elem_ref(index->value());
     } break;
     case Type::Slice: {
         auto slice = dynamic_cast<Slice *>(idx.get());
         std::shared_ptr<Obj> &s = slice->start(), &e = slice->end();
-        return std::make_shared<List>(this->slice(s, e, expr));
+        return this->slice(s, e, expr);
     } break;
     default: {
         Err::err_wexpr(expr);
@@ -121,16 +381,29 @@ List::nth(std::shared_ptr<Obj> &idx, Expr *expr) {
 
 std::shared_ptr<List>
 List::rev(void) {
+    this->materialize();
+    if (m_packed) {
+        auto lst = std::make_shared<List>();
+        lst->m_value = nullptr;
+        lst->m_packed = std::make_shared<Packed>(*m_packed);
+        std::reverse(lst->m_packed->ints.begin(), lst->m_packed->ints.end());
+        std::reverse(lst->m_packed->floats.begin(), lst->m_packed->floats.end());
+        std::reverse(lst->m_packed->chars.begin(), lst->m_packed->chars.end());
+        return lst;
+    }
+
     auto lst = std::make_shared<List>();
-    for (int i = m_value.size()-1; i >= 0; --i)
-        lst->append(m_value[i]);
+    for (size_t i = this->size(); i-- > 0;)
+        lst->append_copy(this->elem_value(i));
     return lst;
 }
 
 std::shared_ptr<Bool>
 List::contains(std::shared_ptr<earl::value::Obj> &value) {
-    for (size_t i = 0; i < m_value.size(); ++i)
-        if (m_value.at(i)->eq(value))
+    if (m_packed)
+        return std::make_shared<Bool>(this->packed_index_of(value.get()) != ListReduce::npos);
+    for (size_t i = 0; i < this->size(); ++i)
+        if (this->elem_value(i)->eq(value))
             return std::make_shared<Bool>(true);
     return std::make_shared<Bool>(false);
 }
@@ -138,31 +411,42 @@ List::contains(std::shared_ptr<earl::value::Obj> &value) {
 void
 List::pop(std::shared_ptr<Obj> &idx) {
     auto *idx1 = dynamic_cast<earl::value::Int *>(idx.get());
-    m_value.erase(m_value.begin() + idx1->value());
+    if (m_packed) {
+        this->detach();
+        int I = idx1->value();
+        switch (m_packed->type) {
+        case Type::Int:   m_packed->ints.erase(m_packed->ints.begin() + I);     break;
+        case Type::Float: m_packed->floats.erase(m_packed->floats.begin() + I); break;
+        default:          m_packed->chars.erase(m_packed->chars.begin() + I);   break;
+        }
+        return;
+    }
+    auto &elems = this->elems();
+    elems.erase(elems.begin() + idx1->value());
 }
 
 void
 List::append(std::vector<std::shared_ptr<Obj>> &values) {
-    for (size_t i = 0; i < values.size(); ++i) {
-        m_value.push_back(values.at(i));
-    }
+    for (size_t i = 0; i < values.size(); ++i)
+        this->append(values.at(i));
 }
 
 void
 List::append(std::shared_ptr<Obj> value) {
-    m_value.push_back(value);
+    if (!this->packed_append(Scalar::unbox(value.get())))
+        this->elems().push_back(value);
 }
 
 void
 List::append_copy(std::vector<std::shared_ptr<Obj>> &values) {
-    for (size_t i = 0; i < values.size(); ++i) {
-        m_value.push_back(values.at(i)->copy());
-    }
+    for (size_t i = 0; i < values.size(); ++i)
+        this->append_copy(values.at(i));
 }
 
 void
 List::append_copy(std::shared_ptr<Obj> value) {
-    m_value.push_back(value->copy());
+    if (!this->packed_append(Scalar::unbox(value.get())))
+        this->elems().push_back(value->copy());
 }
 
 std::shared_ptr<List>
@@ -172,12 +456,14 @@ List::filter(std::shared_ptr<Obj> &closure, std::shared_ptr<Ctx> &ctx) {
     auto copy = std::make_shared<List>();
     std::vector<std::shared_ptr<Obj>> keep_values={};
 
-    for (size_t i = 0; i < m_value.size(); ++i) {
-        std::vector<std::shared_ptr<Obj>> values = {m_value.at(i)};
+    // The closure may change the list, so the elements are
+    // looked up again on every iteration.
+    for (size_t i = 0; i < this->size(); ++i) {
+        std::vector<std::shared_ptr<Obj>> values = {this->elem_ref(i)};
         std::shared_ptr<Obj> filter_result = cl->call(values, ctx);
         assert(filter_result->type() == Type::Bool);
         if (dynamic_cast<Bool *>(filter_result.get())->boolean())
-            keep_values.push_back(m_value.at(i)->copy());
+            keep_values.push_back(this->elem_value(i)->copy());
     }
 
     copy->append(keep_values);
@@ -188,8 +474,8 @@ List::filter(std::shared_ptr<Obj> &closure, std::shared_ptr<Ctx> &ctx) {
 void
 List::foreach(std::shared_ptr<Obj> &closure, std::shared_ptr<Ctx> &ctx) {
     Closure *cl = dynamic_cast<Closure *>(closure.get());
-    for (size_t i = 0; i < m_value.size(); ++i) {
-        std::vector<std::shared_ptr<Obj>> values = {m_value[i]};
+    for (size_t i = 0; i < this->size(); ++i) {
+        std::vector<std::shared_ptr<Obj>> values = {this->elem_ref(i)};
         cl->call(values, ctx);
     }
 }
@@ -197,8 +483,8 @@ List::foreach(std::shared_ptr<Obj> &closure, std::shared_ptr<Ctx> &ctx) {
 std::shared_ptr<List>
 List::map(std::shared_ptr<Closure> &closure, std::shared_ptr<Ctx> &ctx) {
     auto mapped = std::make_shared<List>();
-    for (size_t i = 0; i < m_value.size(); ++i) {
-        std::vector<std::shared_ptr<Obj>> params = {m_value.at(i)};
+    for (size_t i = 0; i < this->size(); ++i) {
+        std::vector<std::shared_ptr<Obj>> params = {this->elem_ref(i)};
         auto value = closure->call(params, ctx);
         mapped->append(value);
     }
@@ -207,9 +493,242 @@ List::map(std::shared_ptr<Closure> &closure, std::shared_ptr<Ctx> &ctx) {
 
 std::shared_ptr<Obj>
 List::back(void) {
-    if (m_value.size() == 0)
+    if (this->size() == 0)
+        return std::make_shared<Option>();
+    if (m_packed)
+        return this->elem_value(this->size()-1);
+    return this->elem_value(this->size()-1)->copy();
+}
+
+std::shared_ptr<Obj>
+List::sum(Expr *expr) {
+    if (m_packed && m_packed->type == Type::Int)
+        return std::make_shared<Int>(ListReduce::sum(m_packed->ints.data()+m_off, this->size()));
+    if (m_packed && m_packed->type == Type::Float)
+        return std::make_shared<Float>(ListReduce::sum(m_packed->floats.data()+m_off, this->size()));
+
+    Scalar acc = Scalar::of_int(0);
+    for (size_t i = 0; i < this->size(); ++i) {
+        Scalar x;
+        if (!this->scalar_at(i, x) || (x.tag != Scalar::Tag::Int && x.tag != Scalar::Tag::Float)) {
+            Err::err_wexpr(expr);
+            const std::string msg = "cannot use member intrinsic `sum` on a list with elements other than of type int or float";
+            throw InterpreterException(msg);
+        }
+        scalar_binop(TokenType::Plus, acc, x, acc);
+    }
+    return acc.box();
+}
+
+// Shared by `List::min` and `List::max`, `op` is the
+// comparison for which an element replaces the current one.
+static std::shared_ptr<Obj>
+extreme(List *list, TokenType op, const std::string &name, Expr *expr) {
+    if (list->size() == 0)
         return std::make_shared<Option>();
-    return m_value.back()->copy();
+
+    Scalar m;
+    for (size_t i = 0; i < list->size(); ++i) {
+        Scalar x, replace;
+        if (!list->scalar_at(i, x) || (x.tag != Scalar::Tag::Int && x.tag != Scalar::Tag::Float)) {
+            Err::err_wexpr(expr);
+            const std::string msg = "cannot use member intrinsic `"+name+"` on a list with elements other than of type int or float";
+            throw InterpreterException(msg);
+        }
+        if (i == 0 || (scalar_binop(op, x, m, replace) && replace.b))
+            m = x;
+    }
+    return m.box();
+}
+
+std::shared_ptr<Obj>
+List::min(Expr *expr) {
+    if (m_packed && m_packed->type == Type::Int && this->size() > 0)
+        return std::make_shared<Int>(ListReduce::min(m_packed->ints.data()+m_off, this->size()));
+    if (m_packed && m_packed->type == Type::Float && this->size() > 0)
+        return std::make_shared<Float>(ListReduce::min(m_packed->floats.data()+m_off, this->size()));
+    return extreme(this, TokenType::Lessthan, "min", expr);
+}
+
+std::shared_ptr<Obj>
+List::max(Expr *expr) {
+    if (m_packed && m_packed->type == Type::Int && this->size() > 0)
+        return std::make_shared<Int>(ListReduce::max(m_packed->ints.data()+m_off, this->size()));
+    if (m_packed && m_packed->type == Type::Float && this->size() > 0)
+        return std::make_shared<Float>(ListReduce::max(m_packed->floats.data()+m_off, this->size()));
+    return extreme(this, TokenType::Greaterthan, "max", expr);
+}
+
+// `binop` only looks at the type of the operator. Its position is
+// for errors, which the compatibility check below rules out.
+static Token eq_tok("==", TokenType::Double_Equals, 0, 0, 0);
+
+// Whether `elem == value` in EARL, i.e., 2 finds 2.0 and nested
+// lists compare their elements the same way.
+static bool
+elem_equals(std::shared_ptr<Obj> elem, std::shared_ptr<Obj> &value) {
+    Scalar x = Scalar::unbox(elem.get()), y = Scalar::unbox(value.get()), res;
+    if (x.tag != Scalar::Tag::None && y.tag != Scalar::Tag::None && scalar_binop(TokenType::Double_Equals, x, y, res))
+        return res.b;
+    if (!type_is_compatable(elem.get(), value.get()))
+        return false;
+    return elem->binop(&eq_tok, value)->boolean();
+}
+
+std::shared_ptr<Obj>
+List::index_of(std::shared_ptr<Obj> &value) {
+    size_t idx = ListReduce::npos;
+    if (m_packed)
+        idx = this->packed_index_of(value.get());
+    else {
+        for (size_t i = 0; i < this->size(); ++i) {
+            if (elem_equals(this->elem_value(i), value)) {
+                idx = i;
+                break;
+            }
+        }
+    }
+    if (idx == ListReduce::npos)
+        return std::make_shared<Option>();
+    return std::make_shared<Option>(std::make_shared<Int>(static_cast<int>(idx)));
+}
+
+// Get the stable sorted order of `keys`. Keys that are all ints, all
+// numbers or all strs are compared unboxed.
+static std::vector<size_t>
+sorted_order(const std::vector<std::shared_ptr<Obj>> &keys, Expr *expr) {
+    std::vector<size_t> idx(keys.size());
+    std::iota(idx.begin(), idx.end(), 0);
+    if (keys.empty())
+        return idx;
+
+    bool ints = true, nums = true, strs = true;
+    for (auto &key : keys) {
+        Type ty = key->type();
+        ints = ints && ty == Type::Int;
+        nums = nums && (ty == Type::Int || ty == Type::Float);
+        strs = strs && ty == Type::Str;
+    }
+
+    if (ints) {
+        std::vector<int> ks(keys.size());
+        for (size_t i = 0; i < keys.size(); ++i)
+            ks[i] = dynamic_cast<Int *>(keys[i].get())->value();
+        ListSort::sort_indices(idx, ks);
+    }
+    else if (nums) {
+        std::vector<double> ks(keys.size());
+        for (size_t i = 0; i < keys.size(); ++i)
+            ks[i] = keys[i]->type() == Type::Int
+                ? dynamic_cast<Int *>(keys[i].get())->value()
+                : dynamic_cast<Float *>(keys[i].get())->value();
+        ListSort::sort_indices(idx, ks);
+    }
+    else if (strs) {
+        std::vector<std::string_view> ks(keys.size());
+        for (size_t i = 0; i < keys.size(); ++i)
+            ks[i] = dynamic_cast<Str *>(keys[i].get())->view();
+        ListSort::sort_indices(idx, ks);
+    }
+    else {
+        ListSort::merge_sort(idx, [&](size_t a, size_t b) {
+            int cmp;
+            if (!order(keys[a].get(), keys[b].get(), cmp)) {
+                Err::err_wexpr(expr);
+                const std::string msg = "cannot sort a value of type `"+type_to_str(keys[a]->type())
+                    +"` against a value of type `"+type_to_str(keys[b]->type())+"`";
+                throw InterpreterException(msg);
+            }
+            return cmp < 0;
+        });
+    }
+    return idx;
+}
+
+template <typename T> static void
+permute(std::vector<T> &xs, const std::vector<size_t> &idx) {
+    std::vector<T> out;
+    out.reserve(idx.size());
+    for (size_t i : idx)
+        out.push_back(xs[i]);
+    xs.swap(out);
+}
+
+void
+List::sort(Expr *expr) {
+    if (m_packed) {
+        this->detach();
+        switch (m_packed->type) {
+        case Type::Int:   ListSort::sort(m_packed->ints.data(), m_packed->ints.size());     break;
+        case Type::Float: ListSort::sort(m_packed->floats.data(), m_packed->floats.size()); break;
+        default:          ListSort::sort(m_packed->chars.data(), m_packed->chars.size());   break;
+        }
+        return;
+    }
+
+    auto &elems = this->elems();
+    permute(elems, sorted_order(elems, expr));
+}
+
+void
+List::sort_by(std::shared_ptr<Obj> &closure, std::shared_ptr<Ctx> &ctx, Expr *expr) {
+    Closure *cl = dynamic_cast<Closure *>(closure.get());
+    this->materialize();
+
+    // The closure may change the list, so the elements are taken
+    // up front and the sorted snapshot replaces the list at the end.
+    std::shared_ptr<Packed> packed = m_packed;
+    std::vector<std::shared_ptr<Obj>> elems = {};
+    if (packed) {
+        elems.reserve(packed->size());
+        for (size_t i = 0; i < packed->size(); ++i)
+            elems.push_back(this->elem_value(i));
+    }
+    else
+        elems = this->elems();
+
+    std::vector<size_t> idx;
+    if (cl->params_len() == 1) {
+        std::vector<std::shared_ptr<Obj>> keys = {};
+        keys.reserve(elems.size());
+        for (auto &elem : elems) {
+            std::vector<std::shared_ptr<Obj>> values = {elem};
+            keys.push_back(cl->call(values, ctx));
+        }
+        idx = sorted_order(keys, expr);
+    }
+    else {
+        idx.resize(elems.size());
+        std::iota(idx.begin(), idx.end(), 0);
+        ListSort::merge_sort(idx, [&](size_t a, size_t b) {
+            std::vector<std::shared_ptr<Obj>> values = {elems[a], elems[b]};
+            auto res = cl->call(values, ctx);
+            if (res->type() != Type::Bool) {
+                Err::err_wexpr(expr);
+                const std::string msg = "a sort comparator must return a `bool`, got `"+type_to_str(res->type())+"`";
+                throw InterpreterException(msg);
+            }
+            return dynamic_cast<Bool *>(res.get())->value();
+        });
+    }
+
+    if (packed) {
+        auto sorted = std::make_shared<Packed>(*packed);
+        switch (sorted->type) {
+        case Type::Int:   permute(sorted->ints, idx);   break;
+        case Type::Float: permute(sorted->floats, idx); break;
+        default:          permute(sorted->chars, idx);  break;
+        }
+        m_packed = std::move(sorted);
+        m_value = nullptr;
+    }
+    else {
+        permute(elems, idx);
+        m_packed = nullptr;
+        m_value = std::make_shared<std::vector<std::shared_ptr<Obj>>>(std::move(elems));
+    }
+    m_view = false;
+    m_off = m_len = 0;
 }
 
 std::shared_ptr<Obj>
@@ -220,65 +739,32 @@ List::binop(Token *op, std::shared_ptr<Obj> &other) {
 
     switch (op->type()) {
     case TokenType::Plus: {
-        auto list = std::make_shared<List>(this->value());
-        list->value().insert(list->value().end(),
-                             other_casted->value().begin(),
-                             other_casted->value().end());
+        auto list = std::make_shared<List>();
+        list->extend(*this);
+        list->extend(*other_casted);
         return list;
     } break;
     case TokenType::Double_Equals: {
         int res = 0;
-        if (m_value.size() == other_casted->value().size()) {
+        this->materialize();
+        other_casted->materialize();
+        if (m_packed && other_casted->m_packed && m_packed->type == other_casted->m_packed->type) {
+            res = m_packed->ints == other_casted->m_packed->ints
+                && m_packed->floats == other_casted->m_packed->floats
+                && m_packed->chars == other_casted->m_packed->chars;
+        }
+        else if (this->size() == other_casted->size()) {
             res = 1;
-            for (size_t i = 0; i < m_value.size(); ++i) {
-                auto o1 = this->value()[i];
-                auto o2 = other_casted->value()[i];
-                if (!type_is_compatable(o1.get(), o2.get())) {
+            for (size_t i = 0; i < this->size(); ++i) {
+                auto o1 = this->elem_value(i);
+                auto o2 = other_casted->elem_value(i);
+                // Elements decide equality through their own `==`, so
+                // ints compare with floats and nested lists and tuples
+                // recurse.
+                if (!type_is_compatable(o1.get(), o2.get()) || !o1->binop(op, o2)->boolean()) {
                     res = 0;
                     break;
                 }
-                if (o1->type() == Type::Int) {
-                    if (dynamic_cast<Int *>(o1.get())->value() != dynamic_cast<Int *>(o2.get())->value()) {
-                        res = 0;
-                        break;
-                    }
-                }
-                else if (o1->type() == Type::Str) {
-                    if (dynamic_cast<Str *>(o1.get())->value() != dynamic_cast<Str *>(o2.get())->value()) {
-                        res = 0;
-                        break;
-                    }
-                }
-                else if (o1->type() == Type::Char) {
-                    if (dynamic_cast<Char *>(o1.get())->value() != dynamic_cast<Char *>(o2.get())->value()) {
-                        res = 0;
-                        break;
-                    }
-                }
-                else if (o1->type() == Type::Bool) {
-                    if (dynamic_cast<Bool *>(o1.get())->value() != dynamic_cast<Bool *>(o2.get())->value()) {
-                        res = 0;
-                        break;
-                    }
-                }
-                else if (o1->type() == Type::Option) {
-                    auto option1 = dynamic_cast<Option *>(o1.get());
-                    auto option2 = dynamic_cast<Option *>(o1.get());
-                    if ((!option1 && option2) || (option1 && !option2)) {
-                        res = 0;
-                        break;
-                    }
-                    if ((option1 && option2) && (option1->value() != option2->value())) {
-                        res = 0;
-                        break;
-                    }
-                }
-                else {
-                    assert(false && "unreachable");
-
-                    // res = 0;
-                    // break;
-                }
             }
         }
         return std::make_shared<Int>(res);
@@ -295,7 +781,7 @@ List::binop(Token *op, std::shared_ptr<Obj> &other) {
 
 bool
 List::boolean(void) {
-    return m_value.size() > 0;
+    return this->size() > 0;
 }
 
 void
@@ -303,14 +789,36 @@ List::mutate(const std::shared_ptr<Obj> &other, StmtMut *stmt) {
     ASSERT_MUTATE_COMPAT(this, other.get(), stmt);
     ASSERT_CONSTNESS(this, stmt);
 
+    // Shared the same way as `copy`.
     auto *lst = dynamic_cast<List *>(other.get());
-    m_value = lst->value();
+    m_value = lst->m_value;
+    m_packed = lst->m_packed;
+    m_view = lst->m_view;
+    m_off = lst->m_off;
+    m_len = lst->m_len;
+    m_lent = lst->m_lent;
+    m_lent_all = lst->m_lent_all;
 }
 
 std::shared_ptr<Obj>
 List::copy(void) {
     auto list = std::make_shared<List>();
-    list->append_copy(this->value());
+
+    // An element that nothing outside of the list refers to can only
+    // change through the list or one of its copies, and those get their
+    // own elements first. So the elements are shared unless one that
+    // was handed out is still held.
+    if (m_packed || !this->lent()) {
+        list->m_value = m_value;
+        list->m_packed = m_packed;
+        list->m_view = m_view;
+        list->m_off = m_off;
+        list->m_len = m_len;
+        return list;
+    }
+
+    for (size_t i = 0; i < this->size(); ++i)
+        list->append_copy(this->elem_value(i));
     return list;
 }
 
@@ -321,12 +829,14 @@ List::eq(std::shared_ptr<Obj> &other) {
 
     auto *lst = dynamic_cast<List *>(other.get());
 
-    if (lst->value().size() != this->value().size())
+    if (lst->size() != this->size())
         return false;
 
-    for (size_t i = 0; i < lst->value().size(); ++i)
-        if (!this->value()[i]->eq(lst->value()[i]))
+    for (size_t i = 0; i < lst->size(); ++i) {
+        auto elem = lst->elem_value(i);
+        if (!this->elem_value(i)->eq(elem))
             return false;
+    }
 
     return true;
 }
@@ -334,9 +844,16 @@ List::eq(std::shared_ptr<Obj> &other) {
 std::string
 List::to_cxxstring(void) {
     std::string res = "[";
-    for (size_t i = 0; i < m_value.size(); ++i) {
-        res += m_value.at(i)->to_cxxstring();
-        if (i != m_value.size()-1)
+    for (size_t i = 0; i < this->size(); ++i) {
+        if (!m_packed)
+            res += (*m_value)[m_off+i]->to_cxxstring();
+        else if (m_packed->type == Type::Int)
+            res += std::to_string(m_packed->ints[m_off+i]);
+        else if (m_packed->type == Type::Float)
+            res += std::to_string(m_packed->floats[m_off+i]);
+        else
+            res += m_packed->chars[m_off+i];
+        if (i != this->size()-1)
             res += ", ";
     }
     res += "]";
@@ -350,8 +867,7 @@ List::spec_mutate(Token *op, const std::shared_ptr<Obj> &other, StmtMut *stmt) {
 
     switch (op->type()) {
     case TokenType::Plus_Equals: {
-        auto otherlst = dynamic_cast<const List *>(other.get());
-        m_value.insert(m_value.end(), otherlst->m_value.begin(), otherlst->m_value.end());
+        this->extend(*dynamic_cast<List *>(other.get()));
     } break;
     default: {
         Err::err_wtok(op);
@@ -0,0 +1,323 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cmath>
+#include <memory>
+
+#include "earl.hpp"
+
+using namespace earl::value;
+
+Scalar
+Scalar::of_int(int value) {
+    Scalar s;
+    s.tag = Tag::Int;
+    s.i = value;
+    return s;
+}
+
+Scalar
+Scalar::of_float(double value) {
+    Scalar s;
+    s.tag = Tag::Float;
+    s.f = value;
+    return s;
+}
+
+Scalar
+Scalar::of_bool(bool value) {
+    Scalar s;
+    s.tag = Tag::Bool;
+    s.b = value;
+    return s;
+}
+
+Scalar
+Scalar::of_char(char value) {
+    Scalar s;
+    s.tag = Tag::Char;
+    s.c = value;
+    return s;
+}
+
+Scalar
+Scalar::unbox(Obj *value) {
+    switch (value->type()) {
+    case Type::Int:   return of_int(static_cast<Int *>(value)->value());
+    case Type::Float: return of_float(static_cast<Float *>(value)->value());
+    case Type::Bool:  return of_bool(static_cast<Bool *>(value)->value());
+    case Type::Char:  return of_char(static_cast<Char *>(value)->value());
+    default:          return Scalar();
+    }
+}
+
+std::shared_ptr<Obj>
+Scalar::box(void) const {
+    switch (tag) {
+    case Tag::Int:   return std::make_shared<Int>(i);
+    case Tag::Float: return std::make_shared<Float>(f);
+    case Tag::Bool:  return std::make_shared<Bool>(b);
+    case Tag::Char:  return std::make_shared<Char>(c);
+    default:         return nullptr;
+    }
+}
+
+void
+Scalar::store(std::shared_ptr<Obj> &dst) const {
+    if (!dst || dst.use_count() != 1 || dst->is_const()) {
+        dst = box();
+        return;
+    }
+    switch (tag) {
+    case Tag::Int: {
+        if (dst->type() != Type::Int) break;
+        static_cast<Int *>(dst.get())->fill(i);
+        return;
+    }
+    case Tag::Float: {
+        if (dst->type() != Type::Float) break;
+        static_cast<Float *>(dst.get())->fill(f);
+        return;
+    }
+    case Tag::Bool: {
+        if (dst->type() != Type::Bool) break;
+        static_cast<Bool *>(dst.get())->fill(b);
+        return;
+    }
+    case Tag::Char: {
+        if (dst->type() != Type::Char) break;
+        static_cast<Char *>(dst.get())->fill(c);
+        return;
+    }
+    default: break;
+    }
+    dst = box();
+}
+
+bool
+Scalar::truthy(bool &out) const {
+    switch (tag) {
+    case Tag::Int:   out = i;  return true;
+    case Tag::Float: out = f;  return true;
+    case Tag::Bool:  out = b;  return true;
+    default:         return false;
+    }
+}
+
+// Int and Float share the arithmetic and comparison operators,
+// the result type follows the same promotion rules as Int::binop
+// and Float::binop.
+static bool
+numeric_binop(TokenType op, const Scalar &lhs, const Scalar &rhs, Scalar &out) {
+    using Tag = Scalar::Tag;
+
+    if (rhs.tag != Tag::Int && rhs.tag != Tag::Float)
+        return false;
+
+    bool ints = lhs.tag == Tag::Int && rhs.tag == Tag::Int;
+    double x = lhs.tag == Tag::Int ? lhs.i : lhs.f;
+    double y = rhs.tag == Tag::Int ? rhs.i : rhs.f;
+
+    switch (op) {
+    case TokenType::Plus:     out = ints ? Scalar::of_int(lhs.i + rhs.i) : Scalar::of_float(x + y); break;
+    case TokenType::Minus:    out = ints ? Scalar::of_int(lhs.i - rhs.i) : Scalar::of_float(x - y); break;
+    case TokenType::Asterisk: out = ints ? Scalar::of_int(lhs.i * rhs.i) : Scalar::of_float(x * y); break;
+    case TokenType::Forwardslash: {
+        if (ints && rhs.i == 0)
+            return false;
+        out = ints ? Scalar::of_int(lhs.i / rhs.i) : Scalar::of_float(x / y);
+    } break;
+    case TokenType::Percent: {
+        if (!ints || rhs.i == 0)
+            return false;
+        out = Scalar::of_int(lhs.i % rhs.i);
+    } break;
+    case TokenType::Double_Asterisk: {
+        float p = std::pow(static_cast<float>(x), static_cast<float>(y));
+        out = ints ? Scalar::of_int(static_cast<int>(p)) : Scalar::of_float(static_cast<double>(p));
+    } break;
+    case TokenType::Lessthan:           out = Scalar::of_bool(x < y);  break;
+    case TokenType::Greaterthan:        out = Scalar::of_bool(x > y);  break;
+    case TokenType::Double_Equals:      out = Scalar::of_bool(x == y); break;
+    case TokenType::Greaterthan_Equals: out = Scalar::of_bool(x >= y); break;
+    case TokenType::Lessthan_Equals:    out = Scalar::of_bool(x <= y); break;
+    case TokenType::Bang_Equals:        out = Scalar::of_bool(x != y); break;
+    case TokenType::Double_Lessthan: {
+        if (!ints) return false;
+        out = Scalar::of_int(lhs.i << rhs.i);
+    } break;
+    case TokenType::Double_Greaterthan: {
+        if (!ints) return false;
+        out = Scalar::of_int(lhs.i >> rhs.i);
+    } break;
+    case TokenType::Backtick_Pipe: {
+        if (!ints) return false;
+        out = Scalar::of_int(lhs.i | rhs.i);
+    } break;
+    case TokenType::Backtick_Caret: {
+        if (!ints) return false;
+        out = Scalar::of_int(lhs.i ^ rhs.i);
+    } break;
+    case TokenType::Backtick_Ampersand: {
+        if (!ints) return false;
+        out = Scalar::of_int(lhs.i & rhs.i);
+    } break;
+    default: return false;
+    }
+    return true;
+}
+
+bool
+earl::value::scalar_binop(TokenType op, const Scalar &lhs, const Scalar &rhs, Scalar &out) {
+    using Tag = Scalar::Tag;
+
+    switch (lhs.tag) {
+    case Tag::Int:
+    case Tag::Float:
+        return numeric_binop(op, lhs, rhs, out);
+    case Tag::Bool: {
+        if (rhs.tag != Tag::Bool)
+            return false;
+        switch (op) {
+        case TokenType::Lessthan:           out = Scalar::of_bool(lhs.b < rhs.b);  break;
+        case TokenType::Greaterthan:        out = Scalar::of_bool(lhs.b > rhs.b);  break;
+        case TokenType::Double_Equals:      out = Scalar::of_bool(lhs.b == rhs.b); break;
+        case TokenType::Greaterthan_Equals: out = Scalar::of_bool(lhs.b >= rhs.b); break;
+        case TokenType::Lessthan_Equals:    out = Scalar::of_bool(lhs.b <= rhs.b); break;
+        case TokenType::Bang_Equals:        out = Scalar::of_bool(lhs.b != rhs.b); break;
+        default: return false;
+        }
+        return true;
+    }
+    case Tag::Char: {
+        if (rhs.tag != Tag::Char)
+            return false;
+        switch (op) {
+        case TokenType::Double_Equals: out = Scalar::of_bool(lhs.c == rhs.c); break;
+        case TokenType::Bang_Equals:   out = Scalar::of_bool(lhs.c != rhs.c); break;
+        default: return false;
+        }
+        return true;
+    }
+    default: return false;
+    }
+}
+
+bool
+earl::value::scalar_unaryop(TokenType op, const Scalar &value, Scalar &out) {
+    using Tag = Scalar::Tag;
+
+    switch (value.tag) {
+    case Tag::Int: {
+        switch (op) {
+        case TokenType::Minus:          out = Scalar::of_int(-value.i);  break;
+        case TokenType::Bang:           out = Scalar::of_bool(!value.i); break;
+        case TokenType::Backtick_Tilde: out = Scalar::of_int(~value.i);  break;
+        default: return false;
+        }
+        return true;
+    }
+    case Tag::Float: {
+        if (op != TokenType::Minus)
+            return false;
+        out = Scalar::of_float(-value.f);
+        return true;
+    }
+    case Tag::Bool: {
+        if (op != TokenType::Bang)
+            return false;
+        out = Scalar::of_bool(!value.b);
+        return true;
+    }
+    default: return false;
+    }
+}
+
+bool
+earl::value::scalar_mutate(Obj *dst, TokenType op, const Scalar &value) {
+    using Tag = Scalar::Tag;
+
+    if (dst->is_const())
+        return false;
+
+    switch (dst->type()) {
+    case Type::Int: {
+        if (value.tag != Tag::Int && value.tag != Tag::Float)
+            return false;
+        auto obj = static_cast<Int *>(dst);
+        int x = obj->value();
+        int y = value.tag == Tag::Int ? value.i : static_cast<int>(value.f);
+        switch (op) {
+        case TokenType::Equals:                    obj->fill(y);     break;
+        case TokenType::Plus_Equals:               obj->fill(x + y); break;
+        case TokenType::Minus_Equals:              obj->fill(x - y); break;
+        case TokenType::Asterisk_Equals:           obj->fill(x * y); break;
+        case TokenType::Backtick_Pipe_Equals:      obj->fill(x | y); break;
+        case TokenType::Backtick_Ampersand_Equals: obj->fill(x & y); break;
+        case TokenType::Backtick_Caret_Equals:     obj->fill(x ^ y); break;
+        case TokenType::Forwardslash_Equals: {
+            if (y == 0) return false;
+            obj->fill(x / y);
+        } break;
+        case TokenType::Percent_Equals: {
+            if (y == 0) return false;
+            obj->fill(x % y);
+        } break;
+        default: return false;
+        }
+        return true;
+    }
+    case Type::Float: {
+        if (value.tag != Tag::Int && value.tag != Tag::Float)
+            return false;
+        auto obj = static_cast<Float *>(dst);
+        double x = obj->value();
+        double y = value.tag == Tag::Int ? static_cast<double>(value.i) : value.f;
+        // Float::spec_mutate assigns the right hand side before applying
+        // the operator, so `-=` and `/=` combine the value with itself.
+        switch (op) {
+        case TokenType::Equals:              obj->fill(y);     break;
+        case TokenType::Plus_Equals:         obj->fill(y + x); break;
+        case TokenType::Asterisk_Equals:     obj->fill(y * x); break;
+        case TokenType::Minus_Equals:        obj->fill(y - y); break;
+        case TokenType::Forwardslash_Equals: obj->fill(y / y); break;
+        default: return false;
+        }
+        return true;
+    }
+    case Type::Bool: {
+        if (value.tag != Tag::Bool || op != TokenType::Equals)
+            return false;
+        static_cast<Bool *>(dst)->fill(value.b);
+        return true;
+    }
+    case Type::Char: {
+        if (value.tag != Tag::Char || op != TokenType::Equals)
+            return false;
+        static_cast<Char *>(dst)->fill(value.c);
+        return true;
+    }
+    default: return false;
+    }
+}
@@ -0,0 +1,331 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cassert>
+#include <memory>
+#include <type_traits>
+
+#include "earl.hpp"
+#include "err.hpp"
+#include "utils.hpp"
+
+using namespace earl::value;
+
+/// @brief Get the key that `value` is stored under in a table keyed by `K`.
+/// The caller must have checked the type of `value`.
+/// @return false if `value` cannot be hashed (a tuple holding a list, etc.)
+template <typename K> static bool
+key_of(Obj *value, K &out) {
+    if constexpr (std::is_same_v<K, int>)
+        out = dynamic_cast<Int *>(value)->value();
+    else if constexpr (std::is_same_v<K, double>)
+        out = dynamic_cast<Float *>(value)->value();
+    else if constexpr (std::is_same_v<K, char>)
+        out = dynamic_cast<Char *>(value)->value();
+    else if constexpr (std::is_same_v<K, std::string_view>)
+        out = dynamic_cast<Str *>(value)->view();
+    else
+        return DictKey::from(value, out);
+    return true;
+}
+
+/// @brief The type to look keys up with in a table keyed by `K`
+/// (strs are looked up without copying them)
+template <typename K>
+using lookup_t = std::conditional_t<std::is_same_v<K, std::string>, std::string_view, K>;
+
+template <typename K> static std::shared_ptr<Obj>
+box(const K &key) {
+    if constexpr (std::is_same_v<K, int>)
+        return std::make_shared<Int>(key);
+    else if constexpr (std::is_same_v<K, double>)
+        return std::make_shared<Float>(key);
+    else if constexpr (std::is_same_v<K, char>)
+        return std::make_shared<Char>(key);
+    else if constexpr (std::is_same_v<K, std::string>)
+        return std::make_shared<Str>(key);
+    else
+        return key.value();
+}
+
+Set::Set() : m_etype(Type::Void) {}
+
+Type
+Set::etype(void) const {
+    return m_etype;
+}
+
+size_t
+Set::size(void) const {
+    return std::visit([](auto &map) -> size_t {
+        if constexpr (std::is_same_v<std::decay_t<decltype(map)>, std::monostate>)
+            return 0;
+        else
+            return map.size();
+    }, m_items);
+}
+
+std::shared_ptr<Obj>
+Set::elem(size_t i) const {
+    return std::visit([&](auto &map) -> std::shared_ptr<Obj> {
+        if constexpr (std::is_same_v<std::decay_t<decltype(map)>, std::monostate>)
+            return nullptr;
+        else
+            return box((map.begin() + i)->first);
+    }, m_items);
+}
+
+void
+Set::unify(Type ty, Expr *expr) {
+    if (m_etype == Type::Void) {
+        switch (ty) {
+        case Type::Int:   m_items.emplace<FlatMap<int, bool>>(); break;
+        case Type::Float: m_items.emplace<FlatMap<double, bool>>(); break;
+        case Type::Char:  m_items.emplace<FlatMap<char, bool>>(); break;
+        case Type::Str:   m_items.emplace<FlatMap<std::string, bool>>(); break;
+        case Type::Bool:
+        case Type::Tuple: m_items.emplace<FlatMap<DictKey, bool>>(); break;
+        default: {
+            Err::err_wexpr(expr);
+            const std::string msg = "values of type `"+type_to_str(ty)+"` cannot be put in a set";
+            throw InterpreterException(msg);
+        }
+        }
+        m_etype = ty;
+    }
+    else if (ty != m_etype) {
+        Err::err_wexpr(expr);
+        const std::string msg = "a set of `"+type_to_str(m_etype)
+            +"` values cannot hold a value of type `"+type_to_str(ty)+"`";
+        throw InterpreterException(msg);
+    }
+}
+
+void
+Set::insert(std::shared_ptr<Obj> &value, Expr *expr) {
+    unify(value->type(), expr);
+    std::visit([&](auto &map) {
+        using M = std::decay_t<decltype(map)>;
+        if constexpr (!std::is_same_v<M, std::monostate>) {
+            using K = typename M::key_type;
+            lookup_t<K> key;
+            if (!key_of(value.get(), key)) {
+                Err::err_wexpr(expr);
+                const std::string msg = "tuples in a set may only hold int, float, bool, char, str or tuple values";
+                throw InterpreterException(msg);
+            }
+            map.insert_or_assign(K(key), true);
+        }
+    }, m_items);
+}
+
+std::shared_ptr<Bool>
+Set::remove(std::shared_ptr<Obj> &value) {
+    if (value->type() != m_etype)
+        return std::make_shared<Bool>(false);
+    return std::visit([&](auto &map) {
+        using M = std::decay_t<decltype(map)>;
+        bool removed = false;
+        if constexpr (!std::is_same_v<M, std::monostate>) {
+            lookup_t<typename M::key_type> key;
+            removed = key_of(value.get(), key) && map.swap_erase(key);
+        }
+        return std::make_shared<Bool>(removed);
+    }, m_items);
+}
+
+std::shared_ptr<Bool>
+Set::contains(std::shared_ptr<Obj> &value) const {
+    if (value->type() != m_etype)
+        return std::make_shared<Bool>(false);
+    return std::visit([&](auto &map) {
+        using M = std::decay_t<decltype(map)>;
+        bool found = false;
+        if constexpr (!std::is_same_v<M, std::monostate>) {
+            lookup_t<typename M::key_type> key;
+            found = key_of(value.get(), key) && map.contains(key);
+        }
+        return std::make_shared<Bool>(found);
+    }, m_items);
+}
+
+std::shared_ptr<Set>
+Set::set_union(Set *other, Expr *expr) {
+    auto set = std::dynamic_pointer_cast<Set>(this->copy());
+    if (other->m_etype == Type::Void)
+        return set;
+    set->unify(other->m_etype, expr);
+    std::visit([&](auto &dst) {
+        using M = std::decay_t<decltype(dst)>;
+        if constexpr (!std::is_same_v<M, std::monostate>) {
+            for (auto &entry : std::get<M>(other->m_items))
+                dst.insert_or_assign(entry.first, true);
+        }
+    }, set->m_items);
+    return set;
+}
+
+std::shared_ptr<Set>
+Set::intersection(Set *other, Expr *expr) {
+    auto set = std::make_shared<Set>();
+    if (m_etype == Type::Void || other->m_etype == Type::Void)
+        return set;
+    set->unify(m_etype, expr);
+    set->unify(other->m_etype, expr);
+    std::visit([&](auto &dst) {
+        using M = std::decay_t<decltype(dst)>;
+        if constexpr (!std::is_same_v<M, std::monostate>) {
+            auto &lhs = std::get<M>(m_items);
+            auto &rhs = std::get<M>(other->m_items);
+            for (auto &entry : lhs)
+                if (rhs.contains(entry.first))
+                    dst.insert_or_assign(entry.first, true);
+        }
+    }, set->m_items);
+    return set;
+}
+
+std::shared_ptr<Set>
+Set::difference(Set *other, Expr *expr) {
+    if (m_etype == Type::Void || other->m_etype == Type::Void)
+        return std::dynamic_pointer_cast<Set>(this->copy());
+    auto set = std::make_shared<Set>();
+    set->unify(m_etype, expr);
+    set->unify(other->m_etype, expr);
+    std::visit([&](auto &dst) {
+        using M = std::decay_t<decltype(dst)>;
+        if constexpr (!std::is_same_v<M, std::monostate>) {
+            auto &lhs = std::get<M>(m_items);
+            auto &rhs = std::get<M>(other->m_items);
+            for (auto &entry : lhs)
+                if (!rhs.contains(entry.first))
+                    dst.insert_or_assign(entry.first, true);
+        }
+    }, set->m_items);
+    return set;
+}
+
+/*** OVERRIDES ***/
+Type
+Set::type(void) const {
+    return Type::Set;
+}
+
+std::shared_ptr<Obj>
+Set::binop(Token *op, std::shared_ptr<Obj> &other) {
+    ASSERT_BINOP_COMPAT(this, other.get(), op);
+
+    switch (op->type()) {
+    case TokenType::Double_Equals: return std::make_shared<Bool>(this->eq(other));
+    case TokenType::Bang_Equals: return std::make_shared<Bool>(!this->eq(other));
+    default: {
+        Err::err_wtok(op);
+        std::string msg = "invalid binary operator";
+        throw InterpreterException(msg);
+    }
+    }
+    assert(false && "unreachable");
+    return nullptr;
+}
+
+bool
+Set::boolean(void) {
+    return this->size() > 0;
+}
+
+void
+Set::mutate(const std::shared_ptr<Obj> &other, StmtMut *stmt) {
+    ASSERT_MUTATE_COMPAT(this, other.get(), stmt);
+    ASSERT_CONSTNESS(this, stmt);
+
+    auto *set = dynamic_cast<Set *>(other.get());
+    m_etype = set->m_etype;
+    m_items = set->m_items;
+}
+
+std::shared_ptr<Obj>
+Set::copy(void) {
+    auto set = std::make_shared<Set>();
+    set->m_etype = m_etype;
+    set->m_items = m_items;
+    return set;
+}
+
+bool
+Set::eq(std::shared_ptr<Obj> &other) {
+    if (other->type() != Type::Set)
+        return false;
+
+    auto *set = dynamic_cast<Set *>(other.get());
+    if (this->size() != set->size())
+        return false;
+    if (this->size() == 0)
+        return true;
+    if (m_etype != set->m_etype)
+        return false;
+
+    return std::visit([&](auto &lhs) {
+        using M = std::decay_t<decltype(lhs)>;
+        if constexpr (!std::is_same_v<M, std::monostate>) {
+            auto &rhs = std::get<M>(set->m_items);
+            for (auto &entry : lhs)
+                if (!rhs.contains(entry.first))
+                    return false;
+        }
+        return true;
+    }, m_items);
+}
+
+std::string
+Set::to_cxxstring(void) {
+    std::string res = "<Set { ";
+    for (size_t i = 0; i < this->size(); ++i) {
+        res += this->elem(i)->to_cxxstring();
+        if (i != this->size()-1)
+            res += ", ";
+    }
+    res += " }>";
+    return res;
+}
+
+void
+Set::spec_mutate(Token *op, const std::shared_ptr<Obj> &other, StmtMut *stmt) {
+    (void)other;
+    (void)stmt;
+    Err::err_wtok(op);
+    std::string msg = "invalid operator for special mutation on type `set`";
+    throw InterpreterException(msg);
+}
+
+std::shared_ptr<Obj>
+Set::unaryop(Token *op) {
+    Err::err_wtok(op);
+    std::string msg = "invalid unary operator for type `set`";
+    throw InterpreterException(msg);
+}
+
+void
+Set::set_const(void) {
+    m_const = true;
+}
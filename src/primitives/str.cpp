@@ -28,31 +28,117 @@
 
 #include "earl.hpp"
 #include "err.hpp"
+#include "str-search.hpp"
 #include "utils.hpp"
 
 using namespace earl::value;
 
-Str::Str(std::string value) {
-    m_value = value;
-    m_chars = std::vector<std::shared_ptr<Char>>(value.size(), nullptr);
-    m_changed = {};
+// Get the chars to search for from the str or char argument `value`
+// of the member intrinsic `name`. A char is copied into `c` so the
+// view stays valid.
+static std::string_view
+pattern_of(std::shared_ptr<Obj> &value, char &c, const std::string &name, Expr *expr) {
+    if (value->type() == Type::Char) {
+        c = dynamic_cast<Char *>(value.get())->value();
+        return std::string_view(&c, 1);
+    }
+    if (value->type() != Type::Str) {
+        Err::err_wexpr(expr);
+        const std::string msg = "cannot use member intrinsic `"+name+"` on type str with an argument other than of type str or char";
+        throw InterpreterException(msg);
+    }
+    return dynamic_cast<Str *>(value.get())->view();
 }
 
-Str::Str(std::vector<std::shared_ptr<Char>> chars) {
-    assert(false && "unimplemented");
+// Strs this short are copied instead of shared, since copying
+// them does not allocate.
+static const size_t SMALL_STR = std::string().capacity();
+
+Str::Str(std::string value)
+    : m_str(std::move(value)) {}
+
+Str::Str(std::shared_ptr<std::string> buf, size_t off, size_t len)
+    : m_buf(std::move(buf)), m_off(off), m_len(len) {}
+
+std::shared_ptr<Str>
+Str::share(size_t off, size_t len) {
+    if (len <= SMALL_STR)
+        return std::make_shared<Str>(std::string(this->view().substr(off, len)));
+    if (!m_buf) {
+        m_len = m_str.size();
+        m_buf = std::make_shared<std::string>(std::move(m_str));
+        m_str = std::string();
+    }
+    return std::shared_ptr<Str>(new Str(m_buf, m_off+off, len));
 }
 
 void
-Str::update_changed(void) {
-    for (int i : m_changed)
-        m_value[i] = m_chars[i]->value();
-    m_changed.clear();
+Str::detach(void) {
+    if (!m_buf)
+        return;
+    if (m_buf.use_count() == 1) {
+        // Anything outside of this str belonged to strs that are gone now.
+        m_buf->resize(m_off+m_len);
+        m_buf->erase(0, m_off);
+        m_str = std::move(*m_buf);
+    }
+    else
+        m_str.assign(m_buf->data()+m_off, m_len);
+    m_buf = nullptr;
+    m_off = m_len = 0;
 }
 
-std::string
+void
+Str::extend(std::string_view value) {
+    if (!m_buf) {
+        m_str.append(value.data(), value.size());
+        return;
+    }
+    if (m_buf->size() != m_off+m_len && m_buf.use_count() != 1) {
+        auto own = std::make_shared<std::string>();
+        own->reserve(m_len + value.size());
+        own->append(m_buf->data()+m_off, m_len);
+        own->append(value.data(), value.size());
+        m_buf = std::move(own);
+        m_off = 0;
+    }
+    else {
+        m_buf->resize(m_off+m_len);
+        m_buf->append(value.data(), value.size());
+    }
+    m_len = m_buf->size()-m_off;
+}
+
+const std::string &
 Str::value(void) {
-    this->update_changed();
-    return m_value;
+    if (!m_buf)
+        return m_str;
+    if (m_off != 0 || m_buf->size() != m_len)
+        this->detach();
+    return m_buf ? *m_buf : m_str;
+}
+
+std::string_view
+Str::view(void) const {
+    if (!m_buf)
+        return m_str;
+    return std::string_view(m_buf->data()+m_off, m_len);
+}
+
+size_t
+Str::size(void) const {
+    return m_buf ? m_len : m_str.size();
+}
+
+char
+Str::at(size_t idx) const {
+    return m_buf ? (*m_buf)[m_off+idx] : m_str[idx];
+}
+
+void
+Str::set(size_t idx, char c) {
+    this->detach();
+    m_str[idx] = c;
 }
 
 std::shared_ptr<Char>
@@ -65,25 +151,15 @@ Str::nth(std::shared_ptr<Obj> &idx, Expr *expr) {
 
     auto index = dynamic_cast<Int *>(idx.get());
     int I = index->value();
-    if (I < 0 || static_cast<size_t>(I) >= m_value.size()) {
+    if (I < 0 || static_cast<size_t>(I) >= this->size()) {
         Err::err_wexpr(expr);
-        std::string msg = "index "+std::to_string(index->value())+" is out of str range of length "+std::to_string(this->value().size());
+        std::string msg = "index "+std::to_string(index->value())+" is out of str range of length "+std::to_string(this->size());
         throw InterpreterException(msg);
     }
 
-    if (m_chars.at(I)) {
-        m_value.at(I) = m_chars.at(I)->value();
-        return m_chars.at(I);
-    }
-
-    auto c = std::make_shared<Char>(m_value.at(I));
-    m_chars.at(I) = std::move(c);
-    m_changed.push_back(I);
-
-    return m_chars.at(I);
+    return this->__get_elem(I);
 }
 
-// TODO: Adhere to new string optimization
 std::shared_ptr<List>
 Str::split(std::shared_ptr<Obj> &delim, Expr *expr) {
     if (delim->type() != Type::Str) {
@@ -92,21 +168,21 @@ Str::split(std::shared_ptr<Obj> &delim, Expr *expr) {
         throw InterpreterException(msg);
     }
 
-    this->update_changed();
+    std::string_view src = this->view();
+    std::string_view delim_str = dynamic_cast<Str *>(delim.get())->view();
+    if (delim_str.empty()) {
+        Err::err_wexpr(expr);
+        const std::string msg = "cannot use member intrinsic `split` with an empty delimiter";
+        throw InterpreterException(msg);
+    }
 
     std::vector<std::shared_ptr<Obj>> splits = {};
-    std::string delim_str = dynamic_cast<Str *>(delim.get())->value();
-    std::string::size_type start = 0;
-
-    auto pos = this->value().find(delim_str);
-    std::string orig_value = this->value();
-
-    while (pos != std::string::npos) {
-        splits.push_back(std::make_shared<Str>(orig_value.substr(start, pos-start)));
-        start = pos+delim_str.length();
-        pos = orig_value.find(delim_str, start);
+    size_t start = 0;
+    for (size_t pos = StrSearch::find(src, delim_str); pos != StrSearch::npos; pos = StrSearch::find(src, delim_str, start)) {
+        splits.push_back(std::make_shared<Str>(std::string(src.substr(start, pos-start))));
+        start = pos+delim_str.size();
     }
-    splits.push_back(std::make_shared<Str>(orig_value.substr(start)));
+    splits.push_back(std::make_shared<Str>(std::string(src.substr(start))));
 
     return std::make_shared<List>(std::move(splits));
 }
@@ -119,12 +195,37 @@ Str::substr(std::shared_ptr<Obj> &idx1, std::shared_ptr<Obj> &idx2, Expr *expr)
         throw InterpreterException(msg);
     }
 
-    this->update_changed();
-
     int S = dynamic_cast<Int *>(idx1.get())->value();
     int N = dynamic_cast<Int *>(idx2.get())->value();
 
-    return std::make_shared<Str>(m_value.substr(S, N));
+    const size_t len = this->size();
+    if (S < 0 || static_cast<size_t>(S) > len) {
+        Err::err_wexpr(expr);
+        const std::string msg = "index "+std::to_string(S)+" is out of str range of length "+std::to_string(len);
+        throw InterpreterException(msg);
+    }
+
+    // Like `std::string::substr`, a length past the end (or
+    // a negative one) takes the rest of the str.
+    size_t n = std::min(static_cast<size_t>(N), len-S);
+    return this->share(S, n);
+}
+
+std::shared_ptr<Str>
+Str::slice(std::shared_ptr<Obj> &start, std::shared_ptr<Obj> &end, Expr *expr) {
+    const int n = static_cast<int>(this->size());
+    int s = start->type() == Type::Void ? 0 : dynamic_cast<Int *>(start.get())->value();
+    int e = end->type() == Type::Void ? n : dynamic_cast<Int *>(end.get())->value();
+
+    if (s >= e)
+        return std::make_shared<Str>();
+    if (s < 0 || s >= n || e > n) {
+        Err::err_wexpr(expr);
+        int bad = s < 0 || s >= n ? s : n;
+        const std::string msg = "index "+std::to_string(bad)+" is out of str range of length "+std::to_string(n);
+        throw InterpreterException(msg);
+    }
+    return this->share(s, e-s);
 }
 
 void
@@ -132,64 +233,39 @@ Str::pop(std::shared_ptr<Obj> &idx, Expr *expr) {
     (void)expr;
     auto *idx1 = dynamic_cast<earl::value::Int *>(idx.get());
     int I = idx1->value();
-    this->update_changed();
-    m_value.erase(m_value.begin() + I);
-    m_chars.erase(m_chars.begin() + I);
+    this->detach();
+    m_str.erase(m_str.begin() + I);
 }
 
 std::shared_ptr<Obj>
 Str::back(void) {
-    this->update_changed();
-
-    if (m_value.size() == 0)
+    if (this->size() == 0)
         return std::make_shared<Option>();
-
-    if (m_chars.back()) {
-        m_value.back() = m_chars.back()->value();
-        return m_chars.back();
-    }
-
-    auto c = std::make_shared<Char>(m_value.back());
-    m_chars.back() = std::move(c);
-    return m_chars.back();
+    return this->__get_elem(this->size()-1);
 }
 
 std::shared_ptr<Str>
 Str::rev(void) {
-    this->update_changed();
-    auto str = std::make_shared<Str>();
-    for (int i = m_value.size()-1; i >= 0; --i)
-        str->append(m_value[i]);
-    return str;
+    std::string_view chars = this->view();
+    return std::make_shared<Str>(std::string(chars.rbegin(), chars.rend()));
 }
 
 void
 Str::append(const std::string &value) {
-    for (size_t i = 0; i < value.size(); ++i) {
-        m_value.push_back(value.at(i));
-        m_chars.push_back(nullptr);
-    }
+    this->extend(value);
 }
 
 void
 Str::append(char c) {
-    m_value.push_back(c);
-    m_chars.push_back(nullptr);
+    this->extend(std::string_view(&c, 1));
 }
 
 void
 Str::append(std::shared_ptr<Obj> c) {
-    if (c->type() == Type::Char) {
-        auto cx = dynamic_cast<Char*>(c.get());
-        m_value.push_back(cx->value());
-        m_chars.push_back(nullptr);
-    }
-    else {
-        auto s = dynamic_cast<Str *>(c.get());
-        m_value += s->value();
-        for (int i=0; i < s->value().size(); ++i)
-            m_chars.push_back(nullptr);
-    }
+    if (c->type() == Type::Char)
+        this->append(dynamic_cast<Char *>(c.get())->value());
+    else
+        this->extend(dynamic_cast<Str *>(c.get())->view());
 }
 
 void
@@ -206,24 +282,14 @@ Str::append(std::vector<std::shared_ptr<Obj>> &values, Expr *expr) {
 
 std::shared_ptr<Str>
 Str::filter(std::shared_ptr<Obj> &closure, std::shared_ptr<Ctx> &ctx) {
-    this->update_changed();
-
     Closure *cl = dynamic_cast<Closure *>(closure.get());
 
     auto acc = std::make_shared<Str>();
 
-    for (int i = 0; i < m_value.size(); ++i) {
-        std::shared_ptr<Char> cx = nullptr;
-        if (m_chars.at(i)) {
-            m_value.at(i) = m_chars.at(i)->value();
-            cx = m_chars.at(i);
-        }
-        else {
-            auto tmpc = std::make_shared<Char>(m_value.at(i));
-            m_chars.at(i) = std::move(tmpc);
-            cx = m_chars.at(i);
-            m_changed.push_back(i);
-        }
+    // The closure may change the str, so the length is
+    // looked up again on every iteration.
+    for (size_t i = 0; i < this->size(); ++i) {
+        std::shared_ptr<Char> cx = this->__get_elem(i);
         std::vector<std::shared_ptr<Obj>> values = {cx};
         std::shared_ptr<Obj> filter_result = cl->call(values, ctx);
         if (dynamic_cast<Bool *>(filter_result.get())->boolean())
@@ -234,34 +300,86 @@ Str::filter(std::shared_ptr<Obj> &closure, std::shared_ptr<Ctx> &ctx) {
 }
 
 std::shared_ptr<Bool>
-Str::contains(std::shared_ptr<Char> &value) {
-    for (size_t i = 0; i < m_value.size(); ++i) {
-        if (m_chars.at(i) && m_chars.at(i)->value() != m_value.at(i))
-            m_value.at(i) = m_chars.at(i)->value();
+Str::contains(std::shared_ptr<Obj> &value, Expr *expr) {
+    char c;
+    std::string_view pattern = pattern_of(value, c, "contains", expr);
+    return std::make_shared<Bool>(StrSearch::find(this->view(), pattern) != StrSearch::npos);
+}
+
+std::shared_ptr<Obj>
+Str::find(std::shared_ptr<Obj> &value, Expr *expr) {
+    char c;
+    size_t idx = StrSearch::find(this->view(), pattern_of(value, c, "find", expr));
+    if (idx == StrSearch::npos)
+        return std::make_shared<Option>();
+    return std::make_shared<Option>(std::make_shared<Int>(static_cast<int>(idx)));
+}
+
+std::shared_ptr<Obj>
+Str::rfind(std::shared_ptr<Obj> &value, Expr *expr) {
+    char c;
+    size_t idx = StrSearch::rfind(this->view(), pattern_of(value, c, "rfind", expr));
+    if (idx == StrSearch::npos)
+        return std::make_shared<Option>();
+    return std::make_shared<Option>(std::make_shared<Int>(static_cast<int>(idx)));
+}
+
+std::shared_ptr<Int>
+Str::count(std::shared_ptr<Obj> &value, Expr *expr) {
+    char c;
+    std::string_view pattern = pattern_of(value, c, "count", expr);
+    if (pattern.empty()) {
+        Err::err_wexpr(expr);
+        const std::string msg = "cannot use member intrinsic `count` with an empty str";
+        throw InterpreterException(msg);
+    }
+    return std::make_shared<Int>(static_cast<int>(StrSearch::count(this->view(), pattern)));
+}
+
+std::shared_ptr<Str>
+Str::replace(std::shared_ptr<Obj> &from, std::shared_ptr<Obj> &to, Expr *expr) {
+    char c1, c2;
+    std::string_view pattern = pattern_of(from, c1, "replace", expr);
+    std::string_view replacement = pattern_of(to, c2, "replace", expr);
+    if (pattern.empty()) {
+        Err::err_wexpr(expr);
+        const std::string msg = "cannot use member intrinsic `replace` with an empty str";
+        throw InterpreterException(msg);
+    }
 
-        if (m_value.at(i) == value->value())
-            return std::make_shared<Bool>(true);
+    std::string_view src = this->view();
+    std::string result;
+    result.reserve(src.size());
+    size_t start = 0;
+    for (size_t pos = StrSearch::find(src, pattern); pos != StrSearch::npos; pos = StrSearch::find(src, pattern, start)) {
+        result.append(src.data()+start, pos-start);
+        result.append(replacement.data(), replacement.size());
+        start = pos+pattern.size();
     }
-    return std::make_shared<Bool>(false);
+    result.append(src.data()+start, src.size()-start);
+    return std::make_shared<Str>(std::move(result));
+}
+
+std::shared_ptr<Bool>
+Str::starts_with(std::shared_ptr<Obj> &value, Expr *expr) {
+    char c;
+    std::string_view pattern = pattern_of(value, c, "starts_with", expr);
+    return std::make_shared<Bool>(this->view().substr(0, pattern.size()) == pattern);
+}
+
+std::shared_ptr<Bool>
+Str::ends_with(std::shared_ptr<Obj> &value, Expr *expr) {
+    char c;
+    std::string_view pattern = pattern_of(value, c, "ends_with", expr);
+    std::string_view src = this->view();
+    return std::make_shared<Bool>(src.size() >= pattern.size() && src.substr(src.size()-pattern.size()) == pattern);
 }
 
 void
 Str::foreach(std::shared_ptr<Obj> &closure, std::shared_ptr<Ctx> &ctx) {
-    this->update_changed();
     Closure *cl = dynamic_cast<Closure *>(closure.get());
-    for (size_t i = 0; i < m_value.size(); ++i) {
-        std::shared_ptr<Char> cx = nullptr;
-        if (m_chars.at(i)) {
-            m_value.at(i) = m_chars.at(i)->value();
-            cx = m_chars.at(i);
-        }
-        else {
-            auto tmpc = std::make_shared<Char>(m_value.at(i));
-            m_chars.at(i) = std::move(tmpc);
-            cx = m_chars.at(i);
-            m_changed.push_back(i);
-        }
-        std::vector<std::shared_ptr<Obj>> values = {cx};
+    for (size_t i = 0; i < this->size(); ++i) {
+        std::vector<std::shared_ptr<Obj>> values = {this->__get_elem(i)};
         cl->call(values, ctx);
     }
 }
@@ -276,20 +394,25 @@ Str::type(void) const {
     return Type::Str;
 }
 
-// TODO: Adhere to new string optimization
 std::shared_ptr<Obj>
 Str::binop(Token *op, std::shared_ptr<Obj> &other) {
     ASSERT_BINOP_COMPAT(this, other.get(), op);
-    this->update_changed();
     switch (op->type()) {
     case TokenType::Plus: {
-        return std::make_shared<Str>(this->value() + dynamic_cast<Str *>(other.get())->value());
+        // Shares the buffer with this str, so `s = s + t` in a
+        // loop appends in place instead of copying `s` every time.
+        std::string_view rhs = dynamic_cast<Str *>(other.get())->view();
+        if (this->size()+rhs.size() <= SMALL_STR)
+            return std::make_shared<Str>(std::string(this->view()).append(rhs));
+        std::shared_ptr<Str> result = this->share(0, this->size());
+        result->extend(rhs);
+        return result;
     } break;
     case TokenType::Double_Equals: {
-        return std::make_shared<Bool>(this->value() == dynamic_cast<Str *>(other.get())->value());
+        return std::make_shared<Bool>(this->view() == dynamic_cast<Str *>(other.get())->view());
     } break;
     case TokenType::Bang_Equals: {
-        return std::make_shared<Bool>(this->value() != dynamic_cast<Str *>(other.get())->value());
+        return std::make_shared<Bool>(this->view() != dynamic_cast<Str *>(other.get())->view());
     } break;
     default: {
         Err::err_wtok(op);
@@ -304,71 +427,50 @@ Str::boolean(void) {
     return true;
 }
 
-std::vector<std::shared_ptr<Char>>
-Str::value_as_earlchar(void) {
-    std::vector<std::shared_ptr<Char>> values = {};
-    std::for_each(m_value.begin(), m_value.end(), [&](char c){
-        auto cx = std::make_shared<Char>(c);
-        values.push_back(std::move(cx));
-    });
-    return values;
-}
-
 std::shared_ptr<Char>
 Str::__get_elem(size_t idx) {
-    this->update_changed();
-    int I = idx;
-    std::shared_ptr<Char> c = nullptr;
-    if (m_chars.at(I)) {
-        m_value.at(I) = m_chars.at(I)->value();
-        c = m_chars.at(I);
-    }
-    else {
-        auto tmpc = std::make_shared<Char>(m_value.at(I));
-        m_chars.at(I) = std::move(tmpc);
-        c = m_chars.at(I);
-        m_changed.push_back(I);
-    }
-    return c;
+    return std::make_shared<Char>(this->shared_from_this(), idx);
 }
 
-// TODO: Adhere to new string optimization
 void
 Str::mutate(const std::shared_ptr<Obj> &other, StmtMut *stmt) {
     ASSERT_MUTATE_COMPAT(this, other.get(), stmt);
     ASSERT_CONSTNESS(this, stmt);
 
     Str *otherstr = dynamic_cast<Str *>(other.get());
-    m_value = otherstr->m_value;
-    m_chars = otherstr->m_chars;
+    if (otherstr == this)
+        return;
+    m_str = otherstr->m_str;
+    m_buf = otherstr->m_buf;
+    m_off = otherstr->m_off;
+    m_len = otherstr->m_len;
 }
 
 std::shared_ptr<Obj>
 Str::copy(void) {
-    this->update_changed();
-    return std::make_shared<Str>(m_value);
+    return this->share(0, this->size());
 }
 
 bool
 Str::eq(std::shared_ptr<Obj> &other) {
     if (other->type() != Type::Str)
         return false;
-    return this->value() == dynamic_cast<Str *>(other.get())->value();
+    return this->view() == dynamic_cast<Str *>(other.get())->view();
 }
 
 std::string
 Str::to_cxxstring(void) {
-    return this->value();
+    return std::string(this->view());
 }
 
 // CHANGME
 void
 Str::spec_mutate(Token *op, const std::shared_ptr<Obj> &other, StmtMut *stmt) {
-    ASSERT_MUTATE_COMPAT(this, other.get(), stmt);
+    // A single char can be appended with `+=`.
+    if (other->type() != Type::Char || op->type() != TokenType::Plus_Equals)
+        ASSERT_MUTATE_COMPAT(this, other.get(), stmt);
     ASSERT_CONSTNESS(this, stmt);
 
-    this->update_changed();
-
     switch (op->type()) {
     case TokenType::Plus_Equals: {
         this->append(other);
@@ -31,11 +31,27 @@
 
 using namespace earl::value;
 
-Tuple::Tuple(std::vector<std::shared_ptr<Obj>> values) : m_values(values) {}
+Tuple::Tuple(std::vector<std::shared_ptr<Obj>> values)
+    : m_values(std::make_shared<std::vector<std::shared_ptr<Obj>>>(std::move(values))), m_len(m_values->size()) {}
 
 std::vector<std::shared_ptr<Obj>> &
 Tuple::value(void) {
-    return m_values;
+    if (m_off != 0 || m_len != m_values->size()) {
+        auto first = m_values->begin()+m_off;
+        m_values = std::make_shared<std::vector<std::shared_ptr<Obj>>>(first, first+m_len);
+        m_off = 0;
+    }
+    return *m_values;
+}
+
+size_t
+Tuple::size(void) const {
+    return m_len;
+}
+
+std::shared_ptr<Obj> &
+Tuple::at(size_t idx) {
+    return (*m_values)[m_off+idx];
 }
 
 std::shared_ptr<Obj>
@@ -43,12 +59,32 @@ Tuple::nth(std::shared_ptr<Obj> &idx, Expr *expr) {
     switch (idx->type()) {
     case Type::Int: {
         auto index = dynamic_cast<Int *>(idx.get());
-        if (index->value() < 0 || static_cast<size_t>(index->value()) >= this->value().size()) {
+        if (index->value() < 0 || static_cast<size_t>(index->value()) >= m_len) {
             Err::err_wexpr(expr);
-            std::string msg = "index "+std::to_string(index->value())+" is out of range of length "+std::to_string(this->value().size());
+            std::string msg = "index "+std::to_string(index->value())+" is out of range of length "+std::to_string(m_len);
             throw InterpreterException(msg);
         }
-        return this->value().at(index->value());
+        return this->at(index->value());
+    } break;
+    case Type::Slice: {
+        // Tuples cannot be changed, so the slice can share the elements.
+        auto slice = dynamic_cast<Slice *>(idx.get());
+        const int n = static_cast<int>(m_len);
+        int s = slice->start()->type() == Type::Void ? 0 : dynamic_cast<Int *>(slice->start().get())->value();
+        int e = slice->end()->type() == Type::Void ? n : dynamic_cast<Int *>(slice->end().get())->value();
+        if (s >= e)
+            return std::make_shared<Tuple>();
+        if (s < 0 || s >= n || e > n) {
+            Err::err_wexpr(expr);
+            int bad = s < 0 || s >= n ? s : n;
+            std::string msg = "index "+std::to_string(bad)+" is out of range for tuple of length "+std::to_string(n);
+            throw InterpreterException(msg);
+        }
+        auto tuple = std::make_shared<Tuple>();
+        tuple->m_values = m_values;
+        tuple->m_off = m_off+s;
+        tuple->m_len = e-s;
+        return tuple;
     } break;
     default: {
         std::string msg = "invalid index when accessing value in a tuple";
@@ -60,9 +96,9 @@ Tuple::nth(std::shared_ptr<Obj> &idx, Expr *expr) {
 
 std::shared_ptr<Obj>
 Tuple::back(void) {
-    if (m_values.size() == 0)
+    if (m_len == 0)
         return std::make_shared<Option>();
-    return m_values.back()->copy();
+    return this->at(m_len-1)->copy();
 }
 
 std::shared_ptr<Tuple>
@@ -72,31 +108,32 @@ Tuple::filter(std::shared_ptr<Obj> &closure, std::shared_ptr<Ctx> &ctx) {
     auto copy = std::make_shared<Tuple>();
     std::vector<std::shared_ptr<Obj>> keep_values = {};
 
-    for (size_t i = 0; i < m_values.size(); ++i) {
-        std::vector<std::shared_ptr<Obj>> values = {m_values.at(i)};
+    for (size_t i = 0; i < m_len; ++i) {
+        std::vector<std::shared_ptr<Obj>> values = {this->at(i)};
         std::shared_ptr<Obj> filter_result = cl->call(values, ctx);
         assert(filter_result->type() == Type::Bool);
         if (dynamic_cast<Bool *>(filter_result.get())->boolean())
-            keep_values.push_back(m_values.at(i)->copy());
+            keep_values.push_back(this->at(i)->copy());
     }
 
-    std::for_each(keep_values.begin(), keep_values.end(), [&](auto &v) {copy->m_values.push_back(v);});
+    std::for_each(keep_values.begin(), keep_values.end(), [&](auto &v) {copy->m_values->push_back(v);});
+    copy->m_len = copy->m_values->size();
     return copy;
 }
 
 void
 Tuple::foreach(std::shared_ptr<Obj> &closure, std::shared_ptr<Ctx> &ctx) {
     Closure *cl = dynamic_cast<Closure *>(closure.get());
-    for (size_t i = 0; i < m_values.size(); ++i) {
-        std::vector<std::shared_ptr<Obj>> values = {m_values[i]};
+    for (size_t i = 0; i < m_len; ++i) {
+        std::vector<std::shared_ptr<Obj>> values = {this->at(i)};
         cl->call(values, ctx);
     }
 }
 
 std::shared_ptr<Bool>
 Tuple::contains(std::shared_ptr<Obj> &value) {
-    for (size_t i = 0; i < m_values.size(); ++i)
-        if (m_values.at(i)->eq(value))
+    for (size_t i = 0; i < m_len; ++i)
+        if (this->at(i)->eq(value))
             return std::make_shared<Bool>(true);
     return std::make_shared<Bool>(false);
 }
@@ -104,8 +141,9 @@ Tuple::contains(std::shared_ptr<Obj> &value) {
 std::shared_ptr<Tuple>
 Tuple::rev(void) {
     auto tuple = std::make_shared<Tuple>();
-    for (int i = m_values.size()-1; i >= 0; --i)
-        tuple->m_values.push_back(m_values.at(i)->copy());
+    for (int i = m_len-1; i >= 0; --i)
+        tuple->m_values->push_back(this->at(i)->copy());
+    tuple->m_len = m_len;
     return tuple;
 }
 
@@ -123,15 +161,17 @@ Tuple::binop(Token *op, std::shared_ptr<Obj> &other) {
     switch (op->type()) {
     case TokenType::Plus: {
         std::vector<std::shared_ptr<Obj>> values = {};
-        std::for_each(m_values.begin(), m_values.end(), [&](auto &v){values.push_back(v);});
-        std::for_each(other_tuple->value().begin(), other_tuple->value().end(), [&](auto &v){values.push_back(v);});
+        for (size_t i = 0; i < m_len; ++i)
+            values.push_back(this->at(i));
+        for (size_t i = 0; i < other_tuple->size(); ++i)
+            values.push_back(other_tuple->at(i));
         return std::make_shared<Tuple>(values);
     } break;
     case TokenType::Double_Equals: {
-        if (m_values.size() != other_tuple->value().size())
+        if (m_len != other_tuple->size())
             return std::make_shared<Bool>(false);
-        for (size_t i = 0; i < m_values.size(); ++i) {
-            if (!m_values[i]->eq(other_tuple->value()[i]))
+        for (size_t i = 0; i < m_len; ++i) {
+            if (!this->at(i)->eq(other_tuple->at(i)))
                 return std::make_shared<Bool>(false);
         }
         return std::make_shared<Bool>(true);
@@ -161,9 +201,12 @@ Tuple::mutate(const std::shared_ptr<Obj> &other, StmtMut *stmt) {
 
 std::shared_ptr<Obj>
 Tuple::copy(void) {
-    std::vector<std::shared_ptr<Obj>> values = {};
-    std::for_each(m_values.begin(), m_values.end(), [&](auto &v){values.push_back(v);});
-    return std::make_shared<Tuple>(values);
+    // Tuples cannot be changed, so the copy can share the elements.
+    auto tuple = std::make_shared<Tuple>();
+    tuple->m_values = m_values;
+    tuple->m_off = m_off;
+    tuple->m_len = m_len;
+    return tuple;
 }
 
 bool
@@ -172,11 +215,11 @@ Tuple::eq(std::shared_ptr<Obj> &other) {
         return false;
 
     auto other_tuple = dynamic_cast<Tuple *>(other.get());
-    if (m_values.size() != other_tuple->value().size())
+    if (m_len != other_tuple->size())
         return false;
 
-    for (size_t i = 0; i < m_values.size(); ++i) {
-        if (!m_values[i]->eq(other_tuple->value()[i]))
+    for (size_t i = 0; i < m_len; ++i) {
+        if (!this->at(i)->eq(other_tuple->at(i)))
             return false;
     }
     return true;
@@ -185,9 +228,9 @@ Tuple::eq(std::shared_ptr<Obj> &other) {
 std::string
 Tuple::to_cxxstring(void) {
     std::string res = "(";
-    for (size_t i = 0; i < m_values.size(); ++i) {
-        res += m_values.at(i)->to_cxxstring();
-        if (i != m_values.size()-1)
+    for (size_t i = 0; i < m_len; ++i) {
+        res += this->at(i)->to_cxxstring();
+        if (i != m_len-1)
             res += ", ";
     }
     res += ")";
@@ -614,7 +614,7 @@ repl::run(void) {
             Stmt *stmt = wctx->stmt_at(i);
             if (!stmt->m_evald) {
                 try {
-                    auto val = Interpreter::eval_stmt(stmt, ctx);
+                    auto val = Interpreter::eval_stmt(stmt, ctx).value;
                     if (val) {
                         std::vector<std::shared_ptr<earl::value::Obj>> params = {val};
                         green();
@@ -631,6 +631,13 @@ repl::run(void) {
             }
         }
 
+        // Nothing refers to the nodes of a line that defined no
+        // functions, closures, classes or enums, so free its arena
+        // now instead of keeping it for the rest of the session.
+        // The lexer stays, since variables keep pointers to its tokens.
+        if (!wctx->get_repl_program(wctx->get_repl_programs_len()-1)->m_defines)
+            wctx->pop_repl_program();
+
         save_repl_history();
     }
 
@@ -0,0 +1,309 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "resolver.hpp"
+
+namespace {
+
+    // Marks a name that is bound by something the resolver does
+    // not track (i.e., `some(x)` in a match) so that it shadows
+    // any enclosing local of the same name.
+    constexpr int BLOCKED = -1;
+
+    struct Frame {
+        Frame(StmtDef *def) : m_def(def), m_nslots(0) {}
+
+        StmtDef *m_def;
+        std::vector<std::unordered_map<std::string, int>> m_scopes;
+        int m_nslots;
+
+        void push(void) { m_scopes.emplace_back(); }
+        void pop(void)  { m_scopes.pop_back(); }
+
+        Slot
+        declare(const std::string &id) {
+            if (id == "_")
+                return Slot{};
+            m_scopes.back()[id] = m_nslots;
+            return Slot{m_def, m_nslots++};
+        }
+
+        void
+        block(const std::string &id) {
+            m_scopes.back()[id] = BLOCKED;
+        }
+
+        Slot
+        lookup(const std::string &id) const {
+            for (auto it = m_scopes.rbegin(); it != m_scopes.rend(); ++it) {
+                auto slot = it->find(id);
+                if (slot != it->end()) {
+                    if (slot->second == BLOCKED)
+                        return Slot{};
+                    return Slot{m_def, slot->second};
+                }
+            }
+            return Slot{};
+        }
+    };
+
+    void resolve_stmt(Stmt *stmt, Frame *frame);
+    void resolve_expr(Expr *expr, Frame *frame);
+
+    void
+    resolve_def(StmtDef *stmt) {
+        Frame frame(stmt);
+        frame.push();
+        for (auto &arg : stmt->m_args) {
+            // Duplicate parameters are left to the interpreter.
+            if (frame.lookup(arg.first->lexeme()).m_frame)
+                return;
+            frame.declare(arg.first->lexeme());
+        }
+        resolve_stmt(stmt->m_block.get(), &frame);
+        stmt->m_nslots = frame.m_nslots;
+    }
+
+    void
+    resolve_funccall(ExprFuncCall *expr, Frame *frame) {
+        // A plain identifier on the left is a function (or closure)
+        // name and is looked up as such by the interpreter.
+        if (expr->m_left->get_type() != ExprType::Term
+            || dynamic_cast<ExprTerm *>(expr->m_left.get())->get_term_type() != ExprTermType::Ident)
+            resolve_expr(expr->m_left.get(), frame);
+        for (auto &param : expr->m_params)
+            resolve_expr(param.get(), frame);
+    }
+
+    void
+    resolve_term(ExprTerm *expr, Frame *frame) {
+        switch (expr->get_term_type()) {
+        case ExprTermType::Ident: {
+            auto ident = dynamic_cast<ExprIdent *>(expr);
+            if (frame)
+                ident->m_slot = frame->lookup(ident->m_tok->lexeme());
+        } break;
+        case ExprTermType::Func_Call: {
+            resolve_funccall(dynamic_cast<ExprFuncCall *>(expr), frame);
+        } break;
+        case ExprTermType::List_Literal: {
+            for (auto &elem : dynamic_cast<ExprListLit *>(expr)->m_elems)
+                resolve_expr(elem.get(), frame);
+        } break;
+        case ExprTermType::Range: {
+            auto range = dynamic_cast<ExprRange *>(expr);
+            resolve_expr(range->m_start.get(), frame);
+            resolve_expr(range->m_end.get(), frame);
+        } break;
+        case ExprTermType::Slice: {
+            auto slice = dynamic_cast<ExprSlice *>(expr);
+            if (slice->m_start.has_value())
+                resolve_expr(slice->m_start.value().get(), frame);
+            if (slice->m_end.has_value())
+                resolve_expr(slice->m_end.value().get(), frame);
+        } break;
+        case ExprTermType::Get: {
+            // The right hand side is a member of the left hand side,
+            // only the arguments of a method call are locals.
+            auto get = dynamic_cast<ExprGet *>(expr);
+            resolve_expr(get->m_left.get(), frame);
+            if (std::holds_alternative<std::unique_ptr<ExprFuncCall>>(get->m_right))
+                for (auto &param : std::get<std::unique_ptr<ExprFuncCall>>(get->m_right)->m_params)
+                    resolve_expr(param.get(), frame);
+        } break;
+        case ExprTermType::Mod_Access: {
+            auto access = dynamic_cast<ExprModAccess *>(expr);
+            if (std::holds_alternative<std::unique_ptr<ExprFuncCall>>(access->m_right))
+                for (auto &param : std::get<std::unique_ptr<ExprFuncCall>>(access->m_right)->m_params)
+                    resolve_expr(param.get(), frame);
+        } break;
+        case ExprTermType::Array_Access: {
+            auto access = dynamic_cast<ExprArrayAccess *>(expr);
+            resolve_expr(access->m_left.get(), frame);
+            resolve_expr(access->m_expr.get(), frame);
+        } break;
+        case ExprTermType::Tuple: {
+            for (auto &elem : dynamic_cast<ExprTuple *>(expr)->m_exprs)
+                resolve_expr(elem.get(), frame);
+        } break;
+        case ExprTermType::Dict: {
+            for (auto &entry : dynamic_cast<ExprDict *>(expr)->m_values) {
+                resolve_expr(entry.first.get(), frame);
+                resolve_expr(entry.second.get(), frame);
+            }
+        } break;
+        case ExprTermType::FStr: {
+            for (auto &elem : dynamic_cast<ExprFStr *>(expr)->m_exprs)
+                resolve_expr(elem.get(), frame);
+        } break;
+        case ExprTermType::Closure: {
+            // Closures run in their own context, their bodies
+            // keep looking variables up by name.
+        } break;
+        default: break;
+        }
+    }
+
+    void
+    resolve_expr(Expr *expr, Frame *frame) {
+        switch (expr->get_type()) {
+        case ExprType::Term: {
+            resolve_term(dynamic_cast<ExprTerm *>(expr), frame);
+        } break;
+        case ExprType::Binary: {
+            auto binary = dynamic_cast<ExprBinary *>(expr);
+            resolve_expr(binary->m_lhs.get(), frame);
+            resolve_expr(binary->m_rhs.get(), frame);
+        } break;
+        case ExprType::Unary: {
+            resolve_expr(dynamic_cast<ExprUnary *>(expr)->m_expr.get(), frame);
+        } break;
+        }
+    }
+
+    // Returns the identifier bound by a `some(x)` match pattern, or nullptr.
+    ExprIdent *
+    some_binding(Expr *expr) {
+        if (expr->get_type() != ExprType::Term
+            || dynamic_cast<ExprTerm *>(expr)->get_term_type() != ExprTermType::Func_Call)
+            return nullptr;
+        auto call = dynamic_cast<ExprFuncCall *>(expr);
+        if (call->m_params.size() != 1
+            || call->m_params[0]->get_type() != ExprType::Term
+            || dynamic_cast<ExprTerm *>(call->m_params[0].get())->get_term_type() != ExprTermType::Ident)
+            return nullptr;
+        return dynamic_cast<ExprIdent *>(call->m_params[0].get());
+    }
+
+    void
+    resolve_match(StmtMatch *stmt, Frame *frame) {
+        resolve_expr(stmt->m_expr.get(), frame);
+        for (auto &branch : stmt->m_branches) {
+            if (frame) {
+                frame->push();
+                for (auto &pattern : branch->m_expr)
+                    if (auto binding = some_binding(pattern.get()))
+                        frame->block(binding->m_tok->lexeme());
+            }
+            for (auto &pattern : branch->m_expr)
+                if (!some_binding(pattern.get()))
+                    resolve_expr(pattern.get(), frame);
+            if (branch->m_when.has_value())
+                resolve_expr(branch->m_when.value().get(), frame);
+            resolve_stmt(branch->m_block.get(), frame);
+            if (frame)
+                frame->pop();
+        }
+    }
+
+    void
+    resolve_stmt(Stmt *stmt, Frame *frame) {
+        switch (stmt->stmt_type()) {
+        case StmtType::Def: {
+            resolve_def(dynamic_cast<StmtDef *>(stmt));
+        } break;
+        case StmtType::Let: {
+            auto let = dynamic_cast<StmtLet *>(stmt);
+            resolve_expr(let->m_expr.get(), frame);
+            if (frame)
+                for (auto &id : let->m_ids)
+                    let->m_slots.push_back(frame->declare(id->lexeme()));
+        } break;
+        case StmtType::Block: {
+            if (frame) frame->push();
+            for (auto &s : dynamic_cast<StmtBlock *>(stmt)->m_stmts)
+                resolve_stmt(s.get(), frame);
+            if (frame) frame->pop();
+        } break;
+        case StmtType::Mut: {
+            auto mut = dynamic_cast<StmtMut *>(stmt);
+            resolve_expr(mut->m_left.get(), frame);
+            resolve_expr(mut->m_right.get(), frame);
+        } break;
+        case StmtType::Stmt_Expr: {
+            resolve_expr(dynamic_cast<StmtExpr *>(stmt)->m_expr.get(), frame);
+        } break;
+        case StmtType::If: {
+            auto if_ = dynamic_cast<StmtIf *>(stmt);
+            resolve_expr(if_->m_expr.get(), frame);
+            resolve_stmt(if_->m_block.get(), frame);
+            if (if_->m_else.has_value())
+                resolve_stmt(if_->m_else.value().get(), frame);
+        } break;
+        case StmtType::Return: {
+            auto ret = dynamic_cast<StmtReturn *>(stmt);
+            if (ret->m_expr.has_value())
+                resolve_expr(ret->m_expr.value().get(), frame);
+        } break;
+        case StmtType::While: {
+            auto while_ = dynamic_cast<StmtWhile *>(stmt);
+            resolve_expr(while_->m_expr.get(), frame);
+            resolve_stmt(while_->m_block.get(), frame);
+        } break;
+        case StmtType::Loop: {
+            resolve_stmt(dynamic_cast<StmtLoop *>(stmt)->m_block.get(), frame);
+        } break;
+        case StmtType::For: {
+            auto for_ = dynamic_cast<StmtFor *>(stmt);
+            resolve_expr(for_->m_start.get(), frame);
+            resolve_expr(for_->m_end.get(), frame);
+            if (frame) {
+                frame->push();
+                for_->m_slot = frame->declare(for_->m_enumerator->lexeme());
+            }
+            resolve_stmt(for_->m_block.get(), frame);
+            if (frame) frame->pop();
+        } break;
+        case StmtType::Foreach: {
+            auto foreach = dynamic_cast<StmtForeach *>(stmt);
+            resolve_expr(foreach->m_expr.get(), frame);
+            if (frame) {
+                frame->push();
+                foreach->m_slot = frame->declare(foreach->m_enumerator->lexeme());
+            }
+            resolve_stmt(foreach->m_block.get(), frame);
+            if (frame) frame->pop();
+        } break;
+        case StmtType::Class: {
+            for (auto &method : dynamic_cast<StmtClass *>(stmt)->m_methods)
+                resolve_def(method.get());
+        } break;
+        case StmtType::Match: {
+            resolve_match(dynamic_cast<StmtMatch *>(stmt), frame);
+        } break;
+        default: break;
+        }
+    }
+
+};
+
+void
+Resolver::resolve_program(Program *program) {
+    for (auto &stmt : program->m_stmts)
+        resolve_stmt(stmt.get(), nullptr);
+}
@@ -0,0 +1,195 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstdint>
+#include <cstring>
+
+#include "str-search.hpp"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define STR_SEARCH_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+
+#ifdef STR_SEARCH_X86
+    // Every kernel below looks at the candidate positions [i, i+W) of a
+    // block at a time. A candidate is kept if both the first and last
+    // char of the needle match there, and is then checked with memcmp.
+    // The loops only run while both loads (at `i` and `i+k-1`) stay in
+    // bounds, the rest is left to the scalar fallback by the caller.
+
+    inline bool
+    matches(const char *at, const char *needle, size_t k) {
+        return k <= 2 || std::memcmp(at+1, needle+1, k-2) == 0;
+    }
+
+    size_t
+    find_sse2(const char *s, size_t n, const char *needle, size_t k, size_t &i) {
+        const __m128i first = _mm_set1_epi8(needle[0]);
+        const __m128i last = _mm_set1_epi8(needle[k-1]);
+        for (; i+16+k-1 <= n; i += 16) {
+            __m128i bf = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s+i));
+            __m128i bl = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s+i+k-1));
+            uint32_t mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, bf),
+                                                            _mm_cmpeq_epi8(last, bl)));
+            while (mask != 0) {
+                size_t at = i+__builtin_ctz(mask);
+                if (matches(s+at, needle, k))
+                    return at;
+                mask &= mask-1;
+            }
+        }
+        return StrSearch::npos;
+    }
+
+    __attribute__((target("avx2"))) size_t
+    find_avx2(const char *s, size_t n, const char *needle, size_t k, size_t &i) {
+        const __m256i first = _mm256_set1_epi8(needle[0]);
+        const __m256i last = _mm256_set1_epi8(needle[k-1]);
+        for (; i+32+k-1 <= n; i += 32) {
+            __m256i bf = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s+i));
+            __m256i bl = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s+i+k-1));
+            uint32_t mask = _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(first, bf),
+                                                                  _mm256_cmpeq_epi8(last, bl)));
+            while (mask != 0) {
+                size_t at = i+__builtin_ctz(mask);
+                if (matches(s+at, needle, k))
+                    return at;
+                mask &= mask-1;
+            }
+        }
+        return StrSearch::npos;
+    }
+
+    // The reverse kernels walk `end` (one past the last candidate
+    // still to look at) down to the start of the haystack.
+
+    size_t
+    rfind_sse2(const char *s, const char *needle, size_t k, size_t &end) {
+        const __m128i first = _mm_set1_epi8(needle[0]);
+        const __m128i last = _mm_set1_epi8(needle[k-1]);
+        for (; end >= 16; end -= 16) {
+            size_t i = end-16;
+            __m128i bf = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s+i));
+            __m128i bl = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s+i+k-1));
+            uint32_t mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, bf),
+                                                            _mm_cmpeq_epi8(last, bl)));
+            while (mask != 0) {
+                size_t bit = 31-__builtin_clz(mask);
+                if (matches(s+i+bit, needle, k))
+                    return i+bit;
+                mask &= ~(1u << bit);
+            }
+        }
+        return StrSearch::npos;
+    }
+
+    __attribute__((target("avx2"))) size_t
+    rfind_avx2(const char *s, const char *needle, size_t k, size_t &end) {
+        const __m256i first = _mm256_set1_epi8(needle[0]);
+        const __m256i last = _mm256_set1_epi8(needle[k-1]);
+        for (; end >= 32; end -= 32) {
+            size_t i = end-32;
+            __m256i bf = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s+i));
+            __m256i bl = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s+i+k-1));
+            uint32_t mask = _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(first, bf),
+                                                                  _mm256_cmpeq_epi8(last, bl)));
+            while (mask != 0) {
+                size_t bit = 31-__builtin_clz(mask);
+                if (matches(s+i+bit, needle, k))
+                    return i+bit;
+                mask &= ~(1u << bit);
+            }
+        }
+        return StrSearch::npos;
+    }
+
+    bool
+    have_avx2(void) {
+        static const bool avx2 = __builtin_cpu_supports("avx2");
+        return avx2;
+    }
+#endif
+
+};
+
+size_t
+StrSearch::find(std::string_view hay, std::string_view needle, size_t from) {
+    const size_t n = hay.size(), k = needle.size();
+    if (k == 0)
+        return from <= n ? from : npos;
+    if (from >= n || k > n-from)
+        return npos;
+    if (k == 1) {
+        // memchr is already vectorized by the C library.
+        const void *at = std::memchr(hay.data()+from, needle[0], n-from);
+        return at ? static_cast<const char *>(at)-hay.data() : npos;
+    }
+
+#ifdef STR_SEARCH_X86
+    size_t i = from;
+    size_t at = have_avx2()
+        ? find_avx2(hay.data(), n, needle.data(), k, i)
+        : find_sse2(hay.data(), n, needle.data(), k, i);
+    if (at != npos)
+        return at;
+    from = i;
+#endif
+
+    return hay.find(needle, from);
+}
+
+size_t
+StrSearch::rfind(std::string_view hay, std::string_view needle) {
+    const size_t n = hay.size(), k = needle.size();
+    if (k > n)
+        return npos;
+    if (k == 0)
+        return n;
+
+#ifdef STR_SEARCH_X86
+    size_t end = n-k+1;
+    size_t at = have_avx2()
+        ? rfind_avx2(hay.data(), needle.data(), k, end)
+        : rfind_sse2(hay.data(), needle.data(), k, end);
+    if (at != npos)
+        return at;
+    // Only the candidates before `end` are left.
+    hay = hay.substr(0, end+k-1);
+#endif
+
+    return hay.rfind(needle);
+}
+
+size_t
+StrSearch::count(std::string_view hay, std::string_view needle) {
+    if (needle.empty())
+        return 0;
+    size_t result = 0;
+    for (size_t at = find(hay, needle); at != npos; at = find(hay, needle, at+needle.size()))
+        ++result;
+    return result;
+}
@@ -0,0 +1,81 @@
+# Checks the .earlc token cache against a scratch cache directory:
+# a hit on an unchanged file, a miss after the source is edited and
+# a stale entry (corrupt or truncated) falling back to the lexer,
+# nothing written without --cache and the directory being pruned.
+#
+#   cmake -DEARL=<earl> -DWORK=<scratch dir> -P check-earlc.cmake
+
+file(REMOVE_RECURSE ${WORK})
+file(MAKE_DIRECTORY ${WORK})
+set(ENV{XDG_CACHE_HOME} ${WORK}/cache)
+set(ENTRIES ${WORK}/cache/earl/*.earlc)
+
+function(expect_run WANT)
+    execute_process(
+        COMMAND ${EARL} ${ARGN} --show-cache main.earl
+        WORKING_DIRECTORY ${WORK}
+        OUTPUT_VARIABLE ACTUAL
+        RESULT_VARIABLE STATUS
+    )
+    if(NOT STATUS EQUAL 0)
+        message(FATAL_ERROR "earlc: earl exited with ${STATUS}")
+    endif()
+    if(NOT ACTUAL STREQUAL WANT)
+        message(FATAL_ERROR "earlc: unexpected output\n--- expected\n${WANT}--- actual\n${ACTUAL}")
+    endif()
+endfunction()
+
+function(expect_entries N)
+    file(GLOB FOUND ${ENTRIES})
+    list(LENGTH FOUND HAVE)
+    if(NOT HAVE EQUAL N)
+        message(FATAL_ERROR "earlc: expected ${N} cache entries, found ${HAVE}")
+    endif()
+endfunction()
+
+# The cache is opt-in.
+file(WRITE ${WORK}/main.earl "module Main\nprintln(\"one\");\n")
+expect_run("one\n")
+expect_entries(0)
+
+# Miss, then hit on the unchanged file.
+expect_run("[EARL show-cache] miss main.earl\none\n" --cache)
+expect_entries(1)
+expect_run("[EARL show-cache] hit main.earl\none\n" --cache)
+expect_entries(1)
+
+# Editing the source changes the key.
+file(WRITE ${WORK}/main.earl "module Main\nprintln(\"two\");\n")
+expect_run("[EARL show-cache] miss main.earl\ntwo\n" --cache)
+expect_entries(2)
+
+# A corrupt entry is relexed and rewritten.
+file(GLOB FOUND ${ENTRIES})
+foreach(ENTRY ${FOUND})
+    file(WRITE ${ENTRY} "not a cache entry")
+endforeach()
+expect_run("[EARL show-cache] stale main.earl\ntwo\n" --cache)
+expect_run("[EARL show-cache] hit main.earl\ntwo\n" --cache)
+
+# So is one cut off after its magic.
+string(ASCII 1 SOH)
+file(GLOB FOUND ${ENTRIES})
+foreach(ENTRY ${FOUND})
+    file(WRITE ${ENTRY} "EARLC${SOH}abc")
+endforeach()
+expect_run("[EARL show-cache] stale main.earl\ntwo\n" --cache)
+expect_run("[EARL show-cache] hit main.earl\ntwo\n" --cache)
+
+# Writing an entry trims the directory back to its 256 most recently
+# used, dropping the oldest first.
+foreach(I RANGE 299)
+    file(WRITE ${WORK}/cache/earl/old${I}.earlc "")
+endforeach()
+execute_process(COMMAND touch -t 200001010000 ${WORK}/cache/earl/old0.earlc)
+file(WRITE ${WORK}/main.earl "module Main\nprintln(\"three\");\n")
+expect_run("[EARL show-cache] miss main.earl\nthree\n" --cache)
+expect_entries(256)
+if(EXISTS ${WORK}/cache/earl/old0.earlc)
+    message(FATAL_ERROR "earlc: the least recently used entry was not pruned")
+endif()
+expect_run("[EARL show-cache] hit main.earl\nthree\n" --cache)
@@ -0,0 +1,32 @@
+# Runs `EARL FLAGS FILE` from this directory and compares its stdout
+# and stderr against EXPECTED, and its exit status against STATUS
+# (0 by default). The test directory is printed as `<dir>` so the
+# expected files do not depend on where the repository lives.
+#
+#   cmake -DEARL=<earl> -DFILE=<file> -DEXPECTED=<file> [-DFLAGS=<flags>] [-DSTATUS=<n>] -P check-output.cmake
+
+get_filename_component(TEST_DIR ${CMAKE_CURRENT_LIST_FILE} DIRECTORY)
+file(REAL_PATH ${TEST_DIR} TEST_DIR)
+separate_arguments(FLAGS)
+if(NOT DEFINED STATUS)
+    set(STATUS 0)
+endif()
+
+execute_process(
+    COMMAND ${EARL} ${FLAGS} ${FILE}
+    WORKING_DIRECTORY ${TEST_DIR}
+    OUTPUT_VARIABLE ACTUAL
+    ERROR_VARIABLE ACTUAL
+    RESULT_VARIABLE RESULT
+)
+
+if(NOT RESULT EQUAL STATUS)
+    message(FATAL_ERROR "${FILE}: earl exited with ${RESULT}, expected ${STATUS}")
+endif()
+
+string(REPLACE "${TEST_DIR}" "<dir>" ACTUAL "${ACTUAL}")
+file(READ ${TEST_DIR}/${EXPECTED} WANT)
+
+if(NOT ACTUAL STREQUAL WANT)
+    message(FATAL_ERROR "${FILE}: output differs from ${EXPECTED}\n--- expected\n${WANT}--- actual\n${ACTUAL}")
+endif()
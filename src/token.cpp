@@ -25,6 +25,8 @@
 #include <iostream>
 #include <algorithm>
 #include <string>
+#include <deque>
+#include <unordered_map>
 
 #include <stdio.h>
 #include <assert.h>
@@ -166,17 +168,32 @@ tokentype_to_str(TokenType type) {
     return nullptr;
 }
 
-Token::Token(std::string lexeme, TokenType type, size_t row, size_t col, std::string fp)
-    : m_lexeme(std::move(lexeme)), m_type(type), m_row(row), m_col(col), m_fp(fp) {}
+// Deques never move their elements, so the references handed
+// out by `filetable_get` stay valid as more files are interned.
+static std::deque<std::string> filetable = {};
+static std::unordered_map<std::string, uint32_t> filetable_idxs = {};
 
-Token::Token(char *start, size_t len, TokenType type, size_t row, size_t col, std::string &fp)
-    : m_type(type), m_row(row), m_col(col), m_fp(std::move(fp)), m_next(nullptr) {
-    std::for_each(start, start+len, [&](char c) {this->m_lexeme.push_back(c);});
+uint32_t
+filetable_intern(const std::string &fp) {
+    auto it = filetable_idxs.find(fp);
+    if (it != filetable_idxs.end())
+        return it->second;
+    uint32_t idx = static_cast<uint32_t>(filetable.size());
+    filetable.push_back(fp);
+    filetable_idxs.emplace(fp, idx);
+    return idx;
 }
 
-std::shared_ptr<Token>
-token_alloc(Lexer &lexer, char *start, size_t len, TokenType type, size_t row, size_t col, std::string fp) {
-    (void)lexer;
+const std::string &
+filetable_get(uint32_t idx) {
+    return filetable.at(idx);
+}
+
+Token::Token(std::string lexeme, TokenType type, size_t row, size_t col, uint32_t file)
+    : m_lexeme(std::move(lexeme)), m_type(type), m_row(row), m_col(col), m_file(file) {}
+
+Token
+token_alloc(Lexer &lexer, char *start, size_t len, TokenType type, size_t row, size_t col, uint32_t file) {
     if (type == TokenType::Strlit) {
         std::string s = "";
         for (size_t i = 0; i < len; ++i) {
@@ -201,18 +218,21 @@ token_alloc(Lexer &lexer, char *start, size_t len, TokenType type, size_t row, s
                 ++i;
             }
             else if (*(start+i) == '\\' && *(start+i+1)) {
-                auto err = std::make_shared<Token>(start, len, type, row, col, fp);
+                // Tokens are only reachable through their lexer, so the
+                // offending literal is appended before reporting it.
+                lexer.append(std::string(start, len), type, row, col, file);
+                lexer.append("", TokenType::Eof, row, col, file);
                 const std::string msg = "unknown escape sequence: `\\" + std::string(1, *(start+i+1));
-                Err::err_wtok(err.get());
+                Err::err_wtok(&lexer.m_toks[lexer.m_toks.size()-2]);
                 throw ParserException(msg);
             }
             else {
                 s += *(start+i);
             }
         }
-        return std::make_shared<Token>(s, type, row, col, fp);
+        return Token(std::move(s), type, row, col, file);
     }
-    return std::make_shared<Token>(start, len, type, row, col, fp);
+    return Token(std::string(start ? start : "", len), type, row, col, file);
 }
 
 std::string &
@@ -225,6 +245,20 @@ Token::type(void) const {
     return m_type;
 }
 
+const std::string &
+Token::fp(void) const {
+    return filetable_get(m_file);
+}
+
+Token *
+Token::next(void) {
+    // The lexer stores its tokens contiguously and always ends
+    // them with `Eof`.
+    if (m_type == TokenType::Eof)
+        return nullptr;
+    return this+1;
+}
+
 void
 token_dump_until_eol(Token *tok, int padding) {
     for (int i = 0; i < padding; ++i)
@@ -232,11 +266,11 @@ token_dump_until_eol(Token *tok, int padding) {
     while (tok && tok->type() != TokenType::Semicolon) {
         std::cout << tok->lexeme();
 
-        if (tok->m_next && tok->m_next->type() != TokenType::Semicolon) {
+        if (tok->next() && tok->next()->type() != TokenType::Semicolon) {
             std::cout << ' ';
         }
 
-        tok = tok->m_next.get();
+        tok = tok->next();
     }
 
     std::cout << std::endl;
@@ -66,6 +66,10 @@ std::string earl::value::type_to_str(earl::value::Type ty) {
     case earl::value::Type::DictStr: return "DictStr";
     case earl::value::Type::DictChar: return "DictChar";
     case earl::value::Type::DictFloat: return "DictFloat";
+    case earl::value::Type::DictTuple: return "DictTuple";
+    case earl::value::Type::Set: return "set";
+    case earl::value::Type::Deque: return "deque";
+    case earl::value::Type::Heap: return "heap";
     default: ERR_WARGS(Err::Type::Fatal, "unknown type of id (%d) in processing", (int)ty);
     }
 }
@@ -95,6 +99,57 @@ bool earl::value::type_is_compatable(const earl::value::Obj *const obj1, const e
     return false;
 }
 
+bool earl::value::order(earl::value::Obj *a, earl::value::Obj *b, int &out) {
+    using namespace earl::value;
+
+    Type ta = a->type(), tb = b->type();
+
+    if ((ta == Type::Int || ta == Type::Float) && (tb == Type::Int || tb == Type::Float)) {
+        if (ta == Type::Int && tb == Type::Int) {
+            int x = dynamic_cast<Int *>(a)->value(), y = dynamic_cast<Int *>(b)->value();
+            out = (x > y) - (x < y);
+            return true;
+        }
+        double x = ta == Type::Int ? dynamic_cast<Int *>(a)->value() : dynamic_cast<Float *>(a)->value();
+        double y = tb == Type::Int ? dynamic_cast<Int *>(b)->value() : dynamic_cast<Float *>(b)->value();
+        out = (x > y) - (x < y);
+        return true;
+    }
+
+    if (ta != tb)
+        return false;
+
+    switch (ta) {
+    case Type::Char: {
+        char x = dynamic_cast<Char *>(a)->value(), y = dynamic_cast<Char *>(b)->value();
+        out = (x > y) - (x < y);
+        return true;
+    }
+    case Type::Bool: {
+        bool x = dynamic_cast<Bool *>(a)->value(), y = dynamic_cast<Bool *>(b)->value();
+        out = (x > y) - (x < y);
+        return true;
+    }
+    case Type::Str: {
+        out = dynamic_cast<Str *>(a)->view().compare(dynamic_cast<Str *>(b)->view());
+        return true;
+    }
+    case Type::Tuple: {
+        auto xs = dynamic_cast<Tuple *>(a);
+        auto ys = dynamic_cast<Tuple *>(b);
+        for (size_t i = 0; i < xs->size() && i < ys->size(); ++i) {
+            if (!order(xs->at(i).get(), ys->at(i).get(), out))
+                return false;
+            if (out != 0)
+                return true;
+        }
+        out = (xs->size() > ys->size()) - (xs->size() < ys->size());
+        return true;
+    }
+    default: return false;
+    }
+}
+
 bool earl::value::type_is_compatable(earl::value::Type ty1, earl::value::Type ty2) {
     if (ty1 == ty2)
         return true;
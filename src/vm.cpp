@@ -0,0 +1,298 @@
+/** @file */
+
+// MIT License
+
+// Copyright (c) 2023 malloc-nbytes
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cassert>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "vm.hpp"
+#include "interpreter.hpp"
+#include "intrinsics.hpp"
+#include "common.hpp"
+#include "err.hpp"
+
+using namespace VM;
+
+static std::shared_ptr<earl::value::Obj>
+run(Chunk &chunk,
+    earl::function::Obj *func,
+    std::vector<std::shared_ptr<earl::value::Obj>> &params,
+    std::shared_ptr<Ctx> &world);
+
+static bool
+is_scalar(earl::value::Obj *value) {
+    switch (value->type()) {
+    case earl::value::Type::Int:
+    case earl::value::Type::Float:
+    case earl::value::Type::Bool:
+    case earl::value::Type::Char:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Gets the function a `Call` refers to, looking it up
+// again if the one it was compiled against is gone.
+static std::shared_ptr<earl::function::Obj>
+resolve(Callee &callee, int nparams, std::shared_ptr<Ctx> &world, Expr *expr) {
+    std::shared_ptr<earl::function::Obj> func = callee.func.lock();
+    if (func)
+        return func;
+
+    if (!world->function_exists(callee.id)) {
+        Err::err_wexpr(expr);
+        std::string msg = "function `" + callee.id + "` has not been defined\n";
+        throw InterpreterException(msg);
+    }
+    func = world->function_get(callee.id);
+    if (func->params_len() != static_cast<size_t>(nparams)) {
+        Err::err_wexpr(expr);
+        const std::string msg = "function `"+func->id()+"` expects "+std::to_string(func->params_len())+" arguments but got "+std::to_string(nparams);
+        throw InterpreterException(msg);
+    }
+    callee.func = func;
+    return func;
+}
+
+static std::shared_ptr<earl::value::Obj>
+call_function(earl::function::Obj *callee,
+              earl::function::Obj *caller,
+              std::vector<std::shared_ptr<earl::value::Obj>> &params,
+              std::shared_ptr<Ctx> &world) {
+    if ((flags & __SHOWFUNS) != 0)
+        std::cout << "[EARL show-fun] " << callee->id() << '\n';
+
+    Interpreter::ConstArgs consts(params);
+
+    std::shared_ptr<earl::value::Obj> res = nullptr;
+    Chunk *chunk = callee->chunk(dynamic_cast<WorldCtx *>(world.get()));
+
+    if (chunk && chunk->world == world.get())
+        res = run(*chunk, callee, params, world);
+    else {
+        auto fctx = FunctionCtx::acquire(world, callee->attrs());
+        fctx->set_curfunc(callee->id());
+        callee->load_parameters(params, fctx);
+        if (callee->id() == caller->id())
+            fctx->setrec();
+        std::shared_ptr<Ctx> mask = fctx;
+        res = Interpreter::eval_body(callee->block(), mask);
+        mask = nullptr;
+        FunctionCtx::release(fctx);
+    }
+
+    consts.restore(params);
+
+    if (res->type() == earl::value::Type::Return)
+        res = std::make_shared<earl::value::Void>();
+    return res;
+}
+
+static std::shared_ptr<earl::value::Obj>
+run(Chunk &chunk,
+    earl::function::Obj *func,
+    std::vector<std::shared_ptr<earl::value::Obj>> &params,
+    std::shared_ptr<Ctx> &world) {
+    std::vector<std::shared_ptr<earl::value::Obj>> R(chunk.nregs);
+
+    auto &fparams = func->params();
+    for (size_t i = 0; i < params.size(); ++i) {
+        if ((fparams[i].second & static_cast<uint32_t>(Attr::Ref)) != 0)
+            R[i] = params[i];
+        else
+            R[i] = params[i]->copy();
+        if ((fparams[i].second & static_cast<uint32_t>(Attr::Const)) != 0)
+            R[i]->set_const();
+    }
+
+    const Instr *code = chunk.code.data();
+    size_t pc = 0;
+
+    while (true) {
+        const Instr &I = code[pc++];
+        switch (I.op) {
+        case Op::LoadK: {
+            R[I.a] = chunk.consts[I.b]->copy();
+        } break;
+        case Op::LoadKRef: {
+            R[I.a] = chunk.consts[I.b];
+        } break;
+        case Op::Move: {
+            R[I.a] = R[I.b];
+        } break;
+        case Op::Copy: {
+            R[I.a] = R[I.b]->copy();
+        } break;
+        case Op::BinOp: {
+            Token *op = static_cast<Token *>(I.p);
+            auto &lhs = R[I.b], &rhs = R[I.c];
+            // Scalar results are written into the destination
+            // register in place when nothing else can observe it.
+            earl::value::Scalar x = earl::value::Scalar::unbox(lhs.get()), y, res;
+            if (x.tag != earl::value::Scalar::Tag::None) {
+                y = earl::value::Scalar::unbox(rhs.get());
+                if (y.tag != earl::value::Scalar::Tag::None
+                    && earl::value::scalar_binop(op->type(), x, y, res)) {
+                    res.store(R[I.a]);
+                    break;
+                }
+            }
+            if (I.d && !is_scalar(rhs.get())) {
+                auto cpy = rhs->copy();
+                R[I.a] = lhs->binop(op, cpy);
+            }
+            else
+                R[I.a] = lhs->binop(op, rhs);
+        } break;
+        case Op::UnaryOp: {
+            Token *op = static_cast<Token *>(I.p);
+            earl::value::Scalar x = earl::value::Scalar::unbox(R[I.b].get()), res;
+            if (x.tag != earl::value::Scalar::Tag::None
+                && earl::value::scalar_unaryop(op->type(), x, res)) {
+                res.store(R[I.a]);
+                break;
+            }
+            if (I.d && !is_scalar(R[I.b].get()))
+                R[I.a] = R[I.b]->copy()->unaryop(op);
+            else
+                R[I.a] = R[I.b]->unaryop(op);
+        } break;
+        case Op::Mutate: {
+            R[I.a]->mutate(R[I.b], static_cast<StmtMut *>(I.p));
+        } break;
+        case Op::SpecMutate: {
+            auto stmt = static_cast<StmtMut *>(I.p);
+            R[I.a]->spec_mutate(stmt->m_equals, R[I.b], stmt);
+        } break;
+        case Op::SetConst: {
+            if (I.c || R[I.a]->type() == earl::value::Type::Tuple)
+                R[I.a]->set_const();
+        } break;
+        case Op::CheckFree: {
+            const std::string &id = chunk.names[I.b];
+            if (world->variable_exists(id)) {
+                std::string msg = "variable `"+id+"` is already declared";
+                auto conflict = world->variable_get(id);
+                Err::err_wconflict(static_cast<Token *>(I.p), conflict->gettok());
+                throw InterpreterException(msg);
+            }
+        } break;
+        case Op::Jmp: {
+            pc = I.a;
+        } break;
+        case Op::JmpFalse: {
+            if (!R[I.a]->boolean())
+                pc = I.b;
+        } break;
+        case Op::JmpTrue: {
+            if (R[I.a]->boolean())
+                pc = I.b;
+        } break;
+        case Op::ForPrep: {
+            if (R[I.a]->type() != earl::value::Type::Int || R[I.b]->type() != earl::value::Type::Int) {
+                Err::err_wtok(static_cast<Token *>(I.p));
+                std::string msg = "the range of a `for` loop must be of type `int`";
+                throw InterpreterException(msg);
+            }
+            int start = static_cast<earl::value::Int *>(R[I.a].get())->value();
+            int end = static_cast<earl::value::Int *>(R[I.b].get())->value();
+            R[I.c] = std::make_shared<earl::value::Int>(start <= end ? 1 : -1);
+        } break;
+        case Op::ForTest: {
+            int start = static_cast<earl::value::Int *>(R[I.a].get())->value();
+            int end = static_cast<earl::value::Int *>(R[I.b].get())->value();
+            int dir = static_cast<earl::value::Int *>(R[I.c].get())->value();
+            if ((dir > 0 && start > end-1) || (dir < 0 && start < end))
+                pc = I.d;
+        } break;
+        case Op::ForStep: {
+            auto start = static_cast<earl::value::Int *>(R[I.a].get());
+            start->fill(start->value() + static_cast<earl::value::Int *>(R[I.c].get())->value());
+        } break;
+        case Op::CallIntrinsic: {
+            std::vector<std::shared_ptr<earl::value::Obj>> args(R.begin()+I.b, R.begin()+I.b+I.c);
+            R[I.a] = Intrinsics::call(chunk.names[I.d], args, world, static_cast<Expr *>(I.p));
+        } break;
+        case Op::Call: {
+            std::shared_ptr<earl::function::Obj> callee = resolve(chunk.callees[I.d], I.c, world, static_cast<Expr *>(I.p));
+            std::vector<std::shared_ptr<earl::value::Obj>> args(R.begin()+I.b, R.begin()+I.b+I.c);
+            R[I.a] = call_function(callee.get(), func, args, world);
+        } break;
+        case Op::ExprStmt: {
+            auto &value = R[I.a];
+            if (!value || value->type() == earl::value::Type::Void)
+                break;
+            Err::err_wexpr(static_cast<Expr *>(I.p));
+            Err::warn("Inplace expression will be evaluated and returned. Either explicitly `return` or assign the unused value to a unit binding: `let _ = <expr>;`");
+            if (value->type() == earl::value::Type::Break && I.b != -1)
+                pc = I.b;
+            else if (value->type() == earl::value::Type::Continue && I.c != -1)
+                pc = I.c;
+            else
+                return value;
+        } break;
+        case Op::Ret: {
+            if (R[I.a]->type() == earl::value::Type::Void)
+                return std::make_shared<earl::value::Return>();
+            return R[I.a];
+        } break;
+        case Op::RetVoid: {
+            return std::make_shared<earl::value::Return>();
+        } break;
+        case Op::End: {
+            return std::make_shared<earl::value::Void>();
+        } break;
+        default:
+            assert(false && "unreachable");
+        }
+    }
+}
+
+std::shared_ptr<earl::value::Obj>
+VM::call(earl::function::Obj *func,
+         std::vector<std::shared_ptr<earl::value::Obj>> &params,
+         std::shared_ptr<Ctx> &ctx) {
+    std::shared_ptr<Ctx> *world = nullptr;
+
+    // Functions are only compiled against the @world scope, so
+    // anything owned by a class is left to the interpreter.
+    if (ctx->type() == CtxType::World)
+        world = &ctx;
+    else if (ctx->type() == CtxType::Function) {
+        auto &owner = dynamic_cast<FunctionCtx *>(ctx.get())->get_owner();
+        if (owner->type() == CtxType::World)
+            world = &owner;
+    }
+
+    if (!world)
+        return nullptr;
+
+    Chunk *chunk = func->chunk(dynamic_cast<WorldCtx *>(world->get()));
+    if (!chunk || chunk->world != world->get())
+        return nullptr;
+
+    return run(*chunk, func, params, *world);
+}
@@ -58,6 +58,11 @@ WorldCtx::add_repl_program(std::unique_ptr<Program> program) {
     m_repl_programs.push_back(std::move(program));
 }
 
+void
+WorldCtx::pop_repl_program(void) {
+    m_repl_programs.pop_back();
+}
+
 size_t
 WorldCtx::stmts_len(void) const {
     if (!m_program) {
@@ -216,10 +221,38 @@ WorldCtx::get_world(void) {
     UNIMPLEMENTED("WorldCtx::get_world");
 }
 
+std::shared_ptr<WorldCtx>
+WorldCtx::without_funs_and_classes(std::shared_ptr<Ctx> module) {
+    auto *world = dynamic_cast<WorldCtx *>(module.get());
+    auto view = std::make_shared<WorldCtx>();
+    view->m_mod = world->m_mod;
+    view->m_filepath = world->m_filepath;
+    view->m_scope = world->m_scope.copy();
+    view->m_enums = world->m_enums;
+    view->m_imports = world->m_imports;
+    view->m_source = std::move(module);
+    return view;
+}
+
+// Every module evaluated by this process, keyed by canonical path.
+static std::unordered_map<std::string, std::shared_ptr<Ctx>> module_cache = {};
+
+std::shared_ptr<Ctx>
+WorldCtx::module_cache_get(const std::string &path) {
+    auto it = module_cache.find(path);
+    if (it == module_cache.end())
+        return nullptr;
+    return it->second;
+}
+
+void
+WorldCtx::module_cache_add(const std::string &path, std::shared_ptr<Ctx> ctx) {
+    module_cache[path] = std::move(ctx);
+}
+
 void
-WorldCtx::strip_funs_and_classes(void) {
-    m_funcs.clear();
-    m_defined_classes.clear();
+WorldCtx::module_cache_clear(void) {
+    module_cache.clear();
 }
 
 std::vector<std::string>
@@ -0,0 +1,42 @@
+#!/bin/python3
+
+import os
+import subprocess
+import sys
+import tempfile
+import time
+
+# Measures how long it takes to build a 10 MB str one char
+# at a time with each of the ways of appending to a str.
+# Usage: ./str-bench.py [path/to/earl]
+
+SIZE = 10 * 1024 * 1024
+
+PROGRAMS = {
+    's += c': 'buf += c;',
+    's += "x"': 'buf += "x";',
+    's = s + "x"': 'buf = buf + "x";',
+}
+
+TEMPLATE = '''let buf = "";
+let c = 'x';
+let i = 0;
+while i < {size} {{
+    {append}
+    i += 1;
+}}
+println(len(buf));
+'''
+
+if __name__ == "__main__":
+    earl = sys.argv[1] if len(sys.argv) > 1 else './build/earl'
+    with tempfile.TemporaryDirectory() as tmp:
+        for name, append in PROGRAMS.items():
+            path = os.path.join(tmp, 'str-bench.earl')
+            with open(path, 'w') as fd:
+                fd.write(TEMPLATE.format(size=SIZE, append=append))
+            start = time.time()
+            out = subprocess.run([earl, path], check=True, capture_output=True, text=True).stdout.strip()
+            elapsed = time.time() - start
+            assert out == str(SIZE), out
+            print(f"{name:<14} {elapsed:8.3f}s  {SIZE / elapsed / (1024 * 1024):6.2f} MB/s")